@@ -363,10 +363,42 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
 {
   if (!IsExpired (id))
     {
-      id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () != 2 && m_events->HasFastRemove ())
+        {
+          // do not leave the cancelled event in the event list
+          Remove (id);
+        }
+      else
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
     }
 }
 
+EventId
+DefaultSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay.GetTimeStep ());
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Reschedule Thread-unsafe invocation!");
+  NS_ASSERT_MSG (id.GetUid () != 2, "DefaultSimulatorImpl::Reschedule(): Destroy event");
+  NS_ASSERT_MSG (!IsExpired (id), "DefaultSimulatorImpl::Reschedule(): Expired event");
+  NS_ASSERT_MSG (delay.IsPositive (), "DefaultSimulatorImpl::Reschedule(): Negative delay");
+
+  Scheduler::Event ev;
+  ev.impl = id.PeekEventImpl ();
+  ev.key.m_ts = id.GetTs ();
+  ev.key.m_context = id.GetContext ();
+  ev.key.m_uid = id.GetUid ();
+  Scheduler::EventKey key;
+  key.m_ts = (uint64_t) (delay + TimeStep (m_currentTs)).GetTimeStep ();
+  key.m_context = id.GetContext ();
+  key.m_uid = m_uid;
+  m_uid++;
+  m_events->Reschedule (ev, key);
+  ev.impl->SetRescheduledUid (key.m_uid);
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
 bool
 DefaultSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -391,6 +423,7 @@ DefaultSimulatorImpl::IsExpired (const EventId &id) const
       id.GetTs () < m_currentTs ||
       (id.GetTs () == m_currentTs &&
        id.GetUid () <= m_currentUid) ||
+      id.PeekEventImpl ()->IsStale (id.GetUid ()) ||
       id.PeekEventImpl ()->IsCancelled ()) 
     {
       return true;
@@ -0,0 +1,319 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-allocator.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator implementation.
+ */
+
+namespace ns3 {
+
+namespace {
+
+/** The difference between the sizes of two consecutive size classes. */
+const std::size_t GRANULARITY = 16;
+/** The number of size classes, the largest one holding 256 bytes. */
+const std::size_t N_SIZE_CLASSES = 16;
+/** The number of blocks of a chunk. */
+const std::size_t BLOCKS_PER_CHUNK = 64;
+/**
+ * The largest number of free blocks a thread keeps per size class; the
+ * blocks beyond it are moved to the shared state by batches of
+ * BLOCKS_PER_CHUNK blocks.
+ */
+const std::size_t MAX_FREE_BLOCKS = 4 * BLOCKS_PER_CHUNK;
+
+/** A block in a free list. */
+struct FreeBlock
+{
+  FreeBlock *next; //!< the next free block
+};
+
+/** A list of free blocks moved between a thread and the shared state. */
+struct Batch
+{
+  FreeBlock *head;   //!< the first block
+  std::size_t size;  //!< the number of blocks
+};
+
+/** A statistic of a thread, only written by the thread but read by the others. */
+typedef std::atomic<uint64_t> Counter;
+
+/**
+ * Add to a counter of the calling thread.
+ *
+ * \param [in,out] counter The counter.
+ * \param [in] value The value to add.
+ */
+inline void
+Add (Counter &counter, uint64_t value)
+{
+  // a plain load and store, since the calling thread is the only writer
+  counter.store (counter.load (std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/** The statistics of a thread. */
+struct ThreadStatistics
+{
+  Counter allocations;   //!< the number of allocated blocks
+  Counter releases;      //!< the number of released blocks
+  Counter unpooled;      //!< the number of allocations too large for the size classes
+  Counter chunks;        //!< the number of chunks allocated from the system
+  Counter reservedBytes; //!< the total size of the chunks
+};
+
+/**
+ * The free lists and the statistics of a thread.
+ *
+ * This structure is trivially constructible and destructible, so that it
+ * remains usable while the static objects are destroyed, when the last
+ * events of a simulation which was not destroyed may be released.
+ */
+struct ThreadPools
+{
+  FreeBlock *free[N_SIZE_CLASSES];   //!< the free lists, per size class
+  std::size_t nFree[N_SIZE_CLASSES]; //!< the lengths of the free lists
+  ThreadStatistics stats;            //!< the statistics of the thread
+  bool registered;                   //!< whether the shared state knows this thread
+  bool retired;                      //!< whether the thread exited
+};
+
+/** The free lists and the statistics of the calling thread. */
+thread_local ThreadPools g_pools;
+
+/** The state shared by all the threads. */
+struct SharedState
+{
+  std::mutex mutex;                          //!< the mutex protecting the state below
+  std::vector<ThreadPools *> threads;        //!< the pools of the running threads
+  std::vector<Batch> free[N_SIZE_CLASSES];   //!< the free blocks given up by the threads, per size class
+  EventAllocator::Statistics retired;        //!< the statistics of the exited threads
+  std::vector<void *> chunks;                //!< all the chunks
+};
+
+/**
+ * \returns The state shared by all the threads, which is never destroyed.
+ */
+SharedState *
+GetSharedState (void)
+{
+  static SharedState *state = new SharedState ();
+  return state;
+}
+
+/**
+ * Add the statistics of a thread to the totals.
+ *
+ * \param [in,out] total The totals.
+ * \param [in] stats The statistics of the thread.
+ */
+void
+Accumulate (EventAllocator::Statistics &total, const ThreadStatistics &stats)
+{
+  total.allocations += stats.allocations.load (std::memory_order_relaxed);
+  total.releases += stats.releases.load (std::memory_order_relaxed);
+  total.unpooled += stats.unpooled.load (std::memory_order_relaxed);
+  total.chunks += stats.chunks.load (std::memory_order_relaxed);
+  total.reservedBytes += stats.reservedBytes.load (std::memory_order_relaxed);
+}
+
+/** Give the free blocks and the statistics of an exiting thread to the shared state. */
+struct ThreadExit
+{
+  ~ThreadExit ()
+  {
+    SharedState *state = GetSharedState ();
+    std::lock_guard<std::mutex> lock (state->mutex);
+    state->threads.erase (std::find (state->threads.begin (), state->threads.end (), &g_pools));
+    for (std::size_t c = 0; c < N_SIZE_CLASSES; c++)
+      {
+        if (g_pools.free[c] != 0)
+          {
+            Batch batch = {g_pools.free[c], g_pools.nFree[c]};
+            state->free[c].push_back (batch);
+            g_pools.free[c] = 0;
+            g_pools.nFree[c] = 0;
+          }
+      }
+    Accumulate (state->retired, g_pools.stats);
+    g_pools.retired = true;
+  }
+};
+
+/** Hands over the pools of the calling thread when it exits. */
+thread_local ThreadExit g_threadExit;
+
+/**
+ * Make the pools of the calling thread known to the shared state, on the
+ * first allocation or release of the thread.
+ */
+void
+Register (void)
+{
+  SharedState *state = GetSharedState ();
+  std::lock_guard<std::mutex> lock (state->mutex);
+  // first use of the thread-local guard, which registers its destructor
+  (void) &g_threadExit;
+  state->threads.push_back (&g_pools);
+  g_pools.registered = true;
+}
+
+/**
+ * Fill the empty free list of a size class of the calling thread, with
+ * free blocks given up by the other threads if any, or with a new chunk.
+ *
+ * \param [in] c The size class.
+ */
+void
+Refill (std::size_t c)
+{
+  SharedState *state = GetSharedState ();
+  std::lock_guard<std::mutex> lock (state->mutex);
+  if (!state->free[c].empty ())
+    {
+      g_pools.free[c] = state->free[c].back ().head;
+      g_pools.nFree[c] = state->free[c].back ().size;
+      state->free[c].pop_back ();
+      return;
+    }
+  std::size_t blockSize = (c + 1) * GRANULARITY;
+  char *chunk = static_cast<char *> (::operator new (BLOCKS_PER_CHUNK * blockSize));
+  state->chunks.push_back (chunk);
+  Add (g_pools.stats.chunks, 1);
+  Add (g_pools.stats.reservedBytes, BLOCKS_PER_CHUNK * blockSize);
+  for (std::size_t i = BLOCKS_PER_CHUNK; i > 0; i--)
+    {
+      FreeBlock *block = reinterpret_cast<FreeBlock *> (chunk + (i - 1) * blockSize);
+      block->next = g_pools.free[c];
+      g_pools.free[c] = block;
+    }
+  g_pools.nFree[c] = BLOCKS_PER_CHUNK;
+}
+
+/**
+ * Move a batch of blocks from the full free list of a size class of the
+ * calling thread to the shared state, so that the blocks released by a
+ * thread which does not allocate them are reused by the other threads.
+ *
+ * \param [in] c The size class.
+ */
+void
+Spill (std::size_t c)
+{
+  Batch batch = {g_pools.free[c], BLOCKS_PER_CHUNK};
+  FreeBlock *last = g_pools.free[c];
+  for (std::size_t i = 1; i < BLOCKS_PER_CHUNK; i++)
+    {
+      last = last->next;
+    }
+  g_pools.free[c] = last->next;
+  g_pools.nFree[c] -= BLOCKS_PER_CHUNK;
+  last->next = 0;
+  SharedState *state = GetSharedState ();
+  std::lock_guard<std::mutex> lock (state->mutex);
+  state->free[c].push_back (batch);
+}
+
+} // unnamed namespace
+
+void *
+EventAllocator::Allocate (std::size_t size)
+{
+  ThreadPools &pools = g_pools;
+  if (!pools.registered && !pools.retired)
+    {
+      Register ();
+    }
+  Add (pools.stats.allocations, 1);
+  std::size_t c = size == 0 ? 0 : (size - 1) / GRANULARITY;
+  if (c >= N_SIZE_CLASSES)
+    {
+      Add (pools.stats.unpooled, 1);
+      return ::operator new (size);
+    }
+  if (pools.free[c] == 0)
+    {
+      Refill (c);
+    }
+  FreeBlock *block = pools.free[c];
+  pools.free[c] = block->next;
+  pools.nFree[c]--;
+  return block;
+}
+
+void
+EventAllocator::Release (void *block, std::size_t size)
+{
+  if (block == 0)
+    {
+      return;
+    }
+  ThreadPools &pools = g_pools;
+  if (!pools.registered && !pools.retired)
+    {
+      Register ();
+    }
+  Add (pools.stats.releases, 1);
+  std::size_t c = size == 0 ? 0 : (size - 1) / GRANULARITY;
+  if (c >= N_SIZE_CLASSES)
+    {
+      ::operator delete (block);
+      return;
+    }
+  FreeBlock *freeBlock = static_cast<FreeBlock *> (block);
+  freeBlock->next = pools.free[c];
+  pools.free[c] = freeBlock;
+  if (++pools.nFree[c] > MAX_FREE_BLOCKS && !pools.retired)
+    {
+      Spill (c);
+    }
+}
+
+EventAllocator::Statistics
+EventAllocator::GetStatistics (void)
+{
+  SharedState *state = GetSharedState ();
+  std::lock_guard<std::mutex> lock (state->mutex);
+  Statistics total = state->retired;
+  for (std::vector<ThreadPools *>::const_iterator i = state->threads.begin (); i != state->threads.end (); i++)
+    {
+      Accumulate (total, (*i)->stats);
+    }
+  return total;
+}
+
+void
+EventAllocator::PrintStatistics (std::ostream &os)
+{
+  Statistics stats = GetStatistics ();
+  os << "Event allocator: "
+     << stats.allocations << " allocations, "
+     << stats.releases << " releases, "
+     << stats.allocations - stats.releases << " live events, "
+     << stats.unpooled << " unpooled allocations, "
+     << stats.chunks << " chunks (" << stats.reservedBytes << " bytes)"
+     << std::endl;
+}
+
+} // namespace ns3
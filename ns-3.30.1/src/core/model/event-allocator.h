@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_ALLOCATOR_H
+#define EVENT_ALLOCATOR_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <ostream>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief The memory allocator of the simulation events.
+ *
+ * Every EventImpl, including the events created by the MakeEvent functions
+ * together with their bound arguments, which they store by value, is
+ * allocated by this class.  The blocks are grouped in size classes,
+ * multiple of 16 bytes, and carved from chunks holding many blocks of the
+ * same size class.  A released block is kept in the free list of its size
+ * class and reused by the next allocation of the same size class, so that
+ * the steady state of a simulation, in which every executed event
+ * schedules a few new ones, allocates no memory at all.  The blocks larger
+ * than the largest size class are allocated with the global operator new.
+ *
+ * The free lists are per thread, so that the events can be allocated and
+ * released without locking by the threads of the multithreaded simulator
+ * implementations and by the threads scheduling events in the
+ * RealtimeSimulatorImpl.  A block may be released by another thread than
+ * the one which allocated it, in which case it moves to the free lists of
+ * the releasing thread.  A thread keeps a bounded number of free blocks
+ * per size class and gives the others, as well as all its free blocks when
+ * it exits, to a shared pool from which the threads with empty free lists
+ * refill before allocating new chunks.  The chunks are never returned to
+ * the system.
+ */
+class EventAllocator
+{
+public:
+  /** The allocation statistics, aggregated over all the threads. */
+  struct Statistics
+  {
+    uint64_t allocations;   //!< the number of allocated blocks
+    uint64_t releases;      //!< the number of released blocks
+    uint64_t unpooled;      //!< the number of allocations too large for the size classes
+    uint64_t chunks;        //!< the number of chunks allocated from the system
+    uint64_t reservedBytes; //!< the total size of the chunks
+  };
+
+  /**
+   * Allocate a block of memory for an event.
+   *
+   * \param [in] size The size of the block.
+   * \returns The block.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release a block allocated by Allocate.
+   *
+   * \param [in] block The block.
+   * \param [in] size The size given to Allocate.
+   */
+  static void Release (void *block, std::size_t size);
+  /**
+   * \returns The statistics since the start of the program.
+   */
+  static Statistics GetStatistics (void);
+  /**
+   * Print the statistics since the start of the program.
+   *
+   * \param [in] os The output stream.
+   */
+  static void PrintStatistics (std::ostream &os);
+};
+
+} // namespace ns3
+
+#endif /* EVENT_ALLOCATOR_H */
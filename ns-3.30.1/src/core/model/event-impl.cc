@@ -19,6 +19,7 @@
  */
 
 #include "event-impl.h"
+#include "event-allocator.h"
 #include "log.h"
 
 /**
@@ -37,11 +38,25 @@ EventImpl::~EventImpl ()
 }
 
 EventImpl::EventImpl ()
-  : m_cancel (false)
+  : m_cancel (false),
+    m_schedulerHandle (0),
+    m_rescheduledUid (0)
 {
   NS_LOG_FUNCTION (this);
 }
 
+void *
+EventImpl::operator new (std::size_t size)
+{
+  return EventAllocator::Allocate (size);
+}
+
+void
+EventImpl::operator delete (void *block, std::size_t size)
+{
+  EventAllocator::Release (block, size);
+}
+
 void
 EventImpl::Invoke (void)
 {
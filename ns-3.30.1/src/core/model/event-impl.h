@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,9 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The events are allocated by the EventAllocator, which recycles the
+ * memory of the released events.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -48,6 +52,20 @@ public:
   EventImpl ();
   /** Destructor. */
   virtual ~EventImpl () = 0;
+  /**
+   * Allocate an event with the EventAllocator.
+   *
+   * \param [in] size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release an event allocated by operator new.
+   *
+   * \param [in] block The memory of the event.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *block, std::size_t size);
   /**
    * Called by the simulation engine to notify the event that it is time
    * to execute.
@@ -65,6 +83,45 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * Store the position of the event in the scheduler holding it.
+   *
+   * Schedulers which move their events, such as the heaps, keep this
+   * handle up to date to find an event in constant time from its EventId.
+   *
+   * \param [in] handle The position of the event.
+   */
+  void SetSchedulerHandle (uint32_t handle)
+  {
+    m_schedulerHandle = handle;
+  }
+  /**
+   * \returns The position of the event stored by SetSchedulerHandle.
+   */
+  uint32_t GetSchedulerHandle (void) const
+  {
+    return m_schedulerHandle;
+  }
+  /**
+   * Store the uid given to the event by its last reschedule.
+   *
+   * An EventId whose uid differs from a non-zero rescheduled uid
+   * refers to an earlier schedule of the event and is expired.
+   *
+   * \param [in] uid The new uid of the event.
+   */
+  void SetRescheduledUid (uint32_t uid)
+  {
+    m_rescheduledUid = uid;
+  }
+  /**
+   * \param [in] uid The uid of an EventId of this event.
+   * \returns true if the event was rescheduled since it was given \p uid.
+   */
+  bool IsStale (uint32_t uid) const
+  {
+    return m_rescheduledUid != 0 && m_rescheduledUid != uid;
+  }
 
 protected:
   /**
@@ -77,6 +134,8 @@ protected:
 
 private:
   bool m_cancel;  /**< Has this event been cancelled. */
+  uint32_t m_schedulerHandle; /**< The position of the event in the scheduler. */
+  uint32_t m_rescheduledUid;  /**< The uid of the last reschedule, or zero. */
 };
 
 } // namespace ns3
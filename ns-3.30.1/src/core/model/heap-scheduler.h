@@ -49,6 +49,9 @@ namespace ns3 {
  *    the index of the root is 1.
  *  - It uses a slightly non-standard while loop for top-down heapify
  *    to move one if statement out of the loop.
+ *  - It stores the index of each event in its EventImpl, so that Remove
+ *    and Reschedule find the event in constant time, and run in
+ *    logarithmic time.
  */
 class HeapScheduler : public Scheduler
 {
@@ -70,6 +73,8 @@ public:
   virtual Scheduler::Event PeekNext (void) const;
   virtual Scheduler::Event RemoveNext (void);
   virtual void Remove (const Scheduler::Event &ev);
+  virtual void Reschedule (const Scheduler::Event &ev, const Scheduler::EventKey &key);
+  virtual bool HasFastRemove (void) const;
 
 private:
   /** Event list type:  vector of Events, managed as a heap. */
@@ -145,14 +150,18 @@ private:
    */
   inline std::size_t Smallest (std::size_t a, std::size_t b) const;
   /**
-   * Swap two items.
+   * Swap two items, and update their indexes in their EventImpl.
    *
    * \param [in] a The first item.
    * \param [in] b The second item.
    */
   inline void Exch (std::size_t a, std::size_t b);
-  /** Percolate a newly inserted Last item to its proper position. */ 
-  void BottomUp (void);
+  /**
+   * Percolate an item up the heap to its proper position.
+   *
+   * \param [in] start Starting entry.
+   */
+  void BottomUp (std::size_t start);
   /**
    * Percolate a deletion bubble down the heap.
    *
@@ -109,4 +109,11 @@ MapScheduler::Remove (const Event &ev)
   m_list.erase (i);
 }
 
+bool
+MapScheduler::HasFastRemove (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return true;
+}
+
 } // namespace ns3
@@ -61,6 +61,7 @@ public:
   virtual Scheduler::Event PeekNext (void) const;
   virtual Scheduler::Event RemoveNext (void);
   virtual void Remove (const Scheduler::Event &ev);
+  virtual bool HasFastRemove (void) const;
 
 private:
   /** Event list type: a Map from EventKey to EventImpl. */
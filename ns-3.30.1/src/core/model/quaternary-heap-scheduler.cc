@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quaternary-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::QuaternaryHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuaternaryHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (QuaternaryHeapScheduler);
+
+/** The number of children of every node of the heap. */
+static const std::size_t ARITY = 4;
+
+TypeId
+QuaternaryHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::QuaternaryHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<QuaternaryHeapScheduler> ()
+  ;
+  return tid;
+}
+
+QuaternaryHeapScheduler::QuaternaryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QuaternaryHeapScheduler::~QuaternaryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+QuaternaryHeapScheduler::SiftUp (std::size_t index, const Event &ev)
+{
+  while (index > 0)
+    {
+      std::size_t parent = (index - 1) / ARITY;
+      if (!(ev.key < m_heap[parent].key))
+        {
+          break;
+        }
+      m_heap[index] = m_heap[parent];
+      m_heap[index].impl->SetSchedulerHandle (index);
+      index = parent;
+    }
+  m_heap[index] = ev;
+  ev.impl->SetSchedulerHandle (index);
+}
+
+void
+QuaternaryHeapScheduler::SiftDown (std::size_t index, const Event &ev)
+{
+  std::size_t size = m_heap.size ();
+  while (true)
+    {
+      std::size_t first = ARITY * index + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      std::size_t last = std::min (first + ARITY, size);
+      std::size_t smallest = first;
+      for (std::size_t child = first + 1; child < last; child++)
+        {
+          if (m_heap[child].key < m_heap[smallest].key)
+            {
+              smallest = child;
+            }
+        }
+      if (!(m_heap[smallest].key < ev.key))
+        {
+          break;
+        }
+      m_heap[index] = m_heap[smallest];
+      m_heap[index].impl->SetSchedulerHandle (index);
+      index = smallest;
+    }
+  m_heap[index] = ev;
+  ev.impl->SetSchedulerHandle (index);
+}
+
+void
+QuaternaryHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  m_heap.push_back (ev);
+  SiftUp (m_heap.size () - 1, ev);
+}
+
+bool
+QuaternaryHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_heap.empty ();
+}
+
+Scheduler::Event
+QuaternaryHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_heap.empty ());
+  return m_heap.front ();
+}
+
+Scheduler::Event
+QuaternaryHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_heap.empty ());
+  Event next = m_heap.front ();
+  Event last = m_heap.back ();
+  m_heap.pop_back ();
+  if (!m_heap.empty ())
+    {
+      SiftDown (0, last);
+    }
+  return next;
+}
+
+void
+QuaternaryHeapScheduler::Move (std::size_t index, const Event &ev)
+{
+  // the event may belong above or below its current position
+  if (index > 0 && ev.key < m_heap[(index - 1) / ARITY].key)
+    {
+      SiftUp (index, ev);
+    }
+  else
+    {
+      SiftDown (index, ev);
+    }
+}
+
+void
+QuaternaryHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  std::size_t i = ev.impl->GetSchedulerHandle ();
+  NS_ASSERT (i < m_heap.size () && m_heap[i].impl == ev.impl);
+  NS_ASSERT (m_heap[i].key.m_uid == ev.key.m_uid);
+  Event last = m_heap.back ();
+  m_heap.pop_back ();
+  if (i < m_heap.size ())
+    {
+      Move (i, last);
+    }
+}
+
+void
+QuaternaryHeapScheduler::Reschedule (const Event &ev, const EventKey &key)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  std::size_t i = ev.impl->GetSchedulerHandle ();
+  NS_ASSERT (i < m_heap.size () && m_heap[i].impl == ev.impl);
+  NS_ASSERT (m_heap[i].key.m_uid == ev.key.m_uid);
+  Event moved = m_heap[i];
+  moved.key = key;
+  Move (i, moved);
+}
+
+bool
+QuaternaryHeapScheduler::HasFastRemove (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUATERNARY_HEAP_SCHEDULER_H
+#define QUATERNARY_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::QuaternaryHeapScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary heap event scheduler
+ *
+ * The events are stored by value in a single vector managed as an implicit
+ * heap in which every node has four children: the children of the node at
+ * index i are at indexes 4i+1 to 4i+4, so that they are adjacent in memory
+ * and compared with a single pass over a few cache lines.  Compared to the
+ * HeapScheduler, the heap is half as deep, which halves the number of
+ * levels visited when removing the next event, the most frequent
+ * operation, at the cost of three comparisons per level instead of two.
+ * Elements are moved into a hole instead of being swapped.
+ *
+ * This scheduler is well suited to workloads with many pending events
+ * whose timestamps are close to each other, such as the backoff slots,
+ * SIFS and timeouts of Wi-Fi simulations.  The index of each event is
+ * stored in its EventImpl, so that removing or rescheduling an arbitrary
+ * event also takes logarithmic time.
+ */
+class QuaternaryHeapScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  QuaternaryHeapScheduler ();
+  /** Destructor. */
+  virtual ~QuaternaryHeapScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+  virtual void Reschedule (const Scheduler::Event &ev, const Scheduler::EventKey &key);
+  virtual bool HasFastRemove (void) const;
+
+private:
+  /**
+   * Move an event from a hole towards the root to its proper position.
+   *
+   * \param [in] index The index of the hole.
+   * \param [in] ev The event to store.
+   */
+  void SiftUp (std::size_t index, const Scheduler::Event &ev);
+  /**
+   * Move an event from a hole towards the leaves to its proper position.
+   *
+   * \param [in] index The index of the hole.
+   * \param [in] ev The event to store.
+   */
+  void SiftDown (std::size_t index, const Scheduler::Event &ev);
+  /**
+   * Move an event from a hole towards the root or the leaves to its
+   * proper position.
+   *
+   * \param [in] index The index of the hole.
+   * \param [in] ev The event to store.
+   */
+  void Move (std::size_t index, const Scheduler::Event &ev);
+
+  /** The event list, managed as a 4-ary heap rooted at index 0. */
+  std::vector<Scheduler::Event> m_heap;
+};
+
+} // namespace ns3
+
+#endif /* QUATERNARY_HEAP_SCHEDULER_H */
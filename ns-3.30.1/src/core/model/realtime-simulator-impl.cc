@@ -753,10 +753,47 @@ RealtimeSimulatorImpl::Cancel (const EventId &id)
 {
   if (IsExpired (id) == false)
     {
-      id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () != 2 && m_events->HasFastRemove ())
+        {
+          // do not leave the cancelled event in the event list
+          Remove (id);
+        }
+      else
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
     }
 }
 
+EventId
+RealtimeSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay);
+  NS_ASSERT_MSG (id.GetUid () != 2, "RealtimeSimulatorImpl::Reschedule(): Destroy event");
+  NS_ASSERT_MSG (delay.IsPositive (), "RealtimeSimulatorImpl::Reschedule(): Negative delay");
+
+  Scheduler::Event ev;
+  Scheduler::EventKey key;
+  {
+    CriticalSection cs (m_mutex);
+    NS_ASSERT_MSG (!IsExpired (id), "RealtimeSimulatorImpl::Reschedule(): Expired event");
+    ev.impl = id.PeekEventImpl ();
+    ev.key.m_ts = id.GetTs ();
+    ev.key.m_context = id.GetContext ();
+    ev.key.m_uid = id.GetUid ();
+    Time tAbsolute = Simulator::Now () + delay;
+    key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+    key.m_context = id.GetContext ();
+    key.m_uid = m_uid;
+    m_uid++;
+    m_events->Reschedule (ev, key);
+    ev.impl->SetRescheduledUid (key.m_uid);
+    m_synchronizer->Signal ();
+  }
+
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
 bool
 RealtimeSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -790,6 +827,7 @@ RealtimeSimulatorImpl::IsExpired (const EventId &id) const
   if (id.PeekEventImpl () == 0 ||
       id.GetTs () < m_currentTs ||
       (id.GetTs () == m_currentTs && id.GetUid () <= m_currentUid) ||
+      id.PeekEventImpl ()->IsStale (id.GetUid ()) ||
       id.PeekEventImpl ()->IsCancelled ()) 
     {
       return true;
@@ -99,6 +99,7 @@ public:
   virtual EventId ScheduleDestroy (EventImpl *event);
   virtual void Remove (const EventId &ev);
   virtual void Cancel (const EventId &ev);
+  virtual EventId Reschedule (const EventId &ev, const Time &delay);
   virtual bool IsExpired (const EventId &ev) const;
   virtual void Run (void);
   virtual Time Now (void) const;
@@ -49,4 +49,21 @@ Scheduler::GetTypeId (void)
   return tid;
 }
 
+void
+Scheduler::Reschedule (const Event &ev, const EventKey &key)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  Remove (ev);
+  Event moved = ev;
+  moved.key = key;
+  Insert (moved);
+}
+
+bool
+Scheduler::HasFastRemove (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return false;
+}
+
 } // namespace ns3
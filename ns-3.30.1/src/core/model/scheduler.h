@@ -135,6 +135,27 @@ public:
    * \param [in] ev The event to remove
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * Change the key of a specific event of the event list.
+   *
+   * The default implementation removes the event and inserts it again
+   * with its new key.
+   *
+   * \param [in] ev The event to move, with its current key
+   * \param [in] key The new key of the event
+   */
+  virtual void Reschedule (const Event &ev, const EventKey &key);
+  /**
+   * Test if Remove and Reschedule are efficient.
+   *
+   * When they are, the simulator implementations remove the cancelled
+   * events from the event list instead of leaving them until their
+   * expiration time.
+   *
+   * \returns \c true if Remove and Reschedule run in logarithmic time
+   *          or better, the default being \c false.
+   */
+  virtual bool HasFastRemove (void) const;
 };
 
 /**
@@ -23,10 +23,12 @@
 #include "scheduler.h"
 #include "map-scheduler.h"
 #include "event-impl.h"
+#include "event-allocator.h"
 #include "des-metrics.h"
 
 #include "ptr.h"
 #include "string.h"
+#include "boolean.h"
 #include "object-factory.h"
 #include "global-value.h"
 #include "assert.h"
@@ -76,6 +78,16 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
                                                   TypeIdValue (MapScheduler::GetTypeId ()),
                                                   MakeTypeIdChecker ());
 
+/**
+ * \ingroup events
+ * Whether to print the statistics of the EventAllocator when the
+ * simulator is destroyed.
+ */
+static GlobalValue g_eventAllocatorStatistics = GlobalValue ("EventAllocatorStatistics",
+                                                             "Print the statistics of the event allocator when the simulator is destroyed",
+                                                             BooleanValue (false),
+                                                             MakeBooleanChecker ());
+
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
@@ -150,6 +162,13 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+
+  BooleanValue printStatistics;
+  g_eventAllocatorStatistics.GetValue (printStatistics);
+  if (printStatistics.Get ())
+    {
+      EventAllocator::PrintStatistics (std::clog);
+    }
 }
 
 void
@@ -296,6 +315,12 @@ Simulator::Cancel (const EventId &id)
   return GetImpl ()->Cancel (id);
 }
 
+EventId
+Simulator::Reschedule (const EventId &id, const Time &delay)
+{
+  return GetImpl ()->Reschedule (id, delay);
+}
+
 bool 
 Simulator::IsExpired (const EventId &id)
 {
@@ -1231,7 +1231,10 @@ public:
    *
    * This method has the same visible effect as the 
    * ns3::Simulator::Remove method but its algorithmic complexity is 
-   * much lower: it has O(1) complexity.
+   * much lower: it has O(1) complexity.  However, when the scheduler
+   * removes events in logarithmic time (see Scheduler::HasFastRemove),
+   * the event is removed from the event list, so that cancelled events
+   * do not accumulate in the event list.
    * This method has the exact same semantics as ns3::EventId::Cancel.
    * Note that it is not possible to cancel events which were scheduled
    * for the "destroy" time. Doing so will result in a program error (crash).
@@ -1240,6 +1243,24 @@ public:
    */
   static void Cancel (const EventId &id);
 
+  /**
+   * Move a pending event to a new expiration time.
+   *
+   * This has the same effect as cancelling the event and scheduling
+   * the same function with the same arguments again, without creating
+   * a new event.  With the schedulers supporting it, the event is moved
+   * in O(log(n)) time.  The event keeps its context, and is ordered
+   * after the events already scheduled for the same time.
+   * The event must not be expired, nor be a "destroy" event.
+   *
+   * @param [in] id The event to move.
+   * @param [in] delay The delay from now after which the event expires.
+   * @return The new EventId of the event, which replaces \p id.
+   *   \p id and its copies are expired from now on: cancelling or
+   *   removing them has no effect on the rescheduled event.
+   */
+  static EventId Reschedule (const EventId &id, const Time &delay);
+
   /**
    * Check if an event has already run or been cancelled.
    *
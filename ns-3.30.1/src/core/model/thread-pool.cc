@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "thread-pool.h"
+#include "log.h"
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::ThreadPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ThreadPool");
+
+ThreadPool::ThreadPool ()
+  : m_nThreads (1),
+    m_generation (0),
+    m_nRunning (0),
+    m_stop (false),
+    m_task (0),
+    m_nItems (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ThreadPool::~ThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+  StopThreads ();
+}
+
+void
+ThreadPool::SetNThreads (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+#ifndef HAVE_PTHREAD_H
+  if (nThreads > 1)
+    {
+      NS_LOG_WARN ("Threads are not supported by this build, using a single thread");
+      nThreads = 1;
+    }
+#endif
+  if (nThreads != m_nThreads)
+    {
+      StopThreads ();
+      m_nThreads = std::max<uint32_t> (nThreads, 1);
+    }
+}
+
+uint32_t
+ThreadPool::GetNThreads (void) const
+{
+  return m_nThreads;
+}
+
+uint32_t
+ThreadPool::GetFirstItem (uint32_t thread, uint32_t nItems) const
+{
+  return static_cast<uint32_t> (static_cast<uint64_t> (nItems) * thread / m_nThreads);
+}
+
+void
+ThreadPool::Run (uint32_t nItems, const Task &task)
+{
+  NS_LOG_FUNCTION (this << nItems);
+  if (m_nThreads < 2 || nItems < 2)
+    {
+      task (0, 0, nItems);
+      return;
+    }
+  if (m_threads.empty ())
+    {
+      StartThreads ();
+    }
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_task = &task;
+    m_nItems = nItems;
+    m_nRunning = m_nThreads - 1;
+    m_generation++;
+  }
+  m_startCondition.notify_all ();
+  task (0, 0, GetFirstItem (1, nItems));
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (m_nRunning > 0)
+    {
+      m_doneCondition.wait (lock);
+    }
+  m_task = 0;
+}
+
+void
+ThreadPool::StartThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = false;
+    generation = m_generation;
+  }
+  // the threads wait for the next task, not for the last one of the threads they replace
+  for (uint32_t thread = 1; thread < m_nThreads; thread++)
+    {
+      m_threads.push_back (std::thread (&ThreadPool::DoRun, this, thread, generation));
+    }
+#endif
+}
+
+void
+ThreadPool::StopThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_threads.empty ())
+    {
+      return;
+    }
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_startCondition.notify_all ();
+  for (std::vector<std::thread>::iterator it = m_threads.begin (); it != m_threads.end (); it++)
+    {
+      it->join ();
+    }
+  m_threads.clear ();
+}
+
+void
+ThreadPool::DoRun (uint32_t thread, uint64_t generation)
+{
+  while (true)
+    {
+      const Task *task;
+      uint32_t nItems;
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        while (!m_stop && m_generation == generation)
+          {
+            m_startCondition.wait (lock);
+          }
+        if (m_stop)
+          {
+            return;
+          }
+        generation = m_generation;
+        task = m_task;
+        nItems = m_nItems;
+      }
+      (*task) (thread, GetFirstItem (thread, nItems), GetFirstItem (thread + 1, nItems));
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        if (--m_nRunning == 0)
+          {
+            m_doneCondition.notify_one ();
+          }
+      }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "callback.h"
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::ThreadPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup thread
+ * @brief A fixed set of threads splitting a range of items between them.
+ *
+ * Run calls the task with disjoint sub-ranges of the items from the
+ * calling thread and from the worker threads, and returns when all the
+ * sub-ranges have been processed.  The sub-range given to each thread only
+ * depends on the number of items and on the number of threads, so that a
+ * task can keep per-thread state indexed by the thread index.
+ *
+ * The worker threads are started by the first Run with more than one
+ * thread and more than one item, and are stopped when the pool is
+ * destroyed or when the number of threads changes.
+ *
+ * The task must not schedule events, create objects or change the
+ * reference count of objects shared with other threads, since none of
+ * these operations is thread-safe.  If threads are not supported by the
+ * build, all the items are processed by the calling thread.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * The task run by each thread: it is called with the index of the thread
+   * (zero for the thread calling Run) and with the first and the past-the-end
+   * indexes of the items to process.
+   */
+  typedef Callback<void, uint32_t, uint32_t, uint32_t> Task;
+
+  ThreadPool ();
+  ~ThreadPool ();
+
+  /**
+   * \param nThreads the number of threads processing the items, including
+   *        the thread calling Run. Values lower than two disable the worker threads.
+   */
+  void SetNThreads (uint32_t nThreads);
+  /**
+   * \return the number of threads processing the items, including the thread calling Run
+   */
+  uint32_t GetNThreads (void) const;
+  /**
+   * Process nItems items with all the threads and return when they are all processed.
+   *
+   * \param nItems the number of items
+   * \param task the task processing a sub-range of the items
+   */
+  void Run (uint32_t nItems, const Task &task);
+
+private:
+  /**
+   * \param thread the index of a thread
+   * \param nItems the number of items
+   * \return the index of the first item processed by the thread
+   */
+  uint32_t GetFirstItem (uint32_t thread, uint32_t nItems) const;
+  /// Start the worker threads
+  void StartThreads (void);
+  /// Stop and join the worker threads
+  void StopThreads (void);
+  /**
+   * The loop of a worker thread
+   *
+   * \param thread the index of the thread
+   * \param generation the generation of the last task run before the thread started
+   */
+  void DoRun (uint32_t thread, uint64_t generation);
+
+  uint32_t m_nThreads;                       //!< the number of threads, including the thread calling Run
+  std::vector<std::thread> m_threads;        //!< the worker threads
+  std::mutex m_mutex;                        //!< the mutex protecting the state below
+  std::condition_variable m_startCondition;  //!< signalled when a task is available or the threads must stop
+  std::condition_variable m_doneCondition;   //!< signalled when the last worker thread is done
+  uint64_t m_generation;                     //!< incremented by each Run using the worker threads
+  uint32_t m_nRunning;                       //!< the number of worker threads still processing the current task
+  bool m_stop;                               //!< whether the worker threads must stop
+  const Task *m_task;                        //!< the current task
+  uint32_t m_nItems;                         //!< the number of items of the current task
+};
+
+} // namespace ns3
+
+#endif /* THREAD_POOL_H */
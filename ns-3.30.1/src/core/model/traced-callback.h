@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <stdint.h>
 #include "callback.h"
 
 /**
@@ -46,6 +46,11 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * The chain is stored in a contiguous array, held within the
+ * TracedCallback itself as long as it has at most two Callbacks, so
+ * that invoking a TracedCallback without any Callback costs a single
+ * comparison.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -64,6 +69,21 @@ class TracedCallback
 public:
   /** Constructor. */
   TracedCallback ();
+  /**
+   * Copy constructor.
+   *
+   * \param [in] o The TracedCallback to copy.
+   */
+  TracedCallback (const TracedCallback &o);
+  /**
+   * Assignment operator.
+   *
+   * \param [in] o The TracedCallback to copy.
+   * \returns This TracedCallback.
+   */
+  TracedCallback & operator = (const TracedCallback &o);
+  /** Destructor. */
+  ~TracedCallback ();
   /**
    * Append a Callback to the chain (without a context).
    *
@@ -93,6 +113,13 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check whether the chain of Callbacks is empty, for example to skip
+   * computing the arguments of a TracedCallback nobody is connected to.
+   *
+   * \returns true if no Callback is connected.
+   */
+  bool IsEmpty (void) const;
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -223,7 +250,7 @@ public:
   
 private:
   /**
-   * Container type for holding the chain of Callbacks.
+   * Type of the Callbacks of the chain.
    *
    * \tparam T1 \deduced Type of the first argument to the functor.
    * \tparam T2 \deduced Type of the second argument to the functor.
@@ -234,9 +261,28 @@ private:
    * \tparam T7 \deduced Type of the seventh argument to the functor.
    * \tparam T8 \deduced Type of the eighth argument to the functor.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> Sink;
+  /**
+   * Append a Callback to the chain, moving the chain to a larger
+   * array if needed.
+   *
+   * The chain is invoked by index, so that a Callback connecting
+   * another one while the chain is invoked does not invalidate the
+   * invocation.
+   *
+   * \param [in] sink The Callback to append.
+   */
+  void Append (const Sink &sink);
+  /** Remove all the Callbacks and release the array of the chain. */
+  void Clear (void);
+
+  /** The number of Callbacks stored within the TracedCallback. */
+  static const uint32_t N_INLINE_SINKS = 2;
+
+  Sink *m_sinks;                        //!< The chain of Callbacks.
+  uint32_t m_nSinks;                    //!< The number of Callbacks of the chain.
+  uint32_t m_capacity;                  //!< The number of Callbacks m_sinks can hold.
+  Sink m_inlineSinks[N_INLINE_SINKS];   //!< The array of short chains.
 };
 
 } // namespace ns3
@@ -253,8 +299,91 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_sinks (m_inlineSinks),
+    m_nSinks (0),
+    m_capacity (N_INLINE_SINKS)
+{
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback (const TracedCallback &o)
+  : m_sinks (m_inlineSinks),
+    m_nSinks (0),
+    m_capacity (N_INLINE_SINKS)
+{
+  for (uint32_t i = 0; i < o.m_nSinks; i++)
+    {
+      Append (o.m_sinks[i]);
+    }
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator = (const TracedCallback &o)
+{
+  if (this != &o)
+    {
+      Clear ();
+      for (uint32_t i = 0; i < o.m_nSinks; i++)
+        {
+          Append (o.m_sinks[i]);
+        }
+    }
+  return *this;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::~TracedCallback ()
 {
+  Clear ();
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Append (const Sink &sink)
+{
+  if (m_nSinks == m_capacity)
+    {
+      Sink *sinks = new Sink[2 * m_capacity];
+      for (uint32_t i = 0; i < m_nSinks; i++)
+        {
+          sinks[i] = m_sinks[i];
+        }
+      if (m_sinks != m_inlineSinks)
+        {
+          delete [] m_sinks;
+        }
+      m_sinks = sinks;
+      m_capacity *= 2;
+    }
+  m_sinks[m_nSinks++] = sink;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Clear (void)
+{
+  if (m_sinks != m_inlineSinks)
+    {
+      delete [] m_sinks;
+    }
+  for (uint32_t i = 0; i < N_INLINE_SINKS; i++)
+    {
+      m_inlineSinks[i] = Sink ();
+    }
+  m_sinks = m_inlineSinks;
+  m_nSinks = 0;
+  m_capacity = N_INLINE_SINKS;
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -266,7 +395,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBa
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  Append (cb);
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -279,7 +408,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  Append (realCb);
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -288,18 +417,23 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      if ((*i).IsEqual (callback))
-        {
-          i = m_callbackList.erase (i);
-        }
-      else
+      if (!m_sinks[i].IsEqual (callback))
         {
-          i++;
+          if (kept != i)
+            {
+              m_sinks[kept] = m_sinks[i];
+            }
+          kept++;
         }
     }
+  for (uint32_t i = kept; i < m_nSinks; i++)
+    {
+      m_sinks[i] = Sink ();
+    }
+  m_nSinks = kept;
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -314,6 +448,15 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_nSinks == 0;
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -321,10 +464,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)();
+      m_sinks[i]();
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +476,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1);
+      m_sinks[i](a1);
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +488,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2);
+      m_sinks[i](a1, a2);
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +500,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2, a3);
+      m_sinks[i](a1, a2, a3);
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +512,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2, a3, a4);
+      m_sinks[i](a1, a2, a3, a4);
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +524,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5);
+      m_sinks[i](a1, a2, a3, a4, a5);
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +536,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      m_sinks[i](a1, a2, a3, a4, a5, a6);
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +548,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      m_sinks[i](a1, a2, a3, a4, a5, a6, a7);
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +560,9 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  for (uint32_t i = 0; i < m_nSinks; i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      m_sinks[i](a1, a2, a3, a4, a5, a6, a7, a8);
     }
 }
 
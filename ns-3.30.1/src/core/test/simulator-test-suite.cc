@@ -23,6 +23,14 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/quaternary-heap-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/event-allocator.h"
+#include "ns3/core-config.h"
+#include <algorithm>
+#ifdef HAVE_PTHREAD_H
+#include <thread>
+#endif
 
 using namespace ns3;
 
@@ -170,6 +178,229 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorOrderTestCase : public TestCase
+{
+public:
+  SimulatorOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (uint32_t index);
+  ObjectFactory m_schedulerFactory;
+  std::vector<int64_t> m_timestamps;    // the timestamp of each event (ns)
+  std::vector<bool> m_cancelled;        // whether each event was cancelled
+  std::vector<EventId> m_ids;           // the id of each event
+  std::vector<EventId> m_stale;         // the ids replaced by a reschedule before the run
+  std::vector<uint32_t> m_sequence;     // the order in which each event was last scheduled
+  uint32_t m_nScheduled;                // the number of events scheduled or rescheduled
+  uint32_t m_lastIndex;                 // the index of the last event run
+  uint32_t m_nRun;                      // the number of events run
+  Ptr<UniformRandomVariable> m_random;  // draws the timestamps and the cancelled events
+};
+
+SimulatorOrderTestCase::SimulatorOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that many events run in order when cancelled or rescheduled with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorOrderTestCase::Event (uint32_t index)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_cancelled[index], false, "Cancelled event " << index << " ran");
+  NS_TEST_EXPECT_MSG_EQ (Now ().GetNanoSeconds (), m_timestamps[index], "Event " << index << " ran at the wrong time");
+  if (m_nRun > 0)
+    {
+      // events with the same timestamp run in the order they were scheduled
+      bool ordered = m_timestamps[m_lastIndex] < m_timestamps[index]
+        || (m_timestamps[m_lastIndex] == m_timestamps[index] && m_sequence[m_lastIndex] < m_sequence[index]);
+      NS_TEST_EXPECT_MSG_EQ (ordered, true, "Event " << index << " ran after event " << m_lastIndex);
+    }
+  m_lastIndex = index;
+  m_nRun++;
+  // schedule more events while running, some of them at the current time
+  if (m_timestamps.size () < 20000)
+    {
+      for (uint32_t i = 0; i < 2; i++)
+        {
+          int64_t delay = m_random->GetInteger (0, 3) == 0 ? 0 : m_random->GetInteger (0, 1000);
+          m_timestamps.push_back (Now ().GetNanoSeconds () + delay);
+          m_cancelled.push_back (false);
+          m_sequence.push_back (m_nScheduled++);
+          m_ids.push_back (Simulator::Schedule (NanoSeconds (delay), &SimulatorOrderTestCase::Event, this,
+                                                m_timestamps.size () - 1));
+        }
+    }
+  // cancel a pending event
+  uint32_t victim = m_random->GetInteger (0, m_ids.size () - 1);
+  if (!m_ids[victim].IsExpired ())
+    {
+      m_ids[victim].Cancel ();
+      m_cancelled[victim] = true;
+    }
+  // move a pending event, possibly to the current time
+  uint32_t moved = m_random->GetInteger (0, m_ids.size () - 1);
+  if (!m_ids[moved].IsExpired ())
+    {
+      int64_t delay = m_random->GetInteger (0, 3) == 0 ? 0 : m_random->GetInteger (0, 1000);
+      EventId stale = m_ids[moved];
+      m_ids[moved] = Simulator::Reschedule (m_ids[moved], NanoSeconds (delay));
+      m_timestamps[moved] = Now ().GetNanoSeconds () + delay;
+      m_sequence[moved] = m_nScheduled++;
+      NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (m_ids[moved]), NanoSeconds (delay), "Wrong delay of rescheduled event " << moved);
+      // the id used to reschedule the event is expired, and does not cancel it
+      NS_TEST_EXPECT_MSG_EQ (stale.IsExpired (), true, "The old id of rescheduled event " << moved << " is not expired");
+      NS_TEST_EXPECT_MSG_EQ (stale.IsRunning (), false, "The old id of rescheduled event " << moved << " is running");
+      if (moved % 2 == 0)
+        {
+          stale.Cancel ();
+        }
+      else
+        {
+          Simulator::Remove (stale);
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_ids[moved].IsRunning (), true, "Rescheduled event " << moved << " was cancelled by its old id");
+    }
+}
+
+void
+SimulatorOrderTestCase::DoRun (void)
+{
+  Simulator::SetScheduler (m_schedulerFactory);
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  m_nRun = 0;
+  m_lastIndex = 0;
+  m_nScheduled = 0;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      m_timestamps.push_back (m_random->GetInteger (0, 10000));
+      m_cancelled.push_back (false);
+      m_sequence.push_back (m_nScheduled++);
+      m_ids.push_back (Simulator::Schedule (NanoSeconds (m_timestamps.back ()), &SimulatorOrderTestCase::Event, this, i));
+    }
+  for (uint32_t i = 0; i < 1000; i += 7)
+    {
+      Simulator::Remove (m_ids[i]);
+      m_cancelled[i] = true;
+    }
+  // move some events before the simulation starts
+  for (uint32_t i = 3; i < 1000; i += 11)
+    {
+      if (!m_cancelled[i])
+        {
+          m_timestamps[i] = m_random->GetInteger (0, 10000);
+          m_sequence[i] = m_nScheduled++;
+          EventId stale = m_ids[i];
+          m_ids[i] = Simulator::Reschedule (m_ids[i], NanoSeconds (m_timestamps[i]));
+          m_stale.push_back (stale);
+        }
+    }
+  for (std::vector<EventId>::iterator i = m_stale.begin (); i != m_stale.end (); i++)
+    {
+      Simulator::Cancel (*i);
+    }
+  Simulator::Run ();
+  for (std::vector<EventId>::iterator i = m_stale.begin (); i != m_stale.end (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (i->IsExpired (), true, "The old id of a rescheduled event is not expired");
+    }
+  uint32_t nCancelled = std::count (m_cancelled.begin (), m_cancelled.end (), true);
+  NS_TEST_EXPECT_MSG_EQ (m_nRun + nCancelled, m_timestamps.size (), "Every event either ran or was cancelled");
+  Simulator::Destroy ();
+}
+
+class EventAllocatorTestCase : public TestCase
+{
+public:
+  EventAllocatorTestCase ();
+  virtual void DoRun (void);
+  void Event (void);
+  uint32_t m_nRun;  // the number of events run
+};
+
+EventAllocatorTestCase::EventAllocatorTestCase ()
+  : TestCase ("Check the recycling of the memory of the events")
+{
+}
+
+void
+EventAllocatorTestCase::Event (void)
+{
+  m_nRun++;
+}
+
+void
+EventAllocatorTestCase::DoRun (void)
+{
+  EventAllocator::Statistics before = EventAllocator::GetStatistics ();
+
+  // blocks of the same size class are reused
+  void *block = EventAllocator::Allocate (40);
+  EventAllocator::Release (block, 40);
+  void *other = EventAllocator::Allocate (33);
+  NS_TEST_EXPECT_MSG_EQ (other, block, "The released block was not reused");
+  EventAllocator::Release (other, 33);
+  void *large = EventAllocator::Allocate (1000);
+  EventAllocator::Release (large, 1000);
+
+  EventAllocator::Statistics after = EventAllocator::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (after.allocations - before.allocations, 3, "Unexpected number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (after.releases - before.releases, 3, "Unexpected number of releases");
+  NS_TEST_EXPECT_MSG_EQ (after.unpooled - before.unpooled, 1, "Unexpected number of unpooled allocations");
+
+  // the events are allocated by the allocator and all released by Destroy
+  before = after;
+  m_nRun = 0;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &EventAllocatorTestCase::Event, this);
+    }
+  Simulator::Schedule (NanoSeconds (1000), &EventAllocatorTestCase::Event, this);
+  Simulator::Stop (NanoSeconds (500));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  after = EventAllocator::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (m_nRun, 100, "Unexpected number of events run");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (after.allocations - before.allocations, 102, "The events were not allocated by the allocator");
+  NS_TEST_EXPECT_MSG_EQ (after.allocations - before.allocations, after.releases - before.releases,
+                         "Some events were not released");
+
+#ifdef HAVE_PTHREAD_H
+  // the blocks released by a thread which did not allocate them are reused
+  // by the other threads rather than hoarded by the releasing thread
+  const std::size_t nBlocks = 4096;
+  std::vector<void *> blocks;
+  std::thread producer ([&blocks, nBlocks] ()
+                        {
+                          for (std::size_t i = 0; i < nBlocks; i++)
+                            {
+                              blocks.push_back (EventAllocator::Allocate (200));
+                            }
+                        });
+  producer.join ();
+  for (std::size_t i = 0; i < nBlocks; i++)
+    {
+      EventAllocator::Release (blocks[i], 200);
+    }
+  before = EventAllocator::GetStatistics ();
+  std::thread consumer ([&blocks, nBlocks] ()
+                        {
+                          for (std::size_t i = 0; i < nBlocks; i++)
+                            {
+                              blocks[i] = EventAllocator::Allocate (200);
+                            }
+                          for (std::size_t i = 0; i < nBlocks; i++)
+                            {
+                              EventAllocator::Release (blocks[i], 200);
+                            }
+                        });
+  consumer.join ();
+  after = EventAllocator::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (after.allocations - before.allocations, nBlocks, "Allocations of the other threads are counted");
+  NS_TEST_EXPECT_MSG_LT (after.chunks - before.chunks, 8u, "The blocks released by the main thread were not reused");
+#endif
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -477,5 +708,18 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuaternaryHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuaternaryHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+
+    AddTestCase (new EventAllocatorTestCase, TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -20,6 +20,8 @@
 #include "ns3/traced-callback.h"
 #include "ns3/unused.h"
 
+#include <vector>
+
 using namespace ns3;
 
 class BasicTracedCallbackTestCase : public TestCase
@@ -113,6 +115,79 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ManySinksTracedCallbackTestCase : public TestCase
+{
+public:
+  ManySinksTracedCallbackTestCase ();
+  virtual ~ManySinksTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  static void Sink (std::vector<uint32_t> *calls, uint32_t index, uint8_t a, double b);
+};
+
+ManySinksTracedCallbackTestCase::ManySinksTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback operation with more sinks than stored inline")
+{
+}
+
+void
+ManySinksTracedCallbackTestCase::Sink (std::vector<uint32_t> *calls, uint32_t index, uint8_t a, double b)
+{
+  NS_UNUSED (a);
+  NS_UNUSED (b);
+  calls->push_back (index);
+}
+
+void
+ManySinksTracedCallbackTestCase::DoRun (void)
+{
+  std::vector<uint32_t> calls;
+  TracedCallback<uint8_t, double> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "New TracedCallback not empty");
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (calls.size (), 0, "Sink called without connection");
+
+  //
+  // The sinks are called in the order they were connected, whether they
+  // are stored within the TracedCallback or not.
+  //
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      trace.ConnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &calls, i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "TracedCallback with sinks empty");
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (calls.size (), 5, "Sinks not called");
+  for (uint32_t i = 0; i < calls.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (calls[i], i, "Sinks called out of order");
+    }
+
+  //
+  // A copy has its own sinks.
+  //
+  TracedCallback<uint8_t, double> copy = trace;
+  trace.DisconnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &calls, 1));
+  trace.DisconnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &calls, 3));
+  calls.clear ();
+  trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (calls.size (), 3, "Sinks not disconnected");
+  NS_TEST_EXPECT_MSG_EQ (calls[0], 0, "Wrong sink called");
+  NS_TEST_EXPECT_MSG_EQ (calls[1], 2, "Wrong sink called");
+  NS_TEST_EXPECT_MSG_EQ (calls[2], 4, "Wrong sink called");
+  calls.clear ();
+  copy (1, 2);
+  NS_TEST_EXPECT_MSG_EQ (calls.size (), 5, "Copy changed by the disconnection");
+
+  //
+  // Assigning an empty TracedCallback disconnects all the sinks.
+  //
+  copy = TracedCallback<uint8_t, double> ();
+  NS_TEST_EXPECT_MSG_EQ (copy.IsEmpty (), true, "Assigned TracedCallback not empty");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +198,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ManySinksTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -89,7 +89,7 @@ CsmaHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool prom
       return;
     }
 
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
 
   std::string filename;
   if (explicitFilename)
@@ -64,7 +64,7 @@ FdNetDeviceHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
       return;
     }
 
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
 
   std::string filename;
   if (explicitFilename)
@@ -473,4 +473,10 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
   return GetSerializedSize ();
 }
 
+bool
+Ipv4Header::IsSelfContained (void) const
+{
+  return true;
+}
+
 } // namespace ns3
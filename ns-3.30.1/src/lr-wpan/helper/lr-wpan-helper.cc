@@ -286,7 +286,7 @@ LrWpanHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool pr
       return;
     }
 
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
 
   std::string filename;
   if (explicitFilename)
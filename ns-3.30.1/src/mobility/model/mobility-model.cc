@@ -21,6 +21,7 @@
 #include <cmath>
 
 #include "mobility-model.h"
+#include "mobility-position-store.h"
 #include "ns3/trace-source-accessor.h"
 
 namespace ns3 {
@@ -53,11 +54,13 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_positionIndex (MobilityPositionStore::Get ()->Add (this))
 {
 }
 
 MobilityModel::~MobilityModel ()
 {
+  MobilityPositionStore::Get ()->Remove (m_positionIndex);
 }
 
 Vector
@@ -75,6 +78,13 @@ void
 MobilityModel::SetPosition (const Vector &position)
 {
   DoSetPosition (position);
+  MobilityPositionStore::Get ()->Invalidate (m_positionIndex);
+}
+
+uint32_t
+MobilityModel::GetPositionIndex (void) const
+{
+  return m_positionIndex;
 }
 
 double 
@@ -94,6 +104,7 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  MobilityPositionStore::Get ()->Invalidate (m_positionIndex);
   m_courseChangeTrace (this);
 }
 
@@ -59,6 +59,11 @@ public:
    * \return the current velocity.
    */
   Vector GetVelocity (void) const;
+  /**
+   * \return the index of this model in the MobilityPositionStore, which
+   * holds a copy of its current position
+   */
+  uint32_t GetPositionIndex (void) const;
   /**
    * \param position a reference to another mobility model
    * \return the distance between the two objects. Unit is meters.
@@ -129,6 +134,8 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  uint32_t m_positionIndex; //!< the index of this model in the MobilityPositionStore
+
 };
 
 } // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-position-store.h"
+#include "mobility-model.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityPositionStore");
+
+const int64_t MobilityPositionStore::INVALID;
+
+MobilityPositionStore *
+MobilityPositionStore::Get (void)
+{
+  // never destroyed, since mobility models may be destroyed by static destructors
+  static MobilityPositionStore *store = new MobilityPositionStore ();
+  return store;
+}
+
+MobilityPositionStore::MobilityPositionStore ()
+  : m_nUpdates (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+MobilityPositionStore::Add (MobilityModel *model)
+{
+  NS_LOG_FUNCTION (this << model);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (m_mutex);
+#endif
+  uint32_t index;
+  if (!m_freeIndexes.empty ())
+    {
+      index = m_freeIndexes.back ();
+      m_freeIndexes.pop_back ();
+      m_models[index] = model;
+    }
+  else
+    {
+      index = m_models.size ();
+      m_x.push_back (0.0);
+      m_y.push_back (0.0);
+      m_z.push_back (0.0);
+      m_timeSteps.push_back (INVALID);
+      m_models.push_back (model);
+    }
+  m_timeSteps[index] = INVALID;
+  return index;
+}
+
+void
+MobilityPositionStore::Remove (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (m_mutex);
+#endif
+  NS_ASSERT (index < m_models.size () && m_models[index] != 0);
+  m_models[index] = 0;
+  m_timeSteps[index] = INVALID;
+  m_freeIndexes.push_back (index);
+}
+
+uint32_t
+MobilityPositionStore::GetN (void) const
+{
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (m_mutex);
+#endif
+  return m_models.size ();
+}
+
+MobilityModel *
+MobilityPositionStore::GetModel (uint32_t index) const
+{
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (m_mutex);
+#endif
+  NS_ASSERT (index < m_models.size ());
+  return m_models[index];
+}
+
+void
+MobilityPositionStore::Update (uint32_t index, int64_t now)
+{
+  NS_ASSERT (index < m_models.size () && m_models[index] != 0);
+  Vector position = m_models[index]->GetPosition ();
+  m_x[index] = position.x;
+  m_y[index] = position.y;
+  m_z[index] = position.z;
+  m_timeSteps[index] = now;
+  m_nUpdates.fetch_add (1, std::memory_order_relaxed);
+}
+
+Vector
+MobilityPositionStore::Read (uint32_t index) const
+{
+  MobilityModel *model = GetModel (index);
+  NS_ASSERT (model != 0);
+  m_nUpdates.fetch_add (1, std::memory_order_relaxed);
+  return model->GetPosition ();
+}
+
+void
+MobilityPositionStore::GetPositions (const std::vector<uint32_t> &indexes, std::vector<Vector> &positions)
+{
+  positions.resize (indexes.size ());
+#ifdef NS3_MTP
+  for (std::size_t i = 0; i < indexes.size (); i++)
+    {
+      positions[i] = Read (indexes[i]);
+    }
+#else
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  for (std::size_t i = 0; i < indexes.size (); i++)
+    {
+      uint32_t index = indexes[i];
+      if (m_timeSteps[index] != now)
+        {
+          Update (index, now);
+        }
+      positions[i] = Vector (m_x[index], m_y[index], m_z[index]);
+    }
+#endif
+}
+
+void
+MobilityPositionStore::UpdateAll (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifndef NS3_MTP
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  for (uint32_t index = 0; index < m_models.size (); index++)
+    {
+      if (m_models[index] != 0 && m_timeSteps[index] != now)
+        {
+          Update (index, now);
+        }
+    }
+#endif
+}
+
+uint64_t
+MobilityPositionStore::GetNUpdates (void) const
+{
+  return m_nUpdates.load (std::memory_order_relaxed);
+}
+
+} // namespace ns3
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MOBILITY_POSITION_STORE_H
+#define MOBILITY_POSITION_STORE_H
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+#ifdef NS3_MTP
+#include <mutex>
+#endif
+#include "ns3/vector.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief The positions of all the mobility models, stored as a structure
+ * of arrays and updated at most once per simulated instant.
+ *
+ * Every MobilityModel is given a dense index in the store when it is
+ * created, returned by MobilityModel::GetPositionIndex.  The first read
+ * of the position of a model at a given simulation time asks the model
+ * for its position, and the later reads at the same time return the
+ * stored copy, without any virtual call.  The stored position of a model
+ * is invalidated by MobilityModel::SetPosition and when the model
+ * notifies a course change, so the reads always return the same position
+ * as MobilityModel::GetPosition.
+ *
+ * The channels read the positions of the transmitter and of the
+ * receivers of a frame through the store:
+ * \code
+ *   MobilityPositionStore *store = MobilityPositionStore::Get ();
+ *   Vector position = store->GetPosition (mobility->GetPositionIndex ());
+ * \endcode
+ *
+ * The store is not protected against concurrent accesses, and must only
+ * be read by the threads running simulation events.  When the
+ * multithreaded simulator is built (NS3_MTP), the logical processes read
+ * the positions concurrently, so the positions are not stored: every read
+ * asks the mobility model, and Add and Remove are serialized by a mutex.
+ */
+class MobilityPositionStore
+{
+public:
+  /**
+   * \return the store of the positions of all the mobility models
+   */
+  static MobilityPositionStore * Get (void);
+
+  /**
+   * Give a dense index to a mobility model.
+   *
+   * \param model the mobility model
+   * \return the index of the model
+   */
+  uint32_t Add (MobilityModel *model);
+  /**
+   * Release the index of a mobility model, which may be given to another
+   * mobility model afterwards.
+   *
+   * \param index the index of the model
+   */
+  void Remove (uint32_t index);
+  /**
+   * Discard the stored position of a mobility model, so that the next read
+   * asks the model for its position.
+   *
+   * \param index the index of the model
+   */
+  void Invalidate (uint32_t index)
+  {
+#ifndef NS3_MTP
+    m_timeSteps[index] = INVALID;
+#endif
+  }
+
+  /**
+   * \return one past the largest index given to a mobility model
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param index an index
+   * \return the mobility model with this index, or 0 if the index is unused
+   */
+  MobilityModel * GetModel (uint32_t index) const;
+
+  /**
+   * \param index the index of a mobility model
+   * \return the position of the model at the current simulation time
+   */
+  Vector GetPosition (uint32_t index)
+  {
+#ifdef NS3_MTP
+    return Read (index);
+#else
+    int64_t now = Simulator::Now ().GetTimeStep ();
+    if (m_timeSteps[index] != now)
+      {
+        Update (index, now);
+      }
+    return Vector (m_x[index], m_y[index], m_z[index]);
+#endif
+  }
+  /**
+   * Read the positions of several mobility models at the current
+   * simulation time.
+   *
+   * \param indexes the indexes of the models
+   * \param positions the positions of the models
+   */
+  void GetPositions (const std::vector<uint32_t> &indexes, std::vector<Vector> &positions);
+  /**
+   * Bring the stored positions of all the mobility models up to date with
+   * the current simulation time.
+   */
+  void UpdateAll (void);
+
+  /**
+   * \return the number of times a mobility model was asked for its position
+   */
+  uint64_t GetNUpdates (void) const;
+
+private:
+  MobilityPositionStore ();
+
+  /**
+   * Ask a mobility model for its position, and store it.
+   *
+   * \param index the index of the model
+   * \param now the current simulation time, in time steps
+   */
+  void Update (uint32_t index, int64_t now);
+  /**
+   * Ask a mobility model for its position, without storing it.
+   * \param index the index of the model
+   * \return the position of the model
+   */
+  Vector Read (uint32_t index) const;
+
+  /// The time of the stored position of a model whose position is unknown
+  static const int64_t INVALID = -1;
+
+  std::vector<double> m_x;                //!< the x coordinates of the positions
+  std::vector<double> m_y;                //!< the y coordinates of the positions
+  std::vector<double> m_z;                //!< the z coordinates of the positions
+  std::vector<int64_t> m_timeSteps;       //!< the times of the positions, in time steps
+  std::vector<MobilityModel *> m_models;  //!< the mobility models
+  std::vector<uint32_t> m_freeIndexes;    //!< the indexes released by Remove
+  mutable std::atomic<uint64_t> m_nUpdates; //!< the number of positions asked to the models
+#ifdef NS3_MTP
+  mutable std::mutex m_mutex;             //!< the mutex protecting the models from Add and Remove
+#endif
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_POSITION_STORE_H */
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/mobility-position-store.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \param a a position
+ * \param b another position
+ * \return true if the positions are the same
+ */
+static bool
+SamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the positions read from the MobilityPositionStore are
+ * the positions of the models, and that each model is asked for its
+ * position at most once per simulated instant.
+ */
+class MobilityPositionStoreTest : public TestCase
+{
+public:
+  MobilityPositionStoreTest ();
+  virtual ~MobilityPositionStoreTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the position of the moving model at the current time.
+   */
+  void CheckMoving (void);
+  /**
+   * Change the course of the moving model, and check that the store
+   * returns its new position.
+   */
+  void ChangeCourse (void);
+
+  Ptr<ConstantVelocityMobilityModel> m_moving; //!< the moving model
+};
+
+MobilityPositionStoreTest::MobilityPositionStoreTest ()
+  : TestCase ("Check the positions read from the MobilityPositionStore")
+{
+}
+
+MobilityPositionStoreTest::~MobilityPositionStoreTest ()
+{
+}
+
+void
+MobilityPositionStoreTest::CheckMoving (void)
+{
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
+  uint64_t updates = store->GetNUpdates ();
+  Vector position = store->GetPosition (m_moving->GetPositionIndex ());
+  NS_TEST_EXPECT_MSG_EQ (SamePosition (position, m_moving->GetPosition ()), true, "wrong position at " << Simulator::Now ());
+  position = store->GetPosition (m_moving->GetPositionIndex ());
+  NS_TEST_EXPECT_MSG_EQ (SamePosition (position, m_moving->GetPosition ()), true, "wrong position at " << Simulator::Now ());
+#ifdef NS3_MTP
+  // the positions are not stored when the logical processes may read them concurrently
+  NS_TEST_EXPECT_MSG_EQ (store->GetNUpdates () - updates, 2u, "the model was not asked for each position");
+#else
+  NS_TEST_EXPECT_MSG_EQ (store->GetNUpdates () - updates, 1u, "the model was asked twice for its position");
+#endif
+}
+
+void
+MobilityPositionStoreTest::ChangeCourse (void)
+{
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
+  store->GetPosition (m_moving->GetPositionIndex ());
+  m_moving->SetPosition (Vector (100.0, 0.0, 0.0));
+  NS_TEST_EXPECT_MSG_EQ (SamePosition (store->GetPosition (m_moving->GetPositionIndex ()), Vector (100.0, 0.0, 0.0)), true,
+                         "the position was not invalidated by SetPosition");
+  m_moving->SetVelocity (Vector (0.0, -2.0, 0.0));
+  CheckMoving ();
+}
+
+void
+MobilityPositionStoreTest::DoRun (void)
+{
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
+
+  m_moving = CreateObject<ConstantVelocityMobilityModel> ();
+  m_moving->SetPosition (Vector (1.0, 2.0, 3.0));
+  m_moving->SetVelocity (Vector (1.5, 0.5, 0.0));
+  NS_TEST_EXPECT_MSG_EQ (store->GetModel (m_moving->GetPositionIndex ()), PeekPointer (m_moving), "wrong model");
+
+  Ptr<ConstantPositionMobilityModel> fixed = CreateObject<ConstantPositionMobilityModel> ();
+  fixed->SetPosition (Vector (5.0, 6.0, 7.0));
+  std::vector<uint32_t> indexes;
+  indexes.push_back (fixed->GetPositionIndex ());
+  indexes.push_back (m_moving->GetPositionIndex ());
+  std::vector<Vector> positions;
+  store->GetPositions (indexes, positions);
+  NS_TEST_EXPECT_MSG_EQ (positions.size (), 2u, "wrong number of positions");
+  NS_TEST_EXPECT_MSG_EQ (SamePosition (positions[0], Vector (5.0, 6.0, 7.0)), true, "wrong position");
+  NS_TEST_EXPECT_MSG_EQ (SamePosition (positions[1], Vector (1.0, 2.0, 3.0)), true, "wrong position");
+
+  // the index of a destroyed model is given to the next model
+  uint32_t fixedIndex = fixed->GetPositionIndex ();
+  fixed = 0;
+  Ptr<ConstantPositionMobilityModel> other = CreateObject<ConstantPositionMobilityModel> ();
+  NS_TEST_EXPECT_MSG_EQ (other->GetPositionIndex (), fixedIndex, "the index was not reused");
+  NS_TEST_EXPECT_MSG_EQ (SamePosition (store->GetPosition (fixedIndex), Vector (0.0, 0.0, 0.0)), true, "stale position of the destroyed model");
+
+  Simulator::Schedule (Seconds (1.0), &MobilityPositionStoreTest::CheckMoving, this);
+  Simulator::Schedule (Seconds (1.5), &MobilityPositionStoreTest::CheckMoving, this);
+  Simulator::Schedule (Seconds (2.0), &MobilityPositionStoreTest::ChangeCourse, this);
+  Simulator::Schedule (Seconds (3.0), &MobilityPositionStoreTest::CheckMoving, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_moving = 0;
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief MobilityPositionStore Test Suite
+ */
+class MobilityPositionStoreTestSuite : public TestSuite
+{
+public:
+  MobilityPositionStoreTestSuite ();
+};
+
+MobilityPositionStoreTestSuite::MobilityPositionStoreTestSuite ()
+  : TestSuite ("mobility-position-store", UNIT)
+{
+  AddTestCase (new MobilityPositionStoreTest, TestCase::QUICK);
+}
+
+static MobilityPositionStoreTestSuite g_mobilityPositionStoreTestSuite; ///< the test suite
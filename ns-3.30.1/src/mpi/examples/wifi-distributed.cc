@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * WifiDistributed splits an ad hoc Wi-Fi network of two groups of stations
+ * between two logical processors: the stations of the left group, placed on
+ * logical processor 0, send UDP traffic to the stations of the right group,
+ * placed on logical processor 1, over a YansWifiChannel spanning both.  The
+ * lookahead is the propagation delay between the closest stations of the
+ * two groups.
+ *
+ * Run with "mpirun -np 2 ./waf --run wifi-distributed", or
+ * "mpirun -np 2 ./waf --run 'wifi-distributed --nullmsg'" to use the
+ * null message synchronization.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiDistributed");
+
+int
+main (int argc, char *argv[])
+{
+#ifdef NS3_MPI
+
+  bool nullmsg = false;
+  uint32_t nStations = 4;
+  double distance = 30.0;
+
+  // Parse command line
+  CommandLine cmd;
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.AddValue ("nStations", "Number of stations of each group", nStations);
+  cmd.AddValue ("distance", "Distance between the two groups (m)", distance);
+  cmd.Parse (argc, argv);
+
+  // Distributed simulation setup; by default use granted time window algorithm.
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+
+  // Enable parallel simulator with the command line arguments
+  MpiInterface::Enable (&argc, &argv);
+
+  LogComponentEnable ("PacketSink", LOG_LEVEL_INFO);
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  // Check for valid distributed parameters.
+  // Must have 2 and only 2 Logical Processors (LPs)
+  if (systemCount != 2)
+    {
+      std::cout << "This simulation requires 2 and only 2 logical processors." << std::endl;
+      return 1;
+    }
+
+  // Create the left stations with system id 0 and the right stations
+  // with system id 1
+  NodeContainer leftNodes;
+  leftNodes.Create (nStations, 0);
+  NodeContainer rightNodes;
+  rightNodes.Create (nStations, 1);
+  NodeContainer allNodes (leftNodes, rightNodes);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (1.0),
+                                 "DeltaY", DoubleValue (1.0),
+                                 "GridWidth", UintegerValue (nStations),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.Install (leftNodes);
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (distance),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (1.0),
+                                 "DeltaY", DoubleValue (1.0),
+                                 "GridWidth", UintegerValue (nStations),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.Install (rightNodes);
+
+  // A single channel spans both logical processors
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, allNodes);
+
+  InternetStackHelper stack;
+  stack.Install (allNodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  // Create a packet sink on the right stations to receive packets from the left stations
+  uint16_t port = 50000;
+  if (systemId == 1)
+    {
+      Address sinkLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
+      PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", sinkLocalAddress);
+      ApplicationContainer sinkApp = sinkHelper.Install (rightNodes);
+      sinkApp.Start (Seconds (1.0));
+      sinkApp.Stop (Seconds (5));
+    }
+
+  // Create the OnOff applications to send
+  if (systemId == 0)
+    {
+      OnOffHelper clientHelper ("ns3::UdpSocketFactory", Address ());
+      clientHelper.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      clientHelper.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      clientHelper.SetAttribute ("PacketSize", UintegerValue (512));
+      clientHelper.SetAttribute ("DataRate", StringValue ("100kbps"));
+      clientHelper.SetAttribute ("MaxBytes", UintegerValue (2048));
+
+      ApplicationContainer clientApps;
+      for (uint32_t i = 0; i < nStations; ++i)
+        {
+          AddressValue remoteAddress (InetSocketAddress (interfaces.GetAddress (nStations + i), port));
+          clientHelper.SetAttribute ("Remote", remoteAddress);
+          clientApps.Add (clientHelper.Install (leftNodes.Get (i)));
+        }
+      clientApps.Start (Seconds (1.0));
+      clientApps.Stop (Seconds (5));
+    }
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // Exit the MPI execution environment
+  MpiInterface::Disable ();
+  return 0;
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
@@ -20,6 +20,7 @@
 #include "distributed-simulator-impl.h"
 #include "granted-time-window-mpi-interface.h"
 #include "mpi-interface.h"
+#include "remote-channel-lookahead.h"
 
 #include "ns3/simulator.h"
 #include "ns3/scheduler.h"
@@ -32,6 +33,7 @@
 #include "ns3/log.h"
 
 #include <cmath>
+#include <set>
 
 #ifdef NS3_MPI
 #include <mpi.h>
@@ -179,6 +181,7 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
         }
       // else it was already set by SetLookAhead
 
+      std::set<Ptr<Channel> > remoteChannels;
       NodeContainer c = NodeContainer::GetGlobal ();
       for (NodeContainer::Iterator iter = c.Begin (); iter != c.End (); ++iter)
         {
@@ -190,9 +193,28 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
           for (uint32_t i = 0; i < (*iter)->GetNDevices (); ++i)
             {
               Ptr<NetDevice> localNetDevice = (*iter)->GetDevice (i);
-              // only works for p2p links currently
+              // the other channels spanning several systems give
+              // their smallest delay through a RemoteChannelLookahead
               if (!localNetDevice->IsPointToPoint ())
                 {
+                  Ptr<Channel> channel = localNetDevice->GetChannel ();
+                  Ptr<RemoteChannelLookahead> remote = channel ? channel->GetObject<RemoteChannelLookahead> () : 0;
+                  if (remote == 0 || !remoteChannels.insert (channel).second)
+                    {
+                      continue;
+                    }
+                  for (uint32_t systemId = 0; systemId < MpiInterface::GetSize (); ++systemId)
+                    {
+                      if (systemId == MpiInterface::GetSystemId ())
+                        {
+                          continue;
+                        }
+                      Time delay = remote->GetMinimumDelay (systemId);
+                      if (!delay.IsStrictlyNegative () && delay < m_lookAhead)
+                        {
+                          m_lookAhead = delay;
+                        }
+                    }
                   continue;
                 }
               Ptr<Channel> channel = localNetDevice->GetChannel ();
@@ -594,10 +616,41 @@ DistributedSimulatorImpl::Cancel (const EventId &id)
 {
   if (!IsExpired (id))
     {
-      id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () != 2 && m_events->HasFastRemove ())
+        {
+          // do not leave the cancelled event in the event list
+          Remove (id);
+        }
+      else
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
     }
 }
 
+EventId
+DistributedSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay.GetTimeStep ());
+  NS_ASSERT_MSG (id.GetUid () != 2, "DistributedSimulatorImpl::Reschedule(): Destroy event");
+  NS_ASSERT_MSG (!IsExpired (id), "DistributedSimulatorImpl::Reschedule(): Expired event");
+  NS_ASSERT_MSG (delay.IsPositive (), "DistributedSimulatorImpl::Reschedule(): Negative delay");
+
+  Scheduler::Event ev;
+  ev.impl = id.PeekEventImpl ();
+  ev.key.m_ts = id.GetTs ();
+  ev.key.m_context = id.GetContext ();
+  ev.key.m_uid = id.GetUid ();
+  Scheduler::EventKey key;
+  key.m_ts = static_cast<uint64_t> ((delay + TimeStep (m_currentTs)).GetTimeStep ());
+  key.m_context = id.GetContext ();
+  key.m_uid = m_uid;
+  m_uid++;
+  m_events->Reschedule (ev, key);
+  ev.impl->SetRescheduledUid (key.m_uid);
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
 bool
 DistributedSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -622,6 +675,7 @@ DistributedSimulatorImpl::IsExpired (const EventId &id) const
       || id.GetTs () < m_currentTs
       || (id.GetTs () == m_currentTs
           && id.GetUid () <= m_currentUid)
+      || id.PeekEventImpl ()->IsStale (id.GetUid ())
       || id.PeekEventImpl ()->IsCancelled ())
     {
       return true;
@@ -24,6 +24,7 @@
 #include "null-message-mpi-interface.h"
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
+#include "remote-channel-lookahead.h"
 #include "mpi-interface.h"
 
 #include <ns3/simulator.h>
@@ -38,6 +39,7 @@
 #include <ns3/log.h>
 
 #include <cmath>
+#include <set>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -145,6 +147,7 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
 
   if (MpiInterface::GetSize () > 1)
     {
+      std::set<Ptr<Channel> > remoteChannels;
       NodeContainer c = NodeContainer::GetGlobal ();
       for (NodeContainer::Iterator iter = c.Begin (); iter != c.End (); ++iter)
         {
@@ -158,9 +161,34 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
           for (uint32_t i = 0; i < (*iter)->GetNDevices (); ++i)
             {
               Ptr<NetDevice> localNetDevice = (*iter)->GetDevice (i);
-              // only works for p2p links currently
+              // the other channels spanning several systems give
+              // their smallest delay through a RemoteChannelLookahead
               if (!localNetDevice->IsPointToPoint ())
                 {
+                  Ptr<Channel> channel = localNetDevice->GetChannel ();
+                  Ptr<RemoteChannelLookahead> remote = channel ? channel->GetObject<RemoteChannelLookahead> () : 0;
+                  if (remote == 0 || !remoteChannels.insert (channel).second)
+                    {
+                      continue;
+                    }
+                  for (uint32_t systemId = 0; systemId < MpiInterface::GetSize (); ++systemId)
+                    {
+                      if (systemId == MpiInterface::GetSystemId ())
+                        {
+                          continue;
+                        }
+                      Time delay = remote->GetMinimumDelay (systemId);
+                      if (delay.IsStrictlyNegative ())
+                        {
+                          continue;
+                        }
+                      Ptr<RemoteChannelBundle> remoteChannelBundle = RemoteChannelBundleManager::Find (systemId);
+                      if (!remoteChannelBundle)
+                        {
+                          remoteChannelBundle = RemoteChannelBundleManager::Add (systemId);
+                        }
+                      remoteChannelBundle->AddChannel (channel, delay);
+                    }
                   continue;
                 }
               Ptr<Channel> channel = localNetDevice->GetChannel ();
@@ -525,10 +553,41 @@ NullMessageSimulatorImpl::Cancel (const EventId &id)
 {
   if (!IsExpired (id))
     {
-      id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () != 2 && m_events->HasFastRemove ())
+        {
+          // do not leave the cancelled event in the event list
+          Remove (id);
+        }
+      else
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
     }
 }
 
+EventId
+NullMessageSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay.GetTimeStep ());
+  NS_ASSERT_MSG (id.GetUid () != 2, "NullMessageSimulatorImpl::Reschedule(): Destroy event");
+  NS_ASSERT_MSG (!IsExpired (id), "NullMessageSimulatorImpl::Reschedule(): Expired event");
+  NS_ASSERT_MSG (delay.IsPositive (), "NullMessageSimulatorImpl::Reschedule(): Negative delay");
+
+  Scheduler::Event ev;
+  ev.impl = id.PeekEventImpl ();
+  ev.key.m_ts = id.GetTs ();
+  ev.key.m_context = id.GetContext ();
+  ev.key.m_uid = id.GetUid ();
+  Scheduler::EventKey key;
+  key.m_ts = static_cast<uint64_t> ((delay + TimeStep (m_currentTs)).GetTimeStep ());
+  key.m_context = id.GetContext ();
+  key.m_uid = m_uid;
+  m_uid++;
+  m_events->Reschedule (ev, key);
+  ev.impl->SetRescheduledUid (key.m_uid);
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
 bool
 NullMessageSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -553,6 +612,7 @@ NullMessageSimulatorImpl::IsExpired (const EventId &id) const
       || id.GetTs () < m_currentTs
       || (id.GetTs () == m_currentTs
           && id.GetUid () <= m_currentUid)
+      || id.PeekEventImpl ()->IsStale (id.GetUid ())
       || id.PeekEventImpl ()->IsCancelled ())
     {
       return true;
@@ -588,7 +648,10 @@ Time NullMessageSimulatorImpl::CalculateGuaranteeTime (uint32_t nodeSysId)
   Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
   NS_ASSERT (bundle);
 
-  return Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ()) + bundle->GetDelay ();
+  // the packets are sent while an event runs, which may still schedule
+  // events earlier than the next one in the queue, hence the current time
+  Time next = Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ());
+  return Min (Now (), next) + bundle->GetDelay ();
 }
 
 void NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bundle)
@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "remote-channel-lookahead.h"
+
+namespace ns3 {
+
+TypeId
+RemoteChannelLookahead::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RemoteChannelLookahead")
+    .SetParent<Object> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor <RemoteChannelLookahead> ();
+  return tid;
+}
+
+RemoteChannelLookahead::~RemoteChannelLookahead ()
+{
+}
+
+void
+RemoteChannelLookahead::SetMinimumDelayCallback (Callback<Time, uint32_t> callback)
+{
+  m_delayCallback = callback;
+}
+
+Time
+RemoteChannelLookahead::GetMinimumDelay (uint32_t systemId)
+{
+  NS_ASSERT (!m_delayCallback.IsNull ());
+  return m_delayCallback (systemId);
+}
+
+void
+RemoteChannelLookahead::DoDispose (void)
+{
+  m_delayCallback = MakeNullCallback<Time, uint32_t> ();
+}
+
+} // namespace ns3
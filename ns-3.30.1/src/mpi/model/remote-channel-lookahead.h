@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_REMOTE_CHANNEL_LOOKAHEAD_H
+#define NS3_REMOTE_CHANNEL_LOOKAHEAD_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Class to aggregate to a Channel which connects the nodes of
+ * several systems without being a point to point channel
+ *
+ * The distributed simulators compute their lookahead from the "Delay"
+ * attribute of the point to point channels between local and remote
+ * nodes.  The delay of the other channels, such as the wireless channels,
+ * depends on the position of the nodes, and only the channel itself can
+ * tell the smallest delay of a transmission from a local node to the nodes
+ * of another system.  Such a channel aggregates one of these objects and
+ * sets its callback, which the simulators invoke for every remote system
+ * when the simulation starts.
+ */
+class RemoteChannelLookahead : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual ~RemoteChannelLookahead ();
+
+  /**
+   * \brief Get the smallest delay of a transmission from the local system
+   * to a remote system
+   * \param systemId the remote system id
+   * \return the smallest delay, or a negative time if the channel does not
+   *         connect the local system to the remote system
+   */
+  Time GetMinimumDelay (uint32_t systemId);
+  /**
+   * \brief Set the callback computing the smallest delays
+   * \param callback the callback itself
+   */
+  void SetMinimumDelayCallback (Callback<Time, uint32_t> callback);
+private:
+  virtual void DoDispose (void);
+
+  Callback<Time, uint32_t> m_delayCallback;  //!< computes the smallest delay to a system
+};
+
+} // namespace ns3
+
+#endif /* NS3_REMOTE_CHANNEL_LOOKAHEAD_H */
@@ -0,0 +1,761 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/unused.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** The timestamp meaning "never". */
+const uint64_t NEVER = std::numeric_limits<uint64_t>::max ();
+
+/**
+ * The logical process whose events the calling thread is running, or zero
+ * outside of the time windows.
+ */
+thread_local void *g_currentLp = 0;
+
+/**
+ * Find the representative of the set of a node, compressing the path.
+ *
+ * \param [in,out] parent The parent of each node.
+ * \param [in] node The node.
+ * \returns The representative node.
+ */
+uint32_t
+FindSet (std::vector<uint32_t> &parent, uint32_t node)
+{
+  while (parent[node] != node)
+    {
+      parent[node] = parent[parent[node]];
+      node = parent[node];
+    }
+  return node;
+}
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mtp")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("MaxThreads",
+                   "The largest number of threads running the logical processes, "
+                   "zero meaning the number of hardware threads.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_maxThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Lookahead",
+                   "The length of the time windows, overriding the smallest delay "
+                   "of the channels connecting the logical processes when positive.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_lookaheadAttribute),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_partitioned (false),
+    m_lookahead (NEVER),
+    m_maxThreads (0),
+    m_parallel (false),
+    m_windowEnd (NEVER),
+    m_stop (false),
+    m_stopTs (NEVER)
+{
+  NS_LOG_FUNCTION (this);
+  LogicalProcess *global = new LogicalProcess ();
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  global->uid = 4;
+  // before ::Run is entered, the currentUid will be zero
+  global->currentUid = 0;
+  global->currentTs = 0;
+  global->currentContext = Simulator::NO_CONTEXT;
+  global->unscheduledEvents = 0;
+  global->eventCount = 0;
+  m_lps.push_back (global);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      delete *i;
+    }
+  m_lps.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      LogicalProcess *lp = *i;
+      while (!lp->events->IsEmpty ())
+        {
+          Scheduler::Event next = lp->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      lp->events = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      Ptr<EventImpl> ev;
+      {
+        std::lock_guard<std::mutex> lock (m_destroyMutex);
+        if (m_destroyEvents.empty ())
+          {
+            break;
+          }
+        ev = m_destroyEvents.front ().PeekEventImpl ();
+        m_destroyEvents.pop_front ();
+      }
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      LogicalProcess *lp = *i;
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (lp->events != 0)
+        {
+          while (!lp->events->IsEmpty ())
+            {
+              Scheduler::Event next = lp->events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      lp->events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcess (uint32_t context) const
+{
+  if (context < m_contextLp.size ())
+    {
+      return m_contextLp[context];
+    }
+  return 0;
+}
+
+MultithreadedSimulatorImpl::LogicalProcess *
+MultithreadedSimulatorImpl::GetCurrent (void) const
+{
+  LogicalProcess *lp = static_cast<LogicalProcess *> (g_currentLp);
+  return lp != 0 ? lp : m_lps[0];
+}
+
+void
+MultithreadedSimulatorImpl::Partition (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<uint32_t> parent (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      parent[i] = i;
+    }
+
+  // merge the nodes sharing a channel, unless the channel can be cut
+  std::vector<std::pair<Ptr<Channel>, uint64_t> > cuts;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); i++)
+    {
+      Ptr<Channel> channel = *i;
+      std::vector<uint32_t> nodes;
+      bool pointToPoint = true;
+      for (std::size_t j = 0; j < channel->GetNDevices (); j++)
+        {
+          Ptr<NetDevice> device = channel->GetDevice (j);
+          if (device == 0 || device->GetNode () == 0)
+            {
+              continue;
+            }
+          nodes.push_back (device->GetNode ()->GetId ());
+          pointToPoint = pointToPoint && device->IsPointToPoint ();
+        }
+      TimeValue delay;
+      if (pointToPoint &&
+          channel->GetAttributeFailSafe ("Delay", delay) &&
+          delay.Get ().IsStrictlyPositive ())
+        {
+          cuts.push_back (std::make_pair (channel, delay.Get ().GetTimeStep ()));
+          continue;
+        }
+      // the wireless channels know the smallest delay between their nodes
+      if (channel->GetAttributeFailSafe ("MinimumDelay", delay) &&
+          delay.Get ().IsStrictlyPositive ())
+        {
+          cuts.push_back (std::make_pair (channel, delay.Get ().GetTimeStep ()));
+          continue;
+        }
+      for (std::size_t j = 1; j < nodes.size (); j++)
+        {
+          parent[FindSet (parent, nodes[j])] = FindSet (parent, nodes[0]);
+        }
+    }
+
+  // one logical process per set of nodes, in the order of the node ids
+  std::vector<uint32_t> setLp (nNodes, 0);
+  m_contextLp.resize (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      uint32_t root = FindSet (parent, i);
+      if (setLp[root] == 0)
+        {
+          LogicalProcess *lp = new LogicalProcess ();
+          lp->events = m_schedulerFactory.Create<Scheduler> ();
+          lp->currentTs = m_lps[0]->currentTs;
+          lp->currentContext = Simulator::NO_CONTEXT;
+          lp->currentUid = 0;
+          // keep the uids of the events moved below unique
+          lp->uid = m_lps[0]->uid;
+          lp->eventCount = 0;
+          lp->unscheduledEvents = 0;
+          setLp[root] = m_lps.size ();
+          m_lps.push_back (lp);
+        }
+      m_contextLp[i] = setLp[root];
+    }
+
+  // the lookahead is the smallest delay of the channels which were cut
+  m_lookahead = NEVER;
+  for (std::vector<std::pair<Ptr<Channel>, uint64_t> >::const_iterator i = cuts.begin (); i != cuts.end (); i++)
+    {
+      Ptr<Channel> channel = i->first;
+      uint32_t lp = 0;
+      for (std::size_t j = 0; j < channel->GetNDevices (); j++)
+        {
+          Ptr<NetDevice> device = channel->GetDevice (j);
+          if (device == 0 || device->GetNode () == 0)
+            {
+              continue;
+            }
+          uint32_t other = m_contextLp[device->GetNode ()->GetId ()];
+          if (lp != 0 && other != lp)
+            {
+              m_lookahead = std::min (m_lookahead, i->second);
+            }
+          lp = other;
+        }
+    }
+  if (m_lookaheadAttribute.IsStrictlyPositive ())
+    {
+      m_lookahead = m_lookaheadAttribute.GetTimeStep ();
+    }
+
+  // move the events scheduled so far to their logical process
+  LogicalProcess *global = m_lps[0];
+  std::vector<Scheduler::Event> events;
+  while (!global->events->IsEmpty ())
+    {
+      events.push_back (global->events->RemoveNext ());
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      LogicalProcess *lp = m_lps[GetLogicalProcess (i->key.m_context)];
+      lp->events->Insert (*i);
+      if (lp != global)
+        {
+          global->unscheduledEvents--;
+          lp->unscheduledEvents++;
+        }
+    }
+  m_partitioned = true;
+  NS_LOG_INFO (nNodes << " nodes in " << GetNLogicalProcesses () <<
+               " logical processes, lookahead " << GetLookahead ());
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert (LogicalProcess *lp, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = lp->uid;
+  lp->uid++;
+  lp->unscheduledEvents++;
+  lp->events->Insert (ev);
+  return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (LogicalProcess *lp)
+{
+  Scheduler::Event next = lp->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= lp->currentTs);
+  lp->unscheduledEvents--;
+  lp->eventCount++;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  lp->currentTs = next.key.m_ts;
+  lp->currentContext = next.key.m_context;
+  lp->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (uint32_t thread, uint32_t begin, uint32_t end)
+{
+  NS_UNUSED (thread);
+  for (uint32_t i = begin; i < end; i++)
+    {
+      LogicalProcess *lp = m_lps[i + 1];
+      g_currentLp = lp;
+      // a Stop during the window only takes effect at its end, so that
+      // every logical process runs the same events whatever the threads
+      while (!lp->events->IsEmpty () &&
+             lp->events->PeekNext ().key.m_ts < m_windowEnd)
+        {
+          ProcessOneEvent (lp);
+        }
+    }
+  g_currentLp = 0;
+}
+
+void
+MultithreadedSimulatorImpl::DeliverMessages (void)
+{
+  // in the order of the logical processes, so that the uids, which order
+  // the events with the same timestamp, do not depend on the threads
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      std::vector<Message> &outbox = (*i)->outbox;
+      for (std::vector<Message>::const_iterator j = outbox.begin (); j != outbox.end (); j++)
+        {
+          Insert (m_lps[j->lp], j->ts, j->context, j->event);
+        }
+      outbox.clear ();
+    }
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNextTs (void) const
+{
+  uint64_t next = NEVER;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          next = std::min (next, (*i)->events->PeekNext ().key.m_ts);
+        }
+    }
+  return next;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  return GetNextTs () == NEVER || m_stop;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_partitioned)
+    {
+      Partition ();
+    }
+  uint32_t nThreads = m_maxThreads;
+  if (nThreads == 0)
+    {
+      nThreads = std::max<uint32_t> (std::thread::hardware_concurrency (), 1);
+    }
+  m_threadPool.SetNThreads (std::min<uint32_t> (nThreads, std::max<uint32_t> (GetNLogicalProcesses (), 1)));
+  m_stop = false;
+
+  LogicalProcess *global = m_lps[0];
+  while (!m_stop)
+    {
+      uint64_t next = GetNextTs ();
+      if (next == NEVER)
+        {
+          break;
+        }
+      {
+        std::lock_guard<std::mutex> lock (m_stopMutex);
+        if (next >= m_stopTs)
+          {
+            m_stopTs = NEVER;
+            break;
+          }
+      }
+
+      // the global logical process runs alone, before the other ones
+      while (!global->events->IsEmpty () &&
+             global->events->PeekNext ().key.m_ts == next &&
+             !m_stop)
+        {
+          ProcessOneEvent (global);
+        }
+      if (m_stop)
+        {
+          break;
+        }
+
+      // no logical process can receive an event earlier than the end of
+      // the window from another one
+      uint64_t windowEnd = m_lookahead < NEVER - next ? next + m_lookahead : NEVER;
+      if (!global->events->IsEmpty ())
+        {
+          windowEnd = std::min (windowEnd, global->events->PeekNext ().key.m_ts);
+        }
+      {
+        std::lock_guard<std::mutex> lock (m_stopMutex);
+        windowEnd = std::min (windowEnd, m_stopTs);
+      }
+      m_windowEnd = windowEnd;
+      m_parallel = true;
+      m_threadPool.Run (m_lps.size () - 1, MakeCallback (&MultithreadedSimulatorImpl::ProcessWindow, this));
+      m_parallel = false;
+      m_windowEnd = NEVER;
+      DeliverMessages ();
+    }
+
+  // the clock outside of the simulation is the one of the last event
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin () + 1; i != m_lps.end (); i++)
+    {
+      global->currentTs = std::max (global->currentTs, (*i)->currentTs);
+    }
+
+  // Make a consistency test to check that we didn't lose any events
+  // along the way.
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      NS_ASSERT (!(*i)->events->IsEmpty () || (*i)->unscheduledEvents == 0);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Stop(): Negative delay");
+  uint64_t ts = GetCurrent ()->currentTs + delay.GetTimeStep ();
+  std::lock_guard<std::mutex> lock (m_stopMutex);
+  m_stopTs = std::min (m_stopTs, ts);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+  LogicalProcess *lp = GetCurrent ();
+  uint64_t ts = lp->currentTs + delay.GetTimeStep ();
+  Scheduler::EventKey key = Insert (lp, ts, lp->currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::ScheduleWithContext(): Negative delay");
+  LogicalProcess *lp = GetCurrent ();
+  uint64_t ts = lp->currentTs + delay.GetTimeStep ();
+  uint32_t target = GetLogicalProcess (context);
+  if (!m_parallel || m_lps[target] == lp)
+    {
+      Insert (m_lps[target], ts, context, event);
+      return;
+    }
+  NS_ABORT_MSG_IF (ts < m_windowEnd,
+                   "MultithreadedSimulatorImpl::ScheduleWithContext(): the delay " <<
+                   delay << " to context " << context << " is shorter than the lookahead " <<
+                   GetLookahead ());
+  Message message;
+  message.lp = target;
+  message.context = context;
+  message.ts = ts;
+  message.event = event;
+  lp->outbox.push_back (message);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  LogicalProcess *lp = GetCurrent ();
+  Scheduler::EventKey key = Insert (lp, lp->currentTs, lp->currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrent ()->currentTs, 0xffffffff, 2);
+  std::lock_guard<std::mutex> lock (m_destroyMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrent ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrent ()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  LogicalProcess *lp = m_lps[GetLogicalProcess (id.GetContext ())];
+  NS_ASSERT_MSG (!m_parallel || lp == GetCurrent (),
+                 "MultithreadedSimulatorImpl::Remove(): Event of another logical process");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  lp->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  lp->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  NS_ASSERT_MSG (!m_parallel || id.GetUid () == 2 ||
+                 m_lps[GetLogicalProcess (id.GetContext ())] == GetCurrent (),
+                 "MultithreadedSimulatorImpl::Cancel(): Event of another logical process");
+  if (!IsExpired (id))
+    {
+      if (id.GetUid () != 2 && m_lps[GetLogicalProcess (id.GetContext ())]->events->HasFastRemove ())
+        {
+          // do not leave the cancelled event in the event list
+          Remove (id);
+        }
+      else
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay.GetTimeStep ());
+  NS_ASSERT_MSG (id.GetUid () != 2, "MultithreadedSimulatorImpl::Reschedule(): Destroy event");
+  NS_ASSERT_MSG (!IsExpired (id), "MultithreadedSimulatorImpl::Reschedule(): Expired event");
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Reschedule(): Negative delay");
+
+  LogicalProcess *lp = m_lps[GetLogicalProcess (id.GetContext ())];
+  NS_ASSERT_MSG (!m_parallel || lp == GetCurrent (),
+                 "MultithreadedSimulatorImpl::Reschedule(): Event of another logical process");
+  Scheduler::Event ev;
+  ev.impl = id.PeekEventImpl ();
+  ev.key.m_ts = id.GetTs ();
+  ev.key.m_context = id.GetContext ();
+  ev.key.m_uid = id.GetUid ();
+  Scheduler::EventKey key;
+  key.m_ts = GetCurrent ()->currentTs + delay.GetTimeStep ();
+  key.m_context = id.GetContext ();
+  key.m_uid = lp->uid;
+  lp->uid++;
+  lp->events->Reschedule (ev, key);
+  ev.impl->SetRescheduledUid (key.m_uid);
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  const LogicalProcess *lp = m_lps[GetLogicalProcess (id.GetContext ())];
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < lp->currentTs ||
+      (id.GetTs () == lp->currentTs &&
+       id.GetUid () <= lp->currentUid) ||
+      id.PeekEventImpl ()->IsStale (id.GetUid ()) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrent ()->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t eventCount = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); i++)
+    {
+      eventCount += (*i)->eventCount;
+    }
+  return eventCount;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  if (m_lookahead == NEVER)
+    {
+      return GetMaximumSimulationTime ();
+    }
+  return TimeStep (m_lookahead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNLogicalProcesses (void) const
+{
+  return m_lps.size () - 1;
+}
+
+} // namespace ns3
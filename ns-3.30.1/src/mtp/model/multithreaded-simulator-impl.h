@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/thread-pool.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup mtp
+ *
+ * \brief A conservative parallel simulator running the nodes of a
+ * single process in several threads.
+ *
+ * The nodes are partitioned into logical processes when the simulation
+ * first runs: the nodes connected by a channel belong to the same
+ * logical process, unless all the devices of the channel are point to
+ * point and the channel has a positive "Delay" attribute, or the channel
+ * has a positive "MinimumDelay" attribute, as the wireless channels
+ * (see YansWifiChannel and SpectrumChannel) whose nodes do not move or
+ * which are given a lower bound of their propagation delay.  Each logical
+ * process has its own event list, and the events are assigned to the
+ * logical process of the node given by their context.  The events without
+ * context and the events of the nodes created after the partitioning
+ * belong to a global logical process, which only runs when the other ones
+ * are stopped.
+ *
+ * The lookahead is the smallest delay, or minimum delay, of the channels
+ * connecting two logical processes.  The simulation advances by time
+ * windows, as in the YAWNS protocol: the logical processes run in
+ * parallel, on a ThreadPool, all their events earlier than the smallest
+ * event time plus the lookahead, and then exchange the events they
+ * scheduled for each other.
+ * Since all the logical processes live in the same address space, the
+ * events, and the packets they carry, are exchanged by pointer, without
+ * serialization.  The events of each logical process are run in the same
+ * order whatever the number of threads.
+ *
+ * Scheduling an event for another logical process with a delay shorter
+ * than the lookahead aborts the simulation.  An EventId can only be
+ * cancelled, removed, rescheduled or queried from the logical process of
+ * its event, which is asserted but for the queries.  Stop
+ * without delay takes effect at the end of the current time window,
+ * while Stop with a delay is exact.
+ *
+ * This implementation requires ns-3 to be configured with --enable-mtp,
+ * which makes the reference counts and the packet buffers shared by the
+ * threads thread-safe.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual EventId Reschedule (const EventId &id, const Time &delay);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * \returns The lookahead of the time windows, valid once the simulation ran.
+   */
+  Time GetLookahead (void) const;
+  /**
+   * \returns The number of logical processes the nodes are partitioned
+   *          into, without the global logical process.
+   */
+  uint32_t GetNLogicalProcesses (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled for another logical process during a time window. */
+  struct Message
+  {
+    uint32_t lp;       //!< the destination logical process
+    uint32_t context;  //!< the event context
+    uint64_t ts;       //!< the event timestamp
+    EventImpl *event;  //!< the event implementation
+  };
+
+  /** The event list and the clock of a logical process. */
+  struct LogicalProcess
+  {
+    Ptr<Scheduler> events;        //!< the event priority queue
+    uint64_t currentTs;           //!< timestamp of the current event
+    uint32_t currentContext;      //!< execution context of the current event
+    uint32_t currentUid;          //!< unique id of the current event
+    uint32_t uid;                 //!< next event unique id
+    uint64_t eventCount;          //!< the event count
+    int unscheduledEvents;        //!< inserted but not yet run events
+    std::vector<Message> outbox;  //!< the events scheduled for the other logical processes
+  };
+
+  /**
+   * Partition the nodes into logical processes, move the events already
+   * scheduled to their logical process and compute the lookahead.
+   */
+  void Partition (void);
+  /**
+   * \param [in] context An event context.
+   * \returns The index of the logical process running the events of \p context.
+   */
+  uint32_t GetLogicalProcess (uint32_t context) const;
+  /**
+   * \returns The logical process of the calling thread.
+   */
+  LogicalProcess * GetCurrent (void) const;
+  /**
+   * Insert an event in the event list of a logical process.
+   *
+   * \param [in] lp The logical process.
+   * \param [in] ts The event timestamp.
+   * \param [in] context The event context.
+   * \param [in] event The event implementation.
+   * \returns The event key.
+   */
+  Scheduler::EventKey Insert (LogicalProcess *lp, uint64_t ts, uint32_t context, EventImpl *event);
+  /**
+   * Run the next event of a logical process.
+   *
+   * \param [in] lp The logical process.
+   */
+  void ProcessOneEvent (LogicalProcess *lp);
+  /**
+   * Run the events of a range of logical processes up to the end of
+   * the current time window.
+   *
+   * \param [in] thread The index of the calling thread.
+   * \param [in] begin The first logical process, minus one.
+   * \param [in] end The past-the-end logical process, minus one.
+   */
+  void ProcessWindow (uint32_t thread, uint32_t begin, uint32_t end);
+  /** Move the events scheduled during the time window to their logical process. */
+  void DeliverMessages (void);
+  /**
+   * \returns The timestamp of the earliest event of all the logical
+   *          processes, or the largest timestamp if there is none.
+   */
+  uint64_t GetNextTs (void) const;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex protecting the destroy events. */
+  mutable std::mutex m_destroyMutex;
+
+  /** The logical processes, the first one being the global logical process. */
+  std::vector<LogicalProcess *> m_lps;
+  /** The logical process of each node, by node id. */
+  std::vector<uint32_t> m_contextLp;
+  /** Whether the nodes were partitioned. */
+  bool m_partitioned;
+  /** The factory of the event lists. */
+  ObjectFactory m_schedulerFactory;
+
+  /** The Lookahead attribute. */
+  Time m_lookaheadAttribute;
+  /** The lookahead in use, in time steps. */
+  uint64_t m_lookahead;
+  /** The MaxThreads attribute. */
+  uint32_t m_maxThreads;
+  /** The threads running the logical processes. */
+  ThreadPool m_threadPool;
+  /** Whether the logical processes are running in parallel. */
+  bool m_parallel;
+  /** The end of the current time window. */
+  uint64_t m_windowEnd;
+
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** The timestamp at which the simulation stops. */
+  uint64_t m_stopTs;
+  /** Mutex protecting the stop timestamp. */
+  std::mutex m_stopMutex;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/mac48-address.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-test mtp module tests
+ */
+
+/**
+ * \ingroup mtp-test
+ * \ingroup tests
+ *
+ * \brief Check that the packets forwarded around a ring of nodes are
+ * received at the same times by the default simulator and by the
+ * multithreaded simulator, whatever its number of threads.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** The time and the size of a received packet. */
+  typedef std::pair<int64_t, uint32_t> Reception;
+
+  /**
+   * Build the ring, run it with a simulator implementation and return the
+   * packets received by each node.
+   *
+   * \param [in] impl The simulator implementation type.
+   * \param [in] maxThreads The number of threads of the multithreaded simulator.
+   * \returns The packets received by each node, sorted.
+   */
+  std::vector<std::vector<Reception> > RunRing (std::string impl, uint32_t maxThreads);
+  /**
+   * Send a packet on a device.
+   *
+   * \param [in] device The device.
+   * \param [in] size The size of the packet.
+   */
+  void Send (Ptr<NetDevice> device, uint32_t size);
+  /**
+   * Record a received packet and forward it, one byte shorter, on the
+   * other device of the node.
+   *
+   * \param [in] device The receiving device.
+   * \param [in] packet The packet.
+   * \param [in] protocol The protocol number.
+   * \param [in] from The sender address.
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<NetDeviceContainer> m_devices;          //!< the two devices of each node
+  std::vector<std::vector<Reception> > m_receptions;  //!< the packets received by each node
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase ()
+  : TestCase ("Check that a ring of nodes runs the same with the default and the multithreaded simulators")
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), Mac48Address::GetBroadcast (), 0x800);
+}
+
+bool
+MultithreadedSimulatorTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                         uint16_t protocol, const Address &from)
+{
+  uint32_t node = device->GetNode ()->GetId ();
+  m_receptions[node].push_back (Reception (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+  if (packet->GetSize () > 1)
+    {
+      Ptr<NetDevice> other = m_devices[node].Get (0) == device ? m_devices[node].Get (1) : m_devices[node].Get (0);
+      Simulator::Schedule (MicroSeconds (node + 1), &MultithreadedSimulatorTestCase::Send, this,
+                           other, packet->GetSize () - 1);
+    }
+  return true;
+}
+
+std::vector<std::vector<MultithreadedSimulatorTestCase::Reception> >
+MultithreadedSimulatorTestCase::RunRing (std::string impl, uint32_t maxThreads)
+{
+  const uint32_t nNodes = 8;
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue (impl));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (maxThreads));
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  m_devices = std::vector<NetDeviceContainer> (nNodes);
+  m_receptions = std::vector<std::vector<Reception> > (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      uint32_t j = (i + 1) % nNodes;
+      SimpleNetDeviceHelper helper;
+      helper.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1 + i % 3)));
+      // the last link is not point to point, so that its nodes are merged
+      helper.SetNetDevicePointToPointMode (i != nNodes - 1);
+      NetDeviceContainer link = helper.Install (NodeContainer (nodes.Get (i), nodes.Get (j)));
+      m_devices[i].Add (link.Get (0));
+      m_devices[j].Add (link.Get (1));
+    }
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      for (uint32_t d = 0; d < 2; d++)
+        {
+          Ptr<NetDevice> device = m_devices[i].Get (d);
+          device->SetReceiveCallback (MakeCallback (&MultithreadedSimulatorTestCase::Receive, this));
+          Simulator::ScheduleWithContext (i, MicroSeconds (10 * i), &MultithreadedSimulatorTestCase::Send,
+                                          this, device, 64);
+        }
+    }
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> mtp = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (mtp != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (mtp->GetNLogicalProcesses (), nNodes - 1, "The last two nodes share a logical process");
+      NS_TEST_EXPECT_MSG_EQ (mtp->GetLookahead (), MilliSeconds (1), "The lookahead is the smallest delay");
+    }
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (Simulator::Now (), Seconds (1), "The simulation stopped in time");
+
+  Simulator::Destroy ();
+  m_devices.clear ();
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      std::sort (m_receptions[i].begin (), m_receptions[i].end ());
+    }
+  return m_receptions;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  std::vector<std::vector<Reception> > expected = RunRing ("ns3::DefaultSimulatorImpl", 0);
+  std::vector<std::vector<Reception> > single = RunRing ("ns3::MultithreadedSimulatorImpl", 1);
+  std::vector<std::vector<Reception> > multi = RunRing ("ns3::MultithreadedSimulatorImpl", 4);
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (0));
+
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < expected.size (); i++)
+    {
+      total += expected[i].size ();
+      NS_TEST_EXPECT_MSG_EQ ((single[i] == expected[i]), true, "Node " << i << " received other packets with one thread");
+      NS_TEST_EXPECT_MSG_EQ ((multi[i] == expected[i]), true, "Node " << i << " received other packets with four threads");
+    }
+  // every packet is forwarded until it is one byte long
+  NS_TEST_EXPECT_MSG_EQ (total, 2 * 8 * 64, "Every packet was received");
+}
+
+/**
+ * \ingroup mtp-test
+ * \ingroup tests
+ *
+ * \brief The multithreaded simulator TestSuite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator", UNIT)
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase, TestCase::QUICK);
+  }
+};
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mac48-address.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-test
+ * \ingroup tests
+ *
+ * \brief Check that the broadcasts of a line of static Wi-Fi nodes are
+ * received at the same times by the default simulator and by the
+ * multithreaded simulator, which runs every node in its own logical
+ * process.
+ */
+class MultithreadedWifiTestCase : public TestCase
+{
+public:
+  MultithreadedWifiTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** The time and the size of a received packet. */
+  typedef std::pair<int64_t, uint32_t> Reception;
+
+  /**
+   * Build the line of nodes, run it with a simulator implementation and
+   * return the packets received by each node.
+   *
+   * \param [in] impl The simulator implementation type.
+   * \param [in] maxThreads The number of threads of the multithreaded simulator.
+   * \returns The packets received by each node, sorted.
+   */
+  std::vector<std::vector<Reception> > RunLine (std::string impl, uint32_t maxThreads);
+  /**
+   * Broadcast a packet on a device.
+   *
+   * \param [in] device The device.
+   * \param [in] size The size of the packet.
+   */
+  void Send (Ptr<NetDevice> device, uint32_t size);
+  /**
+   * Record a received packet.
+   *
+   * \param [in] device The receiving device.
+   * \param [in] packet The packet.
+   * \param [in] protocol The protocol number.
+   * \param [in] from The sender address.
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<std::vector<Reception> > m_receptions;  //!< the packets received by each node
+};
+
+MultithreadedWifiTestCase::MultithreadedWifiTestCase ()
+  : TestCase ("Check that a line of Wi-Fi nodes runs the same with the default and the multithreaded simulators")
+{
+}
+
+void
+MultithreadedWifiTestCase::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), Mac48Address::GetBroadcast (), 0x800);
+}
+
+bool
+MultithreadedWifiTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                    uint16_t protocol, const Address &from)
+{
+  uint32_t node = device->GetNode ()->GetId ();
+  m_receptions[node].push_back (Reception (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+  return true;
+}
+
+std::vector<std::vector<MultithreadedWifiTestCase::Reception> >
+MultithreadedWifiTestCase::RunLine (std::string impl, uint32_t maxThreads)
+{
+  const uint32_t nNodes = 4;
+  const double spacing = 30.0;
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue (impl));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (maxThreads));
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      positions->Add (Vector (spacing * i, 0.0, 0.0));
+    }
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+
+  m_receptions = std::vector<std::vector<Reception> > (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<NetDevice> device = devices.Get (i);
+      device->SetReceiveCallback (MakeCallback (&MultithreadedWifiTestCase::Receive, this));
+      for (uint32_t j = 0; j < 10; j++)
+        {
+          // the nodes contend for the channel
+          Simulator::ScheduleWithContext (i, MilliSeconds (10 * j) + MicroSeconds (20 * i),
+                                          &MultithreadedWifiTestCase::Send, this, device, 100 + i);
+        }
+    }
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> mtp = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (mtp != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (mtp->GetNLogicalProcesses (), nNodes, "The Wi-Fi channel was not cut");
+      NS_TEST_EXPECT_MSG_EQ (mtp->GetLookahead (), Seconds (spacing / 299792458), "The lookahead is the smallest propagation delay");
+    }
+
+  Simulator::Destroy ();
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      std::sort (m_receptions[i].begin (), m_receptions[i].end ());
+    }
+  return m_receptions;
+}
+
+void
+MultithreadedWifiTestCase::DoRun (void)
+{
+  std::vector<std::vector<Reception> > expected = RunLine ("ns3::DefaultSimulatorImpl", 0);
+  std::vector<std::vector<Reception> > single = RunLine ("ns3::MultithreadedSimulatorImpl", 1);
+  std::vector<std::vector<Reception> > multi = RunLine ("ns3::MultithreadedSimulatorImpl", 4);
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (0));
+
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < expected.size (); i++)
+    {
+      total += expected[i].size ();
+      NS_TEST_EXPECT_MSG_EQ ((single[i] == expected[i]), true, "Node " << i << " received other packets with one thread");
+      NS_TEST_EXPECT_MSG_EQ ((multi[i] == expected[i]), true, "Node " << i << " received other packets with four threads");
+    }
+  NS_TEST_EXPECT_MSG_GT (total, 0u, "No packet was received");
+}
+
+/**
+ * \ingroup mtp-test
+ * \ingroup tests
+ *
+ * \brief The multithreaded simulator Wi-Fi TestSuite.
+ */
+class MultithreadedWifiTestSuite : public TestSuite
+{
+public:
+  MultithreadedWifiTestSuite ()
+    : TestSuite ("multithreaded-simulator-wifi", UNIT)
+  {
+    AddTestCase (new MultithreadedWifiTestCase, TestCase::QUICK);
+  }
+};
+
+static MultithreadedWifiTestSuite g_multithreadedWifiTestSuite; //!< Static variable for test initialization
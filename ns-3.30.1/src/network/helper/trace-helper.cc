@@ -40,6 +40,13 @@ PcapHelper::PcapHelper ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+PcapHelper::PcapHelper (Ptr<PcapNgFile> file, std::string interfaceName)
+  : m_ngFile (file),
+    m_ngInterfaceName (interfaceName)
+{
+  NS_LOG_FUNCTION (file << interfaceName);
+}
+
 PcapHelper::~PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +63,14 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  if (m_ngFile != 0)
+    {
+      file->Open (m_ngFile, m_ngInterfaceName);
+      file->Init (dataLinkType, snapLen, tzCorrection);
+      NS_ABORT_MSG_IF (file->Fail (), "Unable to Init interface " << m_ngInterfaceName);
+      return file;
+    }
+
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -208,6 +223,21 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, bool compress)
+{
+  NS_LOG_FUNCTION (filename << compress);
+
+  Ptr<BinaryTraceWriter> writer = Create<BinaryTraceWriter> (filename, compress);
+  NS_ABORT_MSG_IF (writer->Fail (), "AsciiTraceHelper::CreateBinaryFileStream():  " <<
+                   "Unable to Open " << filename);
+  //
+  // As with CreateFileStream, the stream object keeps the writer alive, and
+  // the last block of the file is written when the writer is destroyed.
+  //
+  return Create<OutputStreamWrapper> (writer);
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -310,6 +340,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('+', Simulator::Now (), "", p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +353,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('+', Simulator::Now (), " " + context, p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +378,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('d', Simulator::Now (), "", p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +391,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('d', Simulator::Now (), " " + context, p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +417,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('-', Simulator::Now (), "", p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +430,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('-', Simulator::Now (), " " + context, p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +453,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('r', Simulator::Now (), "", p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,6 +466,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('r', Simulator::Now (), " " + context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -441,6 +519,78 @@ PcapHelperForDevice::EnablePcapAll (std::string prefix, bool promiscuous)
   EnablePcap (prefix, NodeContainer::GetGlobal (), promiscuous);
 }
 
+void
+PcapHelperForDevice::EnablePcapNg (std::string filename, NetDeviceContainer d, bool promiscuous)
+{
+  Ptr<PcapNgFile> file = Create<PcapNgFile> ();
+  file->Open (filename);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename);
+
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      Ptr<NetDevice> dev = *i;
+      Ptr<Node> node = dev->GetNode ();
+      std::string nodename = Names::FindName (node);
+      std::string devicename = Names::FindName (dev);
+
+      std::ostringstream oss;
+      if (nodename.size ())
+        {
+          oss << nodename;
+        }
+      else
+        {
+          oss << node->GetId ();
+        }
+      oss << "-";
+      if (devicename.size ())
+        {
+          oss << devicename;
+        }
+      else
+        {
+          oss << dev->GetIfIndex ();
+        }
+
+      //
+      // The devices create their pcap files with the PcapHelper returned by
+      // GetPcapHelper, which makes them interfaces of the pcapng file.  The
+      // file is closed when the last of them is destroyed.
+      //
+      m_ngFile = file;
+      m_ngInterfaceName = oss.str ();
+      EnablePcapInternal (filename, dev, promiscuous, true);
+    }
+  m_ngFile = 0;
+  m_ngInterfaceName = "";
+}
+
+PcapHelper
+PcapHelperForDevice::GetPcapHelper (void) const
+{
+  if (m_ngFile != 0)
+    {
+      return PcapHelper (m_ngFile, m_ngInterfaceName);
+    }
+  return PcapHelper ();
+}
+
+void
+PcapHelperForDevice::EnablePcapNgAll (std::string filename, bool promiscuous)
+{
+  NetDeviceContainer devs;
+  NodeContainer n = NodeContainer::GetGlobal ();
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          devs.Add (node->GetDevice (j));
+        }
+    }
+  EnablePcapNg (filename, devs, promiscuous);
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, uint32_t nodeid, uint32_t deviceid, bool promiscuous)
 {
@@ -65,6 +65,16 @@ public:
    */
   PcapHelper ();
 
+  /**
+   * @brief Create a pcap helper whose CreateFile ignores the file name and
+   * mode it is given and returns a wrapper writing to a new interface of a
+   * pcapng file.
+   *
+   * @param file the pcapng file
+   * @param interfaceName name of the interfaces created in the pcapng file
+   */
+  PcapHelper (Ptr<PcapNgFile> file, std::string interfaceName);
+
   /**
    * @brief Destroy a pcap helper.
    */
@@ -109,6 +119,7 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -141,6 +152,9 @@ private:
    * @see DefaultSink
    */
   static void SinkWithHeader (Ptr<PcapFileWrapper> file, const Header& header, Ptr<const Packet> p);
+
+  Ptr<PcapNgFile> m_ngFile;      //!< pcapng file written by the files created, if any
+  std::string m_ngInterfaceName; //!< name of the interfaces created in m_ngFile
 };
 
 template <typename T> void
@@ -222,6 +236,21 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create a stream object writing a binary trace file.
+   *
+   * The default trace sinks of this class write the events they receive to
+   * the BinaryTraceWriter of the returned stream object, instead of text
+   * lines; the text written to the stream itself is discarded.  The file can
+   * be read with a BinaryTraceReader, or converted to the ascii trace it
+   * replaces with the binary-trace-to-ascii program.
+   *
+   * @param filename file name
+   * @param compress whether the blocks of the file are compressed
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename, bool compress = true);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -632,6 +661,46 @@ public:
    * @param promiscuous If true capture all possible packets available at the device.
    */
   void EnablePcapAll (std::string prefix, bool promiscuous = false);
+
+  /**
+   * @brief Enable pcap output on each device in the container which is of the
+   * appropriate type, in a single pcapng file holding one interface per device.
+   *
+   * The interfaces are named after the node and the device, like the files
+   * created by EnablePcap.  The write buffer of the file is set from the
+   * attributes of ns3::PcapFileWrapper.
+   *
+   * @param filename Name of the pcapng file.
+   * @param d container of devices
+   * @param promiscuous If true capture all possible packets available at the device.
+   */
+  void EnablePcapNg (std::string filename, NetDeviceContainer d, bool promiscuous = false);
+
+  /**
+   * @brief Enable pcap output on each device (which is of the appropriate type)
+   * in the set of all nodes created in the simulation, in a single pcapng file.
+   *
+   * @param filename Name of the pcapng file.
+   * @param promiscuous If true capture all possible packets available at the device.
+   *
+   * @see EnablePcapNg
+   */
+  void EnablePcapNgAll (std::string filename, bool promiscuous = false);
+
+protected:
+  /**
+   * @brief Get the pcap helper creating the files of EnablePcapInternal.
+   *
+   * While EnablePcapNg enables the devices, the helper creates interfaces
+   * of its pcapng file, and pcap files otherwise.
+   *
+   * @returns the pcap helper
+   */
+  PcapHelper GetPcapHelper (void) const;
+
+private:
+  Ptr<PcapNgFile> m_ngFile;      //!< pcapng file of the devices being enabled by EnablePcapNg, if any
+  std::string m_ngInterfaceName; //!< name of the interface of the device being enabled in m_ngFile
 };
 
 /**
@@ -42,6 +42,12 @@ Header::GetTypeId (void)
   return tid;
 }
 
+bool
+Header::IsSelfContained (void) const
+{
+  return false;
+}
+
 std::ostream & operator << (std::ostream &os, const Header &header)
 {
   header.Print (os);
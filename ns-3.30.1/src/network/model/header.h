@@ -101,6 +101,19 @@ public:
    * i.e.: (field1 val1 field2 val2 field3 val3) field4 val4 field5 val5
    */
   virtual void Print (std::ostream &os) const = 0;
+  /**
+   * \returns true if the bytes written by Serialize depend only on the
+   *          fields of this header, and Deserialize restores these fields,
+   *          false otherwise.
+   *
+   * Packet::AddHeader keeps a copy of the self-contained headers and
+   * defers their serialization until the packet bytes are needed, and
+   * Packet::RemoveHeader and Packet::PeekHeader return that copy when
+   * the header type matches.  A header whose serialization reads the
+   * bytes following it, for example to compute a checksum or a length
+   * over the payload, must not override this method.
+   */
+  virtual bool IsSelfContained (void) const;
 };
 
 
@@ -26,6 +26,7 @@
 #include "ns3/assert.h"
 #include "node-list.h"
 #include "node.h"
+#include "packet-arena.h"
 
 namespace ns3 {
 
@@ -145,6 +146,8 @@ NodeListPriv::Delete (void)
   NS_LOG_FUNCTION_NOARGS ();
   Config::UnregisterRootNamespaceObject (Get ());
   (*DoGet ()) = 0;
+  // the nodes released their packets when they were disposed
+  PacketArena::Trim ();
 }
 
 
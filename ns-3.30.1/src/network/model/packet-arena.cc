@@ -0,0 +1,357 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "packet-arena.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#ifdef NS3_MTP
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace {
+
+/// log2 of the size of the smallest size class
+const uint32_t MIN_CLASS_SHIFT = 5;
+/// number of size classes, from 32 bytes to 64 KiB
+const uint32_t N_CLASSES = 12;
+/// size of the largest size class
+const uint32_t MAX_BLOCK_SIZE = 1U << (MIN_CLASS_SHIFT + N_CLASSES - 1);
+/// size of the slabs the blocks are carved from
+const uint32_t SLAB_SIZE = 65536;
+/// size of the header of the slabs, which keeps the blocks aligned
+const uint32_t SLAB_HEADER_SIZE = 32;
+
+/**
+ * \ingroup packet
+ * \brief A free block, linked to the next free block of its size class
+ */
+struct FreeBlock
+{
+  FreeBlock *next; //!< the next free block
+};
+
+/**
+ * \ingroup packet
+ * \brief The header of a slab, linked to the previously allocated slab
+ */
+struct Slab
+{
+  Slab *next;            //!< the previously allocated slab
+  uint32_t blockSize;    //!< the size of the blocks carved out of the slab
+  uint32_t freeBlocks;   //!< the number of free blocks of the slab, counted by Trim
+  uint32_t carvedBlocks; //!< the number of blocks carved out of the slab, counted by Trim
+  bool current;          //!< whether a size class still carves blocks out of the slab
+};
+
+/**
+ * \ingroup packet
+ * \brief The blocks of a size class
+ *
+ * The free lists only contain plain pointers, so that they are
+ * initialized before any static constructor runs and never destroyed.
+ */
+struct SizeClass
+{
+  FreeBlock *freeBlocks; //!< the free blocks
+  Slab *slab;            //!< the current slab
+  uint8_t *slabCursor;   //!< the next block of the current slab
+  uint32_t slabBlocks;   //!< the number of blocks left in the current slab
+};
+
+#ifdef NS3_MTP
+/// A counter shared by the threads
+typedef std::atomic<uint64_t> Counter;
+// per thread, for the multithreaded simulator
+thread_local SizeClass g_classes[N_CLASSES]; //!< the size classes
+std::mutex g_slabMutex; //!< protects the list of slabs
+#else
+/// A counter
+typedef uint64_t Counter;
+SizeClass g_classes[N_CLASSES]; //!< the size classes
+#endif
+Slab *g_slabs = 0;  //!< all the slabs, until they are given back by Trim
+
+Counter g_livePackets (0);        //!< number of packets alive
+Counter g_liveBlocks (0);         //!< number of blocks alive
+Counter g_liveBytes (0);          //!< size of the blocks alive
+Counter g_allocations (0);        //!< number of blocks allocated
+Counter g_systemAllocations (0);  //!< number of calls to the system allocator
+Counter g_slabBytes (0);          //!< memory held by the slabs
+/// time of the last reset of the counters
+std::chrono::steady_clock::time_point g_resetTime = std::chrono::steady_clock::now ();
+
+/**
+ * \param size the size of a request, at most MAX_BLOCK_SIZE
+ * \returns the size class of the request
+ */
+inline uint32_t
+GetClass (uint32_t size)
+{
+  uint32_t sizeClass = 0;
+  for (uint32_t s = (size - 1) >> MIN_CLASS_SHIFT; s != 0; s >>= 1)
+    {
+      sizeClass++;
+    }
+  return sizeClass;
+}
+
+/**
+ * \param blockSize the size of the blocks of a size class
+ * \returns the size of the slabs of the size class, without their header
+ */
+inline uint32_t
+GetSlabSize (uint32_t blockSize)
+{
+  return blockSize < SLAB_SIZE ? SLAB_SIZE : blockSize;
+}
+
+/**
+ * Carve a new slab for a size class.
+ *
+ * \param sizeClass the size class
+ * \param blockSize the size of the blocks of the size class
+ */
+void
+AllocateSlab (SizeClass &sizeClass, uint32_t blockSize)
+{
+  uint32_t slabSize = GetSlabSize (blockSize);
+  uint8_t *buffer = static_cast<uint8_t *> (std::malloc (SLAB_HEADER_SIZE + slabSize));
+  if (buffer == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  Slab *slab = reinterpret_cast<Slab *> (buffer);
+  slab->blockSize = blockSize;
+  slab->current = true;
+  {
+#ifdef NS3_MTP
+    std::lock_guard<std::mutex> lock (g_slabMutex);
+#endif
+    slab->next = g_slabs;
+    g_slabs = slab;
+    if (sizeClass.slab != 0)
+      {
+        sizeClass.slab->current = false;
+      }
+  }
+  sizeClass.slab = slab;
+  sizeClass.slabCursor = buffer + SLAB_HEADER_SIZE;
+  sizeClass.slabBlocks = slabSize / blockSize;
+  g_systemAllocations++;
+  g_slabBytes += SLAB_HEADER_SIZE + slabSize;
+}
+
+} // anonymous namespace
+
+namespace ns3 {
+
+uint32_t
+PacketArena::GetBlockSize (uint32_t size)
+{
+  if (size > MAX_BLOCK_SIZE)
+    {
+      return size;
+    }
+  return (1U << MIN_CLASS_SHIFT) << GetClass (size == 0 ? 1 : size);
+}
+
+void *
+PacketArena::Allocate (uint32_t size)
+{
+  g_allocations++;
+  g_liveBlocks++;
+  if (size > MAX_BLOCK_SIZE)
+    {
+      g_liveBytes += size;
+      g_systemAllocations++;
+      void *block = std::malloc (size);
+      if (block == 0)
+        {
+          throw std::bad_alloc ();
+        }
+      return block;
+    }
+  uint32_t index = GetClass (size == 0 ? 1 : size);
+  uint32_t blockSize = (1U << MIN_CLASS_SHIFT) << index;
+  g_liveBytes += blockSize;
+  SizeClass &sizeClass = g_classes[index];
+  FreeBlock *block = sizeClass.freeBlocks;
+  if (block != 0)
+    {
+      sizeClass.freeBlocks = block->next;
+      return block;
+    }
+  if (sizeClass.slabBlocks == 0)
+    {
+      AllocateSlab (sizeClass, blockSize);
+    }
+  uint8_t *buffer = sizeClass.slabCursor;
+  sizeClass.slabCursor += blockSize;
+  sizeClass.slabBlocks--;
+  return buffer;
+}
+
+void
+PacketArena::Deallocate (void *block, uint32_t size)
+{
+  NS_ASSERT (block != 0);
+  g_liveBlocks--;
+  if (size > MAX_BLOCK_SIZE)
+    {
+      g_liveBytes -= size;
+      std::free (block);
+      return;
+    }
+  uint32_t index = GetClass (size == 0 ? 1 : size);
+  g_liveBytes -= (1U << MIN_CLASS_SHIFT) << index;
+  SizeClass &sizeClass = g_classes[index];
+  FreeBlock *freeBlock = static_cast<FreeBlock *> (block);
+  freeBlock->next = sizeClass.freeBlocks;
+  sizeClass.freeBlocks = freeBlock;
+}
+
+void
+PacketArena::NotifyPacketCreated (void)
+{
+  g_livePackets++;
+}
+
+void
+PacketArena::NotifyPacketDestroyed (void)
+{
+  g_livePackets--;
+}
+
+struct PacketArena::Statistics
+PacketArena::GetStatistics (void)
+{
+  struct Statistics statistics;
+  statistics.livePackets = g_livePackets;
+  statistics.liveBlocks = g_liveBlocks;
+  statistics.liveBytes = g_liveBytes;
+  statistics.allocations = g_allocations;
+  statistics.systemAllocations = g_systemAllocations;
+  statistics.slabBytes = g_slabBytes;
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - g_resetTime;
+  statistics.allocationRate = elapsed.count () > 0 ? statistics.allocations / elapsed.count () : 0;
+  return statistics;
+}
+
+void
+PacketArena::ResetStatistics (void)
+{
+  g_allocations = 0;
+  g_systemAllocations = 0;
+  g_resetTime = std::chrono::steady_clock::now ();
+}
+
+uint64_t
+PacketArena::Trim (void)
+{
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (g_slabMutex);
+#endif
+  // the slabs sorted by address, to find the slab of each free block
+  std::vector<Slab *> slabs;
+  for (Slab *slab = g_slabs; slab != 0; slab = slab->next)
+    {
+      slab->freeBlocks = 0;
+      // the blocks of a slab still carved by another thread are unknown
+      slab->carvedBlocks = slab->current ? ~0U : GetSlabSize (slab->blockSize) / slab->blockSize;
+      slabs.push_back (slab);
+    }
+  std::sort (slabs.begin (), slabs.end ());
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      SizeClass &sizeClass = g_classes[i];
+      if (sizeClass.slab != 0)
+        {
+          Slab *slab = sizeClass.slab;
+          slab->carvedBlocks = GetSlabSize (slab->blockSize) / slab->blockSize - sizeClass.slabBlocks;
+        }
+      for (FreeBlock *block = sizeClass.freeBlocks; block != 0; block = block->next)
+        {
+          std::vector<Slab *>::iterator it = std::upper_bound (slabs.begin (), slabs.end (),
+                                                               reinterpret_cast<Slab *> (block));
+          NS_ASSERT (it != slabs.begin ());
+          (*(it - 1))->freeBlocks++;
+        }
+    }
+
+  // drop the blocks of the slabs given back from the free lists
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      SizeClass &sizeClass = g_classes[i];
+      FreeBlock **prev = &sizeClass.freeBlocks;
+      while (*prev != 0)
+        {
+          Slab *slab = *(std::upper_bound (slabs.begin (), slabs.end (),
+                                           reinterpret_cast<Slab *> (*prev)) - 1);
+          if (slab->freeBlocks == slab->carvedBlocks)
+            {
+              *prev = (*prev)->next;
+            }
+          else
+            {
+              prev = &(*prev)->next;
+            }
+        }
+      if (sizeClass.slab != 0 && sizeClass.slab->freeBlocks == sizeClass.slab->carvedBlocks)
+        {
+          sizeClass.slab = 0;
+          sizeClass.slabCursor = 0;
+          sizeClass.slabBlocks = 0;
+        }
+    }
+
+  uint64_t released = 0;
+  Slab **prev = &g_slabs;
+  while (*prev != 0)
+    {
+      Slab *slab = *prev;
+      if (slab->freeBlocks == slab->carvedBlocks)
+        {
+          *prev = slab->next;
+          released += SLAB_HEADER_SIZE + GetSlabSize (slab->blockSize);
+          std::free (slab);
+        }
+      else
+        {
+          prev = &slab->next;
+        }
+    }
+  g_slabBytes -= released;
+  return released;
+}
+
+std::ostream &
+operator << (std::ostream &os, const PacketArena::Statistics &statistics)
+{
+  os << "live packets=" << statistics.livePackets
+     << " live blocks=" << statistics.liveBlocks
+     << " live bytes=" << statistics.liveBytes
+     << " allocations=" << statistics.allocations
+     << " system allocations=" << statistics.systemAllocations
+     << " slab bytes=" << statistics.slabBytes
+     << " allocations/s=" << statistics.allocationRate;
+  return os;
+}
+
+} // namespace ns3
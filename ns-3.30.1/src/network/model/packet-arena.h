@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PACKET_ARENA_H
+#define PACKET_ARENA_H
+
+#include <stdint.h>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Slab allocator of the storage of the packets
+ *
+ * The byte buffers (see ns3::Buffer), the metadata (see
+ * ns3::PacketMetadata) and the tags (see ns3::ByteTagList and
+ * ns3::PacketTagList) of the packets are allocated from this arena.
+ * The requests are rounded up to a power-of-two size class, from 32 bytes
+ * to 64 KiB, and each size class recycles its blocks through a free list.
+ * New blocks are carved out of slabs of 64 KiB, so that a simulation in
+ * steady state does not call the system allocator at all, and otherwise
+ * calls it once for many blocks.  The larger requests are passed to the
+ * system allocator.
+ *
+ * The slabs whose blocks are all free are given back to the system by
+ * Trim, which is called when the simulator is destroyed; the other slabs
+ * stay reachable from the arena.  When ns-3 is configured with
+ * --enable-mtp, each thread has its own free lists, and a block freed by
+ * another thread than the one which allocated it goes to the free list
+ * of the former.
+ *
+ * The arena keeps counters of its use, returned by GetStatistics.
+ */
+class PacketArena
+{
+public:
+  /**
+   * \brief The counters of the arena
+   */
+  struct Statistics
+  {
+    uint64_t livePackets;     //!< number of ns3::Packet instances alive
+    uint64_t liveBlocks;      //!< number of blocks allocated and not deallocated
+    uint64_t liveBytes;       //!< size of the blocks allocated and not deallocated, in bytes
+    uint64_t allocations;     //!< number of blocks allocated since the last reset
+    uint64_t systemAllocations; //!< number of calls to the system allocator since the last reset
+    uint64_t slabBytes;       //!< memory held by the slabs, in bytes
+    double allocationRate;    //!< blocks allocated per second of wall-clock time since the last reset
+  };
+
+  /**
+   * \brief Allocate a block
+   * \param size the size of the block, in bytes
+   * \returns the block, of at least GetBlockSize (size) bytes
+   */
+  static void *Allocate (uint32_t size);
+  /**
+   * \brief Deallocate a block
+   * \param block the block
+   * \param size the size requested for the block, or any size with the
+   *        same GetBlockSize
+   */
+  static void Deallocate (void *block, uint32_t size);
+  /**
+   * \param size the size of a request, in bytes
+   * \returns the size of the block allocated for the request, in bytes
+   */
+  static uint32_t GetBlockSize (uint32_t size);
+
+  /**
+   * \brief Count a new ns3::Packet
+   */
+  static void NotifyPacketCreated (void);
+  /**
+   * \brief Count a destroyed ns3::Packet
+   */
+  static void NotifyPacketDestroyed (void);
+
+  /**
+   * \returns the counters of the arena
+   */
+  static struct Statistics GetStatistics (void);
+  /**
+   * \brief Reset the allocation counters and the allocation rate
+   *
+   * The counters of live packets, blocks and bytes are not reset.
+   */
+  static void ResetStatistics (void);
+
+  /**
+   * \brief Give back to the system the slabs whose blocks are all free
+   *
+   * Under --enable-mtp, only the free lists of the calling thread are
+   * looked at, and this must only be called while no other thread uses
+   * the arena.
+   *
+   * \returns the memory given back to the system, in bytes
+   */
+  static uint64_t Trim (void);
+};
+
+/**
+ * \brief Stream insertion operator.
+ *
+ * \param [in] os The reference to the output stream.
+ * \param [in] statistics The counters of the arena.
+ * \returns The reference to the output stream.
+ */
+std::ostream & operator << (std::ostream &os, const PacketArena::Statistics &statistics);
+
+} // namespace ns3
+
+#endif /* PACKET_ARENA_H */
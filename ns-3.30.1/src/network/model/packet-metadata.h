@@ -23,6 +23,9 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -413,7 +416,11 @@ private:
    */
   struct Data {
     /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /** size (in bytes) of m_data buffer below */
     uint16_t m_size;
     /** max of the m_used field over all objects which
@@ -494,16 +501,6 @@ private:
     uint64_t packetUid;
   };
 
-  /**
-   * \brief Class to hold all the metadata
-   */
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   /// Friend class
   friend class ItemIterator;
 
@@ -597,6 +594,17 @@ public:
    * \param n space to reserve
    */
   void ReserveCopy (uint32_t n);
+  /**
+   * \brief Check whether the shared data may not be extended in place
+   *
+   * The data shared with other PacketMetadata instances can only be
+   * extended if no other instance already wrote past the used area.
+   * With the multithreaded simulator, another thread may do so at any
+   * time, so the shared data is never extended in place.
+   *
+   * \returns true if the used area must be copied before being extended
+   */
+  inline bool IsSharedDirty (void) const;
 
   /**
    * \brief Get the total size used by the metadata
@@ -661,7 +669,6 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -672,8 +679,13 @@ public:
    */
   static bool m_metadataSkipped;
 
+#ifdef NS3_MTP
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
+  static thread_local uint16_t m_chunkUid; //!< Chunk Uid
+#else
   static uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
   struct Data *m_data; //!< Metadata storage
   /*
@@ -722,8 +734,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           PacketMetadata::Recycle (m_data);
         }
@@ -737,11 +748,19 @@ PacketMetadata::operator = (PacketMetadata const& o)
   m_packetUid = o.m_packetUid;
   return *this;
 }
+bool
+PacketMetadata::IsSharedDirty (void) const
+{
+#ifdef NS3_MTP
+  return true;
+#else
+  return m_used != m_data->m_dirtyEnd;
+#endif
+}
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       PacketMetadata::Recycle (m_data);
     }
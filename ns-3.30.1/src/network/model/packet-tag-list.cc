@@ -43,14 +43,25 @@ PacketTagList::CreateTagData (size_t dataSize)
                  << " exceeds maximum "
                  << std::numeric_limits<decltype(TagData::size)>::max () );
 
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+  void * p = PacketArena::Allocate (sizeof (TagData) + dataSize - 1);
+  // The matching frees are in RemoveAll, RemoveWriter and ReleaseMerge
 
   TagData * tag = new (p) TagData;
   tag->size = dataSize;
   return tag;
 }
 
+void
+PacketTagList::ReleaseMerge (struct TagData * cur)
+{
+  while (cur != 0 && --cur->count == 0)
+    {
+      struct TagData * next = cur->next;
+      FreeTagData (cur);
+      cur = next;
+    }
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -149,7 +160,6 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
     {
       NS_ASSERT (cur != 0);
       NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
       struct TagData * copy = CreateTagData (cur->size);
       copy->tid = cur->tid;
       copy->count = 1;
@@ -157,6 +167,7 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
       memcpy (copy->data, cur->data, copy->size);
       copy->next = cur->next;             // merge into tail
       copy->next->count++;                // mark new merge
+      ReleaseMerge (cur);                 // unmerge cur
       *prevNext = copy;                   // point prior list at copy
       prevNext = &copy->next;             // advance
       cur      =  copy->next;
@@ -194,19 +205,18 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      FreeTagData (cur);
     }
   else
     {
       // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
       if (cur->next != 0)
         {
           // there's a next, so make it a merge
           cur->next->count++;
         }
+      // unmerge cur, since we linked around it already
+      ReleaseMerge (cur);
     }
   return found;
 }
@@ -241,7 +251,6 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
     {
       // cur is always a merge at this point
       // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
       struct TagData * copy = CreateTagData (tag.GetSerializedSize ());
       copy->tid = tag.GetInstanceTypeId ();
       copy->count = 1;
@@ -251,6 +260,7 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
         {
           copy->next->count++;          // mark new merge
         }
+      ReleaseMerge (cur);               // unmerge cur
       *prevNext = copy;                 // point prior list at copy
     }
   return found;
@@ -27,7 +27,11 @@
 
 #include <stdint.h>
 #include <ostream>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "ns3/type-id.h"
+#include "packet-arena.h"
 
 namespace ns3 {
 
@@ -141,7 +145,11 @@ public:
   struct TagData
   {
     struct TagData * next;      /**< Pointer to next in list */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; /**< Number of incoming links */
+#else
     uint32_t count;             /**< Number of incoming links */
+#endif
     TypeId tid;                 /**< Type of the tag serialized into #data */
     uint32_t size;              /**< Size of the \c data buffer */
     uint8_t data[1];            /**< Serialization buffer */
@@ -228,6 +236,24 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /**
+   * Destroy a TagData struct and give its storage back to the PacketArena.
+   *
+   * \param [in] tag The TagData to free.
+   */
+  static inline
+  void FreeTagData (struct TagData * tag);
+  /**
+   * Drop the incoming link of a merge which was linked around.
+   *
+   * The other lists sharing the merge may be dropping their links at the
+   * same time in another thread of the multithreaded simulator, in which
+   * case the last link dropped deletes the merge and its tail.
+   *
+   * \param [in] cur The merge.
+   */
+  static
+  void ReleaseMerge (struct TagData * cur);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -323,6 +349,14 @@ PacketTagList::operator = (PacketTagList const &o)
   return *this;
 }
 
+void
+PacketTagList::FreeTagData (struct TagData * tag)
+{
+  uint32_t size = sizeof (TagData) + tag->size - 1;
+  tag->~TagData ();
+  PacketArena::Deallocate (tag, size);
+}
+
 PacketTagList::~PacketTagList ()
 {
   RemoveAll ();
@@ -334,22 +368,19 @@ PacketTagList::RemoveAll (void)
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
-      cur->count--;
-      if (cur->count > 0) 
+      if (--cur->count > 0) 
         {
           break;
         }
       if (prev != 0) 
         {
-          prev->~TagData ();
-          std::free (prev);
+          FreeTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      prev->~TagData ();
-      std::free (prev);
+      FreeTagData (prev);
     }
   m_next = 0;
 }
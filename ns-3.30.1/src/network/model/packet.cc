@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "packet.h"
+#include "packet-arena.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -28,7 +29,11 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Packet::m_globalUid (0);
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -136,22 +141,32 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
-    m_nixVector (0)
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, 0),
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0)
 {
-  m_globalUid++;
+  PacketArena::NotifyPacketCreated ();
 }
 
 Packet::Packet (const Packet &o)
   : m_buffer (o.m_buffer),
     m_byteTagList (o.m_byteTagList),
     m_packetTagList (o.m_packetTagList),
-    m_metadata (o.m_metadata)
+    m_metadata (o.m_metadata),
+    m_headers (o.m_headers),
+    m_headersSize (o.m_headersSize)
 {
+  PacketArena::NotifyPacketCreated ();
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
 }
 
+Packet::~Packet ()
+{
+  PacketArena::NotifyPacketDestroyed ();
+}
+
 Packet &
 Packet::operator = (const Packet &o)
 {
@@ -163,6 +178,8 @@ Packet::operator = (const Packet &o)
   m_byteTagList = o.m_byteTagList;
   m_packetTagList = o.m_packetTagList;
   m_metadata = o.m_metadata;
+  m_headers = o.m_headers;
+  m_headersSize = o.m_headersSize;
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy () 
     : m_nixVector = 0;
   return *this;
@@ -178,18 +195,23 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0)
 {
-  m_globalUid++;
+  PacketArena::NotifyPacketCreated ();
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
     m_byteTagList (),
     m_packetTagList (),
     m_metadata (0,0),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0)
 {
+  PacketArena::NotifyPacketCreated ();
   NS_ASSERT (magic);
   Deserialize (buffer, size);
 }
@@ -204,10 +226,12 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0)
 {
-  m_globalUid++;
+  PacketArena::NotifyPacketCreated ();
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -219,14 +243,18 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_byteTagList (byteTagList),
     m_packetTagList (packetTagList),
     m_metadata (metadata),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0)
 {
+  PacketArena::NotifyPacketCreated ();
 }
 
 Ptr<Packet>
 Packet::CreateFragment (uint32_t start, uint32_t length) const
 {
   NS_LOG_FUNCTION (this << start << length);
+  SerializeHeaders ();
   Buffer buffer = m_buffer.CreateFragment (start, length);
   ByteTagList byteTagList = m_byteTagList;
   byteTagList.Adjust (-start);
@@ -252,11 +280,76 @@ Packet::GetNixVector (void) const
   return m_nixVector;
 } 
 
+Packet::LazyHeader::~LazyHeader ()
+{
+}
+
+void *
+Packet::LazyHeader::operator new (size_t size)
+{
+  return PacketArena::Allocate (size);
+}
+
+void
+Packet::LazyHeader::operator delete (void *p, size_t size)
+{
+  PacketArena::Deallocate (p, size);
+}
+
+void
+Packet::PushHeader (Ptr<LazyHeader> header)
+{
+  const Header &h = header->GetHeader ();
+  uint32_t size = h.GetSerializedSize ();
+  NS_LOG_FUNCTION (this << h.GetInstanceTypeId ().GetName () << size);
+  m_byteTagList.Adjust (size);
+  m_byteTagList.AddAtStart (size);
+  m_metadata.AddHeader (h, size);
+  header->m_size = size;
+  header->m_next = m_headers;
+  m_headers = header;
+  m_headersSize += size;
+}
+
+uint32_t
+Packet::PopHeader (void)
+{
+  uint32_t size = m_headers->m_size;
+  NS_LOG_FUNCTION (this << m_headers->GetHeader ().GetInstanceTypeId ().GetName () << size);
+  m_byteTagList.Adjust (-size);
+  m_metadata.RemoveHeader (m_headers->GetHeader (), size);
+  m_headersSize -= size;
+  m_headers = m_headers->m_next;
+  return size;
+}
+
+void
+Packet::SerializeHeaders (void) const
+{
+  if (m_headers == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_headersSize);
+  // the byte tags and the metadata already account for the headers
+  Packet *self = const_cast<Packet *> (this);
+  self->m_buffer.AddAtStart (m_headersSize);
+  Buffer::Iterator i = self->m_buffer.Begin ();
+  for (const LazyHeader *header = PeekPointer (m_headers); header != 0; header = PeekPointer (header->m_next))
+    {
+      header->GetHeader ().Serialize (i);
+      i.Next (header->m_size);
+    }
+  self->m_headers = 0;
+  self->m_headersSize = 0;
+}
+
 void
 Packet::AddHeader (const Header &header)
 {
   uint32_t size = header.GetSerializedSize ();
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  SerializeHeaders ();
   m_buffer.AddAtStart (size);
   m_byteTagList.Adjust (size);
   m_byteTagList.AddAtStart (size);
@@ -266,6 +359,7 @@ Packet::AddHeader (const Header &header)
 uint32_t
 Packet::RemoveHeader (Header &header, uint32_t size)
 {
+  SerializeHeaders ();
   Buffer::Iterator end;
   end = m_buffer.Begin ();
   end.Next (size);
@@ -279,6 +373,7 @@ Packet::RemoveHeader (Header &header, uint32_t size)
 uint32_t
 Packet::RemoveHeader (Header &header)
 {
+  SerializeHeaders ();
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtStart (deserialized);
@@ -289,6 +384,7 @@ Packet::RemoveHeader (Header &header)
 uint32_t
 Packet::PeekHeader (Header &header) const
 {
+  SerializeHeaders ();
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -296,6 +392,7 @@ Packet::PeekHeader (Header &header) const
 uint32_t
 Packet::PeekHeader (Header &header, uint32_t size) const
 {
+  SerializeHeaders ();
   Buffer::Iterator end;
   end = m_buffer.Begin ();
   end.Next (size);
@@ -317,6 +414,10 @@ Packet::AddTrailer (const Trailer &trailer)
 uint32_t
 Packet::RemoveTrailer (Trailer &trailer)
 {
+  if (m_buffer.GetSize () < trailer.GetSerializedSize ())
+    {
+      SerializeHeaders ();
+    }
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtEnd (deserialized);
@@ -326,6 +427,10 @@ Packet::RemoveTrailer (Trailer &trailer)
 uint32_t
 Packet::PeekTrailer (Trailer &trailer)
 {
+  if (m_buffer.GetSize () < trailer.GetSerializedSize ())
+    {
+      SerializeHeaders ();
+    }
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -335,6 +440,7 @@ void
 Packet::AddAtEnd (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet << packet->GetSize ());
+  packet->SerializeHeaders ();
   m_byteTagList.AddAtEnd (GetSize ());
   ByteTagList copy = packet->m_byteTagList;
   copy.AddAtStart (0);
@@ -355,6 +461,10 @@ void
 Packet::RemoveAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  if (m_buffer.GetSize () < size)
+    {
+      SerializeHeaders ();
+    }
   m_buffer.RemoveAtEnd (size);
   m_metadata.RemoveAtEnd (size);
 }
@@ -362,6 +472,7 @@ void
 Packet::RemoveAtStart (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  SerializeHeaders ();
   m_buffer.RemoveAtStart (size);
   m_byteTagList.Adjust (-size);
   m_metadata.RemoveAtStart (size);
@@ -377,12 +488,14 @@ Packet::RemoveAllByteTags (void)
 uint32_t 
 Packet::CopyData (uint8_t *buffer, uint32_t size) const
 {
+  SerializeHeaders ();
   return m_buffer.CopyData (buffer, size);
 }
 
 void
 Packet::CopyData (std::ostream *os, uint32_t size) const
 {
+  SerializeHeaders ();
   return m_buffer.CopyData (os, size);
 }
 
@@ -433,6 +546,7 @@ Packet::ToString() const
 void 
 Packet::Print (std::ostream &os) const
 {
+  SerializeHeaders ();
   PacketMetadata::ItemIterator i = m_metadata.BeginItem (m_buffer);
   while (i.HasNext ())
     {
@@ -565,6 +679,7 @@ Packet::Print (std::ostream &os) const
 PacketMetadata::ItemIterator 
 Packet::BeginItem (void) const
 {
+  SerializeHeaders ();
   return m_metadata.BeginItem (m_buffer);
 }
 
@@ -584,6 +699,7 @@ Packet::EnableChecking (void)
 
 uint32_t Packet::GetSerializedSize (void) const
 {
+  SerializeHeaders ();
   uint32_t size = 0;
 
   if (m_nixVector)
@@ -627,6 +743,7 @@ uint32_t Packet::GetSerializedSize (void) const
 uint32_t 
 Packet::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
+  SerializeHeaders ();
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
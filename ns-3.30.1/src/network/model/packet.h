@@ -21,6 +21,11 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <typeinfo>
+#include <type_traits>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -29,6 +34,7 @@
 #include "byte-tag-list.h"
 #include "packet-tag-list.h"
 #include "nix-vector.h"
+#include "packet-arena.h"
 #include "ns3/mac48-address.h"
 #include "ns3/callback.h"
 #include "ns3/assert.h"
@@ -242,6 +248,10 @@ public:
    * \param o object to copy
    */
   Packet (const Packet &o);
+  /**
+   * \brief Destructor
+   */
+  ~Packet ();
   /**
    * \brief Basic assignment
    * \param o object to copy
@@ -356,6 +366,40 @@ public:
    * \returns the number of bytes read from the packet.
    */
   uint32_t PeekHeader (Header &header, uint32_t size) const;
+  /**
+   * \brief Add header to this packet, deferring its serialization.
+   *
+   * If the header is self-contained (see Header::IsSelfContained), the
+   * packet keeps a copy of it and serializes it only when its bytes are
+   * needed, for example to copy, fragment or print the packet.  The
+   * other headers are serialized at once, as by AddHeader (const Header &).
+   *
+   * \param header a reference to the header to add to this packet.
+   */
+  template <typename T>
+  void AddHeader (const T &header);
+  /**
+   * \brief Remove the header from the front of this packet.
+   *
+   * If the front of the packet is a header of the same type which was
+   * not serialized yet, the header is copied instead of deserialized.
+   *
+   * \param header a reference to the header to remove from the packet.
+   * \returns the number of bytes removed from the packet.
+   */
+  template <typename T>
+  uint32_t RemoveHeader (T &header);
+  /**
+   * \brief Read but does _not_ remove the header from the front of this packet.
+   *
+   * If the front of the packet is a header of the same type which was
+   * not serialized yet, the header is copied instead of deserialized.
+   *
+   * \param header a reference to the header to read from the packet.
+   * \returns the number of bytes read from the packet.
+   */
+  template <typename T>
+  uint32_t PeekHeader (T &header) const;
   /**
    * \brief Add trailer to this packet.
    *
@@ -779,6 +823,140 @@ private:
    */
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  /**
+   * \brief A header added to the packet but not serialized yet.
+   *
+   * The unserialized headers of a packet form a list, from the outermost
+   * header to the innermost one, which is shared by the copies of the
+   * packet and is never modified once shared.
+   */
+  class LazyHeader : public SimpleRefCount<LazyHeader>
+  {
+public:
+    virtual ~LazyHeader ();
+    /**
+     * \returns the header.
+     */
+    virtual const Header & GetHeader (void) const = 0;
+    /**
+     * \brief Allocate a header from the packet arena.
+     * \param size the size of the header object
+     * \returns the memory of the header object
+     */
+    static void * operator new (size_t size);
+    /**
+     * \brief Free a header to the packet arena.
+     * \param p the memory of the header object
+     * \param size the size of the header object
+     */
+    static void operator delete (void *p, size_t size);
+
+    Ptr<LazyHeader> m_next; //!< the next header, towards the payload
+    uint32_t m_size;        //!< the serialized size of the header
+  };
+
+  /**
+   * \brief A header of type T added to the packet but not serialized yet.
+   */
+  template <typename T>
+  class LazyHeaderImpl : public LazyHeader
+  {
+public:
+    /**
+     * \brief Whether headers of type T can be kept unserialized.
+     */
+#ifdef NS3_MTP
+    // const accessors of packets shared by several threads would have
+    // to serialize the headers concurrently
+    typedef std::false_type Supported;
+#else
+    typedef std::integral_constant<bool, std::is_copy_constructible<T>::value
+                                   && std::is_copy_assignable<T>::value> Supported;
+#endif
+    /**
+     * \brief Constructor
+     * \param header the header to copy
+     */
+    LazyHeaderImpl (const T &header)
+      : m_header (header)
+    {
+    }
+    virtual const Header & GetHeader (void) const
+    {
+      return m_header;
+    }
+    T m_header; //!< the header
+  };
+
+  /**
+   * \brief Add a self-contained header at the front of the packet,
+   * if possible without serializing it.
+   * \param header the header
+   */
+  template <typename T>
+  void DoAddHeader (const T &header, std::true_type);
+  /**
+   * \brief Add a header at the front of the packet.
+   * \param header the header
+   */
+  template <typename T>
+  void DoAddHeader (const T &header, std::false_type);
+  /**
+   * \brief Remove the header at the front of the packet, if possible
+   * without deserializing it.
+   * \param header the header
+   * \returns the number of bytes removed
+   */
+  template <typename T>
+  uint32_t DoRemoveHeader (T &header, std::true_type);
+  /**
+   * \brief Remove the header at the front of the packet.
+   * \param header the header
+   * \returns the number of bytes removed
+   */
+  template <typename T>
+  uint32_t DoRemoveHeader (T &header, std::false_type);
+  /**
+   * \brief Read the header at the front of the packet, if possible
+   * without deserializing it.
+   * \param header the header
+   * \returns the number of bytes read
+   */
+  template <typename T>
+  uint32_t DoPeekHeader (T &header, std::true_type) const;
+  /**
+   * \brief Read the header at the front of the packet.
+   * \param header the header
+   * \returns the number of bytes read
+   */
+  template <typename T>
+  uint32_t DoPeekHeader (T &header, std::false_type) const;
+  /**
+   * \brief Check whether the front of the packet is an unserialized
+   * header of type T.
+   * \param header the header to read or remove
+   * \returns the unserialized header, or 0
+   */
+  template <typename T>
+  const T * GetLazyHeader (const T &header) const;
+  /**
+   * \brief Add an unserialized header at the front of the packet.
+   * \param header the header
+   */
+  void PushHeader (Ptr<LazyHeader> header);
+  /**
+   * \brief Remove the unserialized header at the front of the packet.
+   * \returns the size of the header
+   */
+  uint32_t PopHeader (void);
+  /**
+   * \brief Serialize the headers not serialized yet in the packet buffer.
+   *
+   * This method is const because it does not change the content of
+   * the packet, only its representation.
+   */
+  void SerializeHeaders (void) const;
+
   Buffer m_buffer;                //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
@@ -787,7 +965,14 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+  Ptr<LazyHeader> m_headers;  //!< the headers not serialized yet, the outermost first
+  uint32_t m_headersSize;     //!< the size of the headers not serialized yet
+
+#ifdef NS3_MTP
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
   static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -833,6 +1018,12 @@ std::ostream& operator<< (std::ostream& os, const Packet &packet);
  *   - ns3::Packet::RemoveAtEnd
  *   - ns3::Packet::CopyData
  *
+ * The self-contained headers (see ns3::Header::IsSelfContained) added
+ * by the template ns3::Packet::AddHeader are not serialized in the
+ * buffer until the packet bytes are accessed, so that adding such a
+ * header and removing it later costs two copies of the header object
+ * instead of a serialization and a deserialization.
+ *
  * Dirty operations will always be slower than non-dirty operations,
  * sometimes by several orders of magnitude. However, even the
  * dirty operations have been optimized for common use-cases which
@@ -851,7 +1042,103 @@ namespace ns3 {
 uint32_t 
 Packet::GetSize (void) const
 {
-  return m_buffer.GetSize ();
+  return m_buffer.GetSize () + m_headersSize;
+}
+
+template <typename T>
+void
+Packet::AddHeader (const T &header)
+{
+  DoAddHeader (header, typename LazyHeaderImpl<T>::Supported ());
+}
+
+template <typename T>
+uint32_t
+Packet::RemoveHeader (T &header)
+{
+  return DoRemoveHeader (header, typename LazyHeaderImpl<T>::Supported ());
+}
+
+template <typename T>
+uint32_t
+Packet::PeekHeader (T &header) const
+{
+  return DoPeekHeader (header, typename LazyHeaderImpl<T>::Supported ());
+}
+
+template <typename T>
+void
+Packet::DoAddHeader (const T &header, std::true_type)
+{
+  // a subclass of T would be sliced by the copy
+  if (typeid (header) == typeid (T) && header.IsSelfContained ())
+    {
+      PushHeader (Ptr<LazyHeader> (new LazyHeaderImpl<T> (header), false));
+    }
+  else
+    {
+      AddHeader (static_cast<const Header &> (header));
+    }
+}
+
+template <typename T>
+void
+Packet::DoAddHeader (const T &header, std::false_type)
+{
+  AddHeader (static_cast<const Header &> (header));
+}
+
+template <typename T>
+uint32_t
+Packet::DoRemoveHeader (T &header, std::true_type)
+{
+  const T *lazy = GetLazyHeader (header);
+  if (lazy == 0)
+    {
+      return RemoveHeader (static_cast<Header &> (header));
+    }
+  header = *lazy;
+  return PopHeader ();
+}
+
+template <typename T>
+uint32_t
+Packet::DoRemoveHeader (T &header, std::false_type)
+{
+  return RemoveHeader (static_cast<Header &> (header));
+}
+
+template <typename T>
+uint32_t
+Packet::DoPeekHeader (T &header, std::true_type) const
+{
+  const T *lazy = GetLazyHeader (header);
+  if (lazy == 0)
+    {
+      return PeekHeader (static_cast<Header &> (header));
+    }
+  header = *lazy;
+  return m_headers->m_size;
+}
+
+template <typename T>
+uint32_t
+Packet::DoPeekHeader (T &header, std::false_type) const
+{
+  return PeekHeader (static_cast<Header &> (header));
+}
+
+template <typename T>
+const T *
+Packet::GetLazyHeader (const T &header) const
+{
+  if (m_headers == 0
+      || typeid (header) != typeid (T)
+      || typeid (m_headers->GetHeader ()) != typeid (T))
+    {
+      return 0;
+    }
+  return &static_cast<const LazyHeaderImpl<T> *> (PeekPointer (m_headers))->m_header;
 }
 
 } // namespace ns3
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <fstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/binary-trace.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the ascii trace converted from a binary trace is
+ * identical to the ascii trace written by the default trace sinks.
+ */
+class BinaryTraceTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param compress whether the blocks of the binary trace are compressed
+   */
+  BinaryTraceTestCase (bool compress);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write a packet through the default trace sinks.
+   * \param i the index of the packet
+   */
+  void Send (uint32_t i);
+  /**
+   * \param filename the name of a file
+   * \return the size of the file
+   */
+  uint64_t GetFileSize (std::string filename);
+
+  bool m_compress;                     //!< whether the blocks are compressed
+  Ptr<OutputStreamWrapper> m_ascii;    //!< the ascii trace
+  Ptr<OutputStreamWrapper> m_binary;   //!< the binary trace
+};
+
+BinaryTraceTestCase::BinaryTraceTestCase (bool compress)
+  : TestCase (compress ? "Check a compressed binary trace" : "Check an uncompressed binary trace"),
+    m_compress (compress)
+{
+}
+
+void
+BinaryTraceTestCase::Send (uint32_t i)
+{
+  Ptr<Packet> p = Create<Packet> (i % 1500);
+  EthernetHeader header;
+  header.SetLengthType (i);
+  p->AddHeader (header);
+  std::ostringstream context;
+  context << "/NodeList/" << i % 7 << "/DeviceList/0/TxQueue/Enqueue";
+
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (m_ascii, context.str (), p);
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (m_binary, context.str (), p);
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (m_ascii, p);
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (m_binary, p);
+  if (i % 3 == 0)
+    {
+      AsciiTraceHelper::DefaultDropSinkWithContext (m_ascii, context.str (), p);
+      AsciiTraceHelper::DefaultDropSinkWithContext (m_binary, context.str (), p);
+    }
+  AsciiTraceHelper::DefaultReceiveSinkWithoutContext (m_ascii, p);
+  AsciiTraceHelper::DefaultReceiveSinkWithoutContext (m_binary, p);
+}
+
+uint64_t
+BinaryTraceTestCase::GetFileSize (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary | std::ios::ate);
+  return file.tellg ();
+}
+
+void
+BinaryTraceTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+  std::string asciiName = CreateTempDirFilename ("trace.tr");
+  std::string binaryName = CreateTempDirFilename ("trace.nstr");
+
+  AsciiTraceHelper helper;
+  m_ascii = helper.CreateFileStream (asciiName);
+  m_binary = helper.CreateBinaryFileStream (binaryName, m_compress);
+  NS_TEST_ASSERT_MSG_NE (m_binary->GetBinaryWriter (), 0, "The stream must hold a binary writer");
+
+  //
+  // Enough packets for several blocks, some of them sent at the same time.
+  //
+  const uint32_t nPackets = 2000;
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (i - i % 2), &BinaryTraceTestCase::Send, this, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_ascii = 0;
+  m_binary = 0;
+
+  BinaryTraceReader reader;
+  reader.Open (binaryName);
+  NS_TEST_ASSERT_MSG_EQ (reader.Fail (), false, "Open (" << binaryName << ") returns error");
+  std::ostringstream converted;
+  uint32_t nRecords = 0;
+  while (reader.Next ())
+    {
+      if (nRecords == 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (reader.GetType (), '+', "Unexpected type of the first record");
+          NS_TEST_EXPECT_MSG_EQ (reader.GetTime (), MicroSeconds (0), "Unexpected time of the first record");
+          NS_TEST_EXPECT_MSG_EQ (reader.GetLabel (), " /NodeList/0/DeviceList/0/TxQueue/Enqueue",
+                                 "Unexpected label of the first record");
+          NS_TEST_EXPECT_MSG_EQ (reader.GetPacketSize (), 14, "Unexpected packet size of the first record");
+        }
+      reader.PrintAscii (converted);
+      nRecords++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (reader.Fail (), false, "The file must be read to its end");
+  NS_TEST_EXPECT_MSG_EQ (nRecords, 3 * nPackets + (nPackets + 2) / 3, "Unexpected number of records");
+
+  std::ifstream ascii (asciiName.c_str ());
+  std::ostringstream expected;
+  expected << ascii.rdbuf ();
+  NS_TEST_EXPECT_MSG_EQ ((converted.str () == expected.str ()), true, "The converted trace differs from the ascii trace");
+
+  uint64_t binarySize = GetFileSize (binaryName);
+  NS_TEST_EXPECT_MSG_GT (binarySize, 2 * BinaryTraceWriter::BLOCK_SIZE, "The file must hold several blocks");
+  if (m_compress)
+    {
+      NS_TEST_EXPECT_MSG_LT (binarySize * 4, GetFileSize (asciiName), "The compressed trace is too large");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_LT (binarySize, GetFileSize (asciiName), "The binary trace is larger than the ascii trace");
+    }
+
+  // the failed writes of the writer thread are reported
+  if (std::ifstream ("/dev/full").good ())
+    {
+      BinaryTraceWriter full ("/dev/full", m_compress);
+      full.SetAsync (true);
+      for (uint32_t i = 0; i < nPackets; ++i)
+        {
+          full.Write ('+', MicroSeconds (i), " /NodeList/0/DeviceList/0/TxQueue/Enqueue", Create<Packet> (i % 1500));
+        }
+      full.Flush ();
+      NS_TEST_EXPECT_MSG_EQ (full.Fail (), true, "The failed writes of the writer thread are not reported");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace TestSuite
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceTestCase (false), TestCase::QUICK);
+  AddTestCase (new BinaryTraceTestCase (true), TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite binaryTraceTestSuite; //!< Static variable for test initialization
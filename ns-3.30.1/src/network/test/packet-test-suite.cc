@@ -19,11 +19,13 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/packet-arena.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
 #include <string>
 #include <cstdarg>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <ctime>
@@ -289,6 +291,58 @@ public:
 
 };
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Self-contained test header, carrying a 16-bit value
+ *
+ * \note Class internal to packet-test-suite.cc
+ */
+class ALazyTestHeader : public Header
+{
+public:
+  /**
+   * Constructor
+   * \param value The value of the header
+   */
+  ALazyTestHeader (uint16_t value = 0) : Header (), m_value (value) {}
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("anon::ALazyTestHeader")
+      .SetParent<Header> ()
+      .SetGroupName ("Network")
+      .HideFromDocumentation ()
+      .AddConstructor<ALazyTestHeader> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const {
+    return 2;
+  }
+  virtual void Serialize (Buffer::Iterator iter) const {
+    iter.WriteHtonU16 (m_value);
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator iter) {
+    m_value = iter.ReadNtohU16 ();
+    return 2;
+  }
+  virtual void Print (std::ostream &os) const {
+    os << "value=" << m_value;
+  }
+  virtual bool IsSelfContained (void) const {
+    return true;
+  }
+  uint16_t m_value; //!< The value of the header
+};
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1035,6 +1089,181 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Unserialized headers unit tests.
+ */
+class PacketLazyHeaderTest : public TestCase
+{
+public:
+  PacketLazyHeaderTest ();
+private:
+  void DoRun (void);
+};
+
+PacketLazyHeaderTest::PacketLazyHeaderTest ()
+  : TestCase ("Packet lazy headers")
+{
+}
+
+void
+PacketLazyHeaderTest::DoRun (void)
+{
+  Ptr<Packet> p = Create<Packet> (10);
+  ATestTag<1> tag;
+  p->AddByteTag (tag);
+  p->AddHeader (ALazyTestHeader (0x1234));
+  p->AddHeader (ALazyTestHeader (0x5678));
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 14, "Unserialized headers not counted");
+  ByteTagIterator i = p->GetByteTagIterator ();
+  NS_TEST_ASSERT_MSG_EQ (i.HasNext (), true, "Byte tag lost");
+  NS_TEST_EXPECT_MSG_EQ (i.Next ().GetStart (), 4, "Byte tag not moved by the headers");
+
+  // the copies share the unserialized headers
+  Ptr<Packet> copy = p->Copy ();
+  ALazyTestHeader header;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (header), 2, "Wrong peeked size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x5678, "Wrong peeked header");
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (header), 2, "Wrong removed size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x5678, "Wrong removed header");
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 12, "Header not removed");
+  NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 14, "Copy changed by the removal");
+
+  // the bytes are the same as with serialized headers
+  Ptr<Packet> serialized = Create<Packet> (10);
+  serialized->AddHeader (static_cast<const Header &> (ALazyTestHeader (0x1234)));
+  serialized->AddHeader (static_cast<const Header &> (ALazyTestHeader (0x5678)));
+  ATestTrailer<3> trailer;
+  serialized->AddTrailer (trailer);
+  copy->AddTrailer (trailer);
+  uint8_t expected[17];
+  uint8_t actual[17];
+  serialized->CopyData (expected, 17);
+  copy->CopyData (actual, 17);
+  NS_TEST_EXPECT_MSG_EQ (expected[0], 0x56, "Header not serialized");
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (expected, actual, 17), 0, "Wrong serialized headers");
+
+  // a header of another type reads the bytes of the unserialized header
+  ATestHeader<2> other;
+  p->AddHeader (ALazyTestHeader (0x0202));
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (other), 2, "Wrong removed size");
+  NS_TEST_EXPECT_MSG_EQ (other.m_error, false, "Wrong bytes");
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (header), 2, "Wrong removed size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x1234, "Wrong deserialized header");
+
+  // a fragment covers the unserialized headers
+  p->AddHeader (ALazyTestHeader (0x9abc));
+  Ptr<Packet> fragment = p->CreateFragment (0, 2);
+  NS_TEST_EXPECT_MSG_EQ (fragment->RemoveHeader (header), 2, "Wrong removed size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x9abc, "Wrong fragment");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PacketArena unit tests.
+ */
+class PacketArenaTest : public TestCase
+{
+public:
+  PacketArenaTest ();
+private:
+  void DoRun (void);
+};
+
+PacketArenaTest::PacketArenaTest ()
+  : TestCase ("PacketArena")
+{
+}
+
+void
+PacketArenaTest::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (0), 32, "Smallest size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (32), 32, "Exact size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (33), 64, "Rounded up size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (1500), 2048, "Rounded up size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (65536), 65536, "Largest size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (65537), 65537, "Larger than the size classes");
+
+  // a freed block is the next one allocated in its size class
+  void *block = PacketArena::Allocate (100);
+  PacketArena::Deallocate (block, 100);
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::Allocate (120), block, "Block not recycled");
+  PacketArena::Deallocate (block, 120);
+
+  PacketArena::Statistics before = PacketArena::GetStatistics ();
+  {
+    Ptr<Packet> p = Create<Packet> (1000);
+    Ptr<Packet> copy = p->Copy ();
+    ATestTag<1> tag;
+    copy->AddPacketTag (tag);
+    copy->AddByteTag (tag);
+    PacketArena::Statistics during = PacketArena::GetStatistics ();
+    NS_TEST_EXPECT_MSG_EQ (during.livePackets, before.livePackets + 2, "Live packets not counted");
+    NS_TEST_EXPECT_MSG_GT (during.liveBlocks, before.liveBlocks, "Live blocks not counted");
+    NS_TEST_EXPECT_MSG_GT (during.liveBytes, before.liveBytes, "Live bytes not counted");
+    NS_TEST_EXPECT_MSG_GT (during.allocations, before.allocations, "Allocations not counted");
+  }
+  PacketArena::Statistics after = PacketArena::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (after.livePackets, before.livePackets, "Packets leaked");
+  NS_TEST_EXPECT_MSG_EQ (after.liveBlocks, before.liveBlocks, "Blocks leaked");
+  NS_TEST_EXPECT_MSG_EQ (after.liveBytes, before.liveBytes, "Bytes leaked");
+
+  // in steady state, the packets do not call the system allocator
+  for (uint32_t i = 0; i < 1001; i++)
+    {
+      if (i == 1)
+        {
+          PacketArena::ResetStatistics ();
+        }
+      Ptr<Packet> p = Create<Packet> (1000);
+      ATestHeader<10> header;
+      p->AddHeader (header);
+      ATestTag<2> tag;
+      p->AddPacketTag (tag);
+    }
+  PacketArena::Statistics steady = PacketArena::GetStatistics ();
+  NS_TEST_EXPECT_MSG_GT (steady.allocations, 1000, "Allocations not counted");
+  NS_TEST_EXPECT_MSG_EQ (steady.systemAllocations, 0, "Blocks not recycled");
+
+  // a large packet does not make the later small packets large
+  {
+    Ptr<Packet> large = Create<Packet> (300000);
+  }
+  before = PacketArena::GetStatistics ();
+  {
+    Ptr<Packet> small = Create<Packet> (100);
+    PacketArena::Statistics during = PacketArena::GetStatistics ();
+    NS_TEST_EXPECT_MSG_LT (during.liveBytes - before.liveBytes, 4096, "Small packet sized after a large one");
+  }
+
+  // the slabs whose blocks are all free are given back to the system
+  uint8_t bytes[] = {1, 2, 3, 4};
+  Ptr<Packet> kept = Create<Packet> (bytes, 4);
+  std::vector<void *> blocks;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      blocks.push_back (PacketArena::Allocate (16384));
+    }
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      PacketArena::Deallocate (blocks[i], 16384);
+    }
+  uint64_t slabBytes = PacketArena::GetStatistics ().slabBytes;
+  uint64_t released = PacketArena::Trim ();
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (released, 65536, "Free slabs not given back");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStatistics ().slabBytes, slabBytes - released, "Slab bytes not updated");
+  uint8_t copied[4];
+  kept->CopyData (copied, 4);
+  NS_TEST_EXPECT_MSG_EQ (memcmp (copied, bytes, 4), 0, "Live packet corrupted by Trim");
+  kept = Create<Packet> (1000);
+  NS_TEST_EXPECT_MSG_EQ (kept->GetSize (), 1000, "Packet not allocated after Trim");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1052,6 +1281,8 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketLazyHeaderTest, TestCase::QUICK);
+  AddTestCase (new PacketArenaTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -21,10 +21,13 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <fstream>
+#include <algorithm>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcapng-file.h"
 
 using namespace ns3;
 
@@ -1144,6 +1147,253 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \param filename the file name
+ * \return the content of the file
+ */
+static std::string
+ReadFileContent (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the Pcap File Object writes the same
+ * file with and without a write buffer.
+ */
+class WriteBufferTestCase : public TestCase
+{
+public:
+  WriteBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write the test packets to a file.
+   * \param filename the file name
+   * \param bufferSize the size of the write buffer
+   * \param async whether the buffers are written from the writer thread
+   */
+  void WriteFile (std::string filename, uint32_t bufferSize, bool async);
+};
+
+WriteBufferTestCase::WriteBufferTestCase ()
+  : TestCase ("Check to see that PcapFile::SetWriteBuffer does not change the file written")
+{
+}
+
+void
+WriteBufferTestCase::WriteFile (std::string filename, uint32_t bufferSize, bool async)
+{
+  uint8_t data[200];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i;
+    }
+
+  PcapFile f;
+  f.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  f.SetWriteBuffer (bufferSize, async);
+  f.Init (1, 128);
+
+  for (uint32_t i = 0; i < 500; ++i)
+    {
+      f.Write (i, 2 * i, data, i % sizeof (data));
+    }
+
+  //
+  // The last records are still in the write buffer.
+  //
+  uint32_t written = ReadFileContent (filename).size ();
+  f.Flush ();
+  if (bufferSize > 0)
+    {
+      NS_TEST_EXPECT_MSG_LT (written, ReadFileContent (filename).size (), "Records written before the file is flushed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Write must not fail");
+  f.Close ();
+}
+
+void
+WriteBufferTestCase::DoRun (void)
+{
+  std::string unbuffered = CreateTempDirFilename ("unbuffered.pcap");
+  std::string buffered = CreateTempDirFilename ("buffered.pcap");
+  std::string async = CreateTempDirFilename ("async.pcap");
+  WriteFile (unbuffered, 0, false);
+  WriteFile (buffered, 1000, false);
+  WriteFile (async, 1000, true);
+
+  std::string expected = ReadFileContent (unbuffered);
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileContent (buffered) == expected), true, "Buffered file differs");
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileContent (async) == expected), true, "Asynchronously written file differs");
+
+  //
+  // The packets must have been truncated to the snap length.
+  //
+  PcapFile f;
+  f.Open (async, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << async << ", \"std::ios::in\") returns error");
+  uint8_t data[200];
+  for (uint32_t i = 0; i < 500; ++i)
+    {
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      f.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Read must not fail");
+      NS_TEST_EXPECT_MSG_EQ (tsSec, i, "Unexpected timestamp");
+      NS_TEST_EXPECT_MSG_EQ (tsUsec, 2 * i, "Unexpected timestamp");
+      NS_TEST_EXPECT_MSG_EQ (origLen, i % 200, "Unexpected original length");
+      NS_TEST_EXPECT_MSG_EQ (inclLen, std::min<uint32_t> (i % 200, 128), "Unexpected included length");
+    }
+  f.Close ();
+
+  //
+  // The failed writes of the writer thread must be reported.
+  //
+  if (std::ifstream ("/dev/full").good ())
+    {
+      PcapFile full;
+      full.Open ("/dev/full", std::ios::out);
+      full.SetWriteBuffer (1000, true);
+      full.Init (1, 128);
+      for (uint32_t i = 0; i < 500; ++i)
+        {
+          full.Write (i, 2 * i, data, i % sizeof (data));
+        }
+      full.Flush ();
+      NS_TEST_EXPECT_MSG_EQ (full.Fail (), true, "The failed writes of the writer thread are not reported");
+      full.Close ();
+    }
+
+  remove (unbuffered.c_str ());
+  remove (buffered.c_str ());
+  remove (async.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the PcapNg File Object writes the
+ * blocks of the pcapng format.
+ */
+class PcapNgWriteTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param async whether the buffers are written from the writer thread
+   */
+  PcapNgWriteTestCase (bool async);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param content the file content
+   * \param offset the offset of the value
+   * \return the 32 bit value at offset
+   */
+  uint32_t Get32 (std::string const &content, uint32_t offset);
+
+  bool m_async; //!< whether the buffers are written from the writer thread
+};
+
+PcapNgWriteTestCase::PcapNgWriteTestCase (bool async)
+  : TestCase (std::string ("Check to see that PcapNgFile writes the expected blocks")
+              + (async ? " from the writer thread" : "")),
+    m_async (async)
+{
+}
+
+uint32_t
+PcapNgWriteTestCase::Get32 (std::string const &content, uint32_t offset)
+{
+  uint32_t value = 0;
+  if (offset + 4 <= content.size ())
+    {
+      std::memcpy (&value, content.data () + offset, 4);
+    }
+  return value;
+}
+
+void
+PcapNgWriteTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("interfaces.pcapng");
+  uint8_t data[100];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i;
+    }
+
+  PcapNgFile f;
+  f.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+  f.SetWriteBuffer (m_async ? 64 : 0, m_async);
+  NS_TEST_EXPECT_MSG_EQ (f.AddInterface (105, 65535, "0-1"), 0, "Unexpected interface index");
+  NS_TEST_EXPECT_MSG_EQ (f.AddInterface (1, 8, ""), 1, "Unexpected interface index");
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      f.Write (i % 2, 5000000000ULL + i, data, 10 + i);
+    }
+  f.Close ();
+
+  std::string content = ReadFileContent (filename);
+  remove (filename.c_str ());
+
+  //
+  // Section header block, with the byte order magic.
+  //
+  NS_TEST_ASSERT_MSG_EQ (Get32 (content, 0), 0x0a0d0d0a, "Missing section header block");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (content, 4), 28, "Unexpected section header block length");
+  NS_TEST_EXPECT_MSG_EQ (Get32 (content, 8), 0x1a2b3c4d, "Unexpected byte order magic");
+  NS_TEST_EXPECT_MSG_EQ (Get32 (content, 24), 28, "Unexpected section header block trailing length");
+
+  //
+  // Interface description blocks, with the name option of the first one.
+  //
+  uint32_t offset = 28;
+  NS_TEST_ASSERT_MSG_EQ (Get32 (content, offset), 1, "Missing interface description block");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (content, offset + 4), 40, "Unexpected interface description block length");
+  NS_TEST_EXPECT_MSG_EQ ((Get32 (content, offset + 8) & 0xffff), 105, "Unexpected data link type");
+  NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 12), 65535, "Unexpected snap length");
+  NS_TEST_EXPECT_MSG_EQ (content.substr (offset + 20, 3), "0-1", "Unexpected interface name");
+  NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 36), 40, "Unexpected interface description block trailing length");
+  offset += 40;
+  NS_TEST_ASSERT_MSG_EQ (Get32 (content, offset), 1, "Missing interface description block");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (content, offset + 4), 32, "Unexpected interface description block length");
+  NS_TEST_EXPECT_MSG_EQ ((Get32 (content, offset + 8) & 0xffff), 1, "Unexpected data link type");
+  NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 12), 8, "Unexpected snap length");
+  offset += 32;
+
+  //
+  // Enhanced packet blocks, truncated to the snap length of their interface.
+  //
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      uint32_t inclLen = (i % 2) ? 8 : 10 + i;
+      uint32_t blockLen = 32 + (inclLen + 3) / 4 * 4;
+      NS_TEST_ASSERT_MSG_EQ (Get32 (content, offset), 6, "Missing enhanced packet block");
+      NS_TEST_ASSERT_MSG_EQ (Get32 (content, offset + 4), blockLen, "Unexpected enhanced packet block length");
+      NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 8), i % 2, "Unexpected interface index");
+      NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 12), 1, "Unexpected timestamp");
+      NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 16), 705032704 + i, "Unexpected timestamp");
+      NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 20), inclLen, "Unexpected captured length");
+      NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + 24), 10 + i, "Unexpected original length");
+      NS_TEST_EXPECT_MSG_EQ (std::memcmp (content.data () + offset + 28, data, inclLen), 0, "Unexpected packet data");
+      NS_TEST_EXPECT_MSG_EQ (Get32 (content, offset + blockLen - 4), blockLen, "Unexpected enhanced packet block trailing length");
+      offset += blockLen;
+    }
+  NS_TEST_EXPECT_MSG_EQ (content.size (), offset, "Unexpected file length");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1165,6 +1415,9 @@ PcapFileTestSuite::PcapFileTestSuite ()
   //AddTestCase (new AppendModeCreateTestCase, TestCase::QUICK);
   AddTestCase (new FileHeaderTestCase, TestCase::QUICK);
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
+  AddTestCase (new WriteBufferTestCase, TestCase::QUICK);
+  AddTestCase (new PcapNgWriteTestCase (false), TestCase::QUICK);
+  AddTestCase (new PcapNgWriteTestCase (true), TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
 }
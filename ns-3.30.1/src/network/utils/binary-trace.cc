@@ -0,0 +1,599 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "binary-trace.h"
+
+//
+// A binary trace file starts with the four bytes "NSBT", followed by the
+// version and the flags of the file as 16-bit little endian values.  Then
+// come the blocks, each made of its size and of its stored size as 32-bit
+// little endian values, followed by the stored bytes of the block.  The
+// block is compressed if its stored size is smaller than its size.
+//
+// A block holds whole records, made of unsigned LEB128 values:
+//
+//   0, label length, label bytes                    (label definition)
+//   type, zigzag time delta, label index, packet size,
+//     serialized packet length, serialized packet    (event)
+//
+// The type of an event is a single non-zero byte.  The labels are indexed
+// from one in the order they are defined; index zero is the empty label.
+//
+// The compressed blocks use the sequence format of LZ4: a token whose high
+// nibble is the number of literals and whose low nibble is the match length
+// minus four, both extended with bytes of 255 when the nibble is 15, the
+// literals, and the 16-bit little endian offset of the match.  The last
+// sequence only holds literals.
+//
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTrace");
+
+const uint8_t MAGIC[4] = { 'N', 'S', 'B', 'T' };  /**< Identifies a binary trace file */
+const uint16_t VERSION = 1;                      /**< Version of the binary trace format */
+const uint16_t FLAG_COMPRESSED = 1;              /**< The blocks may be compressed */
+const uint8_t LABEL_DEFINITION = 0;              /**< Record type of a label definition */
+const uint32_t MIN_MATCH = 4;                    /**< Minimum length of a match */
+const uint32_t HASH_BITS = 14;                   /**< Number of bits of the match finder hash */
+const uint32_t MAX_BLOCK_SIZE = 1 << 30;         /**< Largest block size accepted by the reader */
+
+/**
+ * \param dst the buffer
+ * \param value a value appended to dst as a 32-bit little endian value
+ */
+static void
+AppendLe32 (std::vector<uint8_t> &dst, uint32_t value)
+{
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      dst.push_back ((value >> (8 * i)) & 0xff);
+    }
+}
+
+/**
+ * \param src four bytes
+ * \return the 32-bit little endian value held by src
+ */
+static uint32_t
+ReadLe32 (const uint8_t *src)
+{
+  return src[0] | (src[1] << 8) | (src[2] << 16) | (uint32_t (src[3]) << 24);
+}
+
+/**
+ * \param src at least MIN_MATCH bytes
+ * \return the hash of the first MIN_MATCH bytes
+ */
+static uint32_t
+HashMatch (const uint8_t *src)
+{
+  uint32_t value;
+  std::memcpy (&value, src, sizeof (value));
+  return (value * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/**
+ * \param dst the buffer
+ * \param length the extension of a length nibble of 15, appended to dst
+ */
+static void
+AppendLength (std::vector<uint8_t> &dst, uint32_t length)
+{
+  while (length >= 255)
+    {
+      dst.push_back (255);
+      length -= 255;
+    }
+  dst.push_back (length);
+}
+
+/**
+ * Append a sequence to the compressed data.
+ *
+ * \param dst the compressed data
+ * \param literals the literals
+ * \param nLiterals the number of literals
+ * \param offset the distance to the match, zero if there is no match
+ * \param matchLength the length of the match
+ */
+static void
+AppendSequence (std::vector<uint8_t> &dst, const uint8_t *literals, uint32_t nLiterals,
+                uint32_t offset, uint32_t matchLength)
+{
+  uint32_t matchCode = offset != 0 ? matchLength - MIN_MATCH : 0;
+  dst.push_back ((std::min (nLiterals, 15U) << 4) | std::min (matchCode, 15U));
+  if (nLiterals >= 15)
+    {
+      AppendLength (dst, nLiterals - 15);
+    }
+  dst.insert (dst.end (), literals, literals + nLiterals);
+  if (offset != 0)
+    {
+      dst.push_back (offset & 0xff);
+      dst.push_back (offset >> 8);
+      if (matchCode >= 15)
+        {
+          AppendLength (dst, matchCode - 15);
+        }
+    }
+}
+
+/**
+ * Compress a block with a greedy match finder.
+ *
+ * \param src the block
+ * \param size the size of the block
+ * \param dst the compressed block
+ */
+static void
+Compress (const uint8_t *src, uint32_t size, std::vector<uint8_t> &dst)
+{
+  std::vector<uint32_t> table (1 << HASH_BITS, 0xffffffff);
+  dst.clear ();
+  uint32_t anchor = 0;
+  uint32_t i = 0;
+  while (i + MIN_MATCH <= size)
+    {
+      uint32_t hash = HashMatch (src + i);
+      uint32_t candidate = table[hash];
+      table[hash] = i;
+      if (candidate != 0xffffffff && i - candidate <= 0xffff
+          && std::memcmp (src + candidate, src + i, MIN_MATCH) == 0)
+        {
+          uint32_t length = MIN_MATCH;
+          while (i + length < size && src[candidate + length] == src[i + length])
+            {
+              length++;
+            }
+          AppendSequence (dst, src + anchor, i - anchor, i - candidate, length);
+          i += length;
+          anchor = i;
+        }
+      else
+        {
+          i++;
+        }
+    }
+  AppendSequence (dst, src + anchor, size - anchor, 0, 0);
+}
+
+/**
+ * \param src the compressed data
+ * \param size the size of the compressed data
+ * \param pos the position of the extension of a length nibble of 15
+ * \param length the length, incremented by its extension
+ * \return false if the compressed data ends before the extension, true otherwise
+ */
+static bool
+ReadLength (const uint8_t *src, uint32_t size, uint32_t &pos, uint32_t &length)
+{
+  uint8_t byte;
+  do
+    {
+      if (pos >= size)
+        {
+          return false;
+        }
+      byte = src[pos++];
+      length += byte;
+    }
+  while (byte == 255);
+  return true;
+}
+
+/**
+ * Decompress a block.
+ *
+ * \param src the compressed block
+ * \param size the size of the compressed block
+ * \param dst the block
+ * \param dstSize the size of the block
+ * \return false if the compressed block is invalid, true otherwise
+ */
+static bool
+Decompress (const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t dstSize)
+{
+  uint32_t ip = 0;
+  uint32_t op = 0;
+  while (ip < size)
+    {
+      uint8_t token = src[ip++];
+      uint32_t nLiterals = token >> 4;
+      if (nLiterals == 15 && !ReadLength (src, size, ip, nLiterals))
+        {
+          return false;
+        }
+      if (nLiterals > size - ip || nLiterals > dstSize - op)
+        {
+          return false;
+        }
+      std::memcpy (dst + op, src + ip, nLiterals);
+      ip += nLiterals;
+      op += nLiterals;
+      if (ip == size)
+        {
+          break;
+        }
+      if (size - ip < 2)
+        {
+          return false;
+        }
+      uint32_t offset = src[ip] | (src[ip + 1] << 8);
+      ip += 2;
+      uint32_t matchLength = token & 0xf;
+      if (matchLength == 15 && !ReadLength (src, size, ip, matchLength))
+        {
+          return false;
+        }
+      matchLength += MIN_MATCH;
+      if (offset == 0 || offset > op || matchLength > dstSize - op)
+        {
+          return false;
+        }
+      // the match may overlap the bytes it produces
+      for (uint32_t k = 0; k < matchLength; k++)
+        {
+          dst[op + k] = dst[op - offset + k];
+        }
+      op += matchLength;
+    }
+  return op == dstSize;
+}
+
+BinaryTraceWriter::BinaryTraceWriter (std::string const &filename, bool compress)
+  : m_compress (compress),
+    m_lastTime (0)
+{
+  NS_LOG_FUNCTION (this << filename << compress);
+  m_file.open (filename.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (m_file.is_open (), "BinaryTraceWriter::BinaryTraceWriter():  " <<
+                       "Unable to Open " << filename);
+  FatalImpl::RegisterStream (&m_file);
+  m_writer.SetStream (&m_file);
+
+  uint8_t header[8];
+  std::memcpy (header, MAGIC, 4);
+  uint16_t flags = compress ? FLAG_COMPRESSED : 0;
+  header[4] = VERSION & 0xff;
+  header[5] = VERSION >> 8;
+  header[6] = flags & 0xff;
+  header[7] = flags >> 8;
+  m_writer.Append (header, sizeof (header));
+  m_writer.Commit ();
+  m_block.reserve (BLOCK_SIZE);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  FatalImpl::UnregisterStream (&m_file);
+}
+
+bool
+BinaryTraceWriter::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer.IsAsync ())
+    {
+      // the stream may be written by the writer thread
+      return m_writer.Fail ();
+    }
+  return m_file.fail ();
+}
+
+void
+BinaryTraceWriter::SetAsync (bool async)
+{
+  NS_LOG_FUNCTION (this << async);
+  m_writer.SetAsync (async);
+}
+
+void
+BinaryTraceWriter::WriteVarint (uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      m_block.push_back ((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+  m_block.push_back (value);
+}
+
+uint32_t
+BinaryTraceWriter::Intern (std::string const &label)
+{
+  if (label.empty ())
+    {
+      return 0;
+    }
+  std::map<std::string, uint32_t>::iterator it = m_labels.find (label);
+  if (it != m_labels.end ())
+    {
+      return it->second;
+    }
+  uint32_t index = m_labels.size () + 1;
+  m_labels.insert (std::make_pair (label, index));
+  m_block.push_back (LABEL_DEFINITION);
+  WriteVarint (label.size ());
+  m_block.insert (m_block.end (), label.begin (), label.end ());
+  return index;
+}
+
+void
+BinaryTraceWriter::Write (char type, Time time, std::string const &label, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << type << time << label << p);
+  NS_ASSERT (type != LABEL_DEFINITION);
+
+  uint32_t labelIndex = Intern (label);
+  int64_t delta = time.GetTimeStep () - m_lastTime;
+  m_lastTime = time.GetTimeStep ();
+
+  uint32_t length = p->GetSerializedSize ();
+  m_packet.resize ((length + 3) / 4);
+  uint8_t *serialized = reinterpret_cast<uint8_t *> (m_packet.data ());
+  p->Serialize (serialized, length);
+
+  m_block.push_back (type);
+  WriteVarint ((uint64_t (delta) << 1) ^ uint64_t (delta >> 63));
+  WriteVarint (labelIndex);
+  WriteVarint (p->GetSize ());
+  WriteVarint (length);
+  m_block.insert (m_block.end (), serialized, serialized + length);
+
+  if (m_block.size () >= BLOCK_SIZE)
+    {
+      EndBlock ();
+    }
+}
+
+void
+BinaryTraceWriter::EndBlock (void)
+{
+  NS_LOG_FUNCTION (this << m_block.size ());
+  if (m_block.empty ())
+    {
+      return;
+    }
+  std::vector<uint8_t> header;
+  AppendLe32 (header, m_block.size ());
+  if (m_compress)
+    {
+      Compress (m_block.data (), m_block.size (), m_compressed);
+    }
+  if (m_compress && m_compressed.size () < m_block.size ())
+    {
+      AppendLe32 (header, m_compressed.size ());
+      m_writer.Append (header.data (), header.size ());
+      m_writer.Append (m_compressed.data (), m_compressed.size ());
+    }
+  else
+    {
+      AppendLe32 (header, m_block.size ());
+      m_writer.Append (header.data (), header.size ());
+      m_writer.Append (m_block.data (), m_block.size ());
+    }
+  m_writer.Commit ();
+  m_block.clear ();
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  EndBlock ();
+  m_writer.Sync ();
+  m_file.flush ();
+}
+
+void
+BinaryTraceWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      EndBlock ();
+      m_writer.Sync ();
+      m_file.close ();
+    }
+}
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_fail (false),
+    m_offset (0),
+    m_type (0),
+    m_time (0),
+    m_label (0),
+    m_packetSize (0),
+    m_packetOffset (0),
+    m_packetLength (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceReader::~BinaryTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  m_block.clear ();
+  m_offset = 0;
+  m_labels.assign (1, "");
+  m_time = 0;
+
+  uint8_t header[8];
+  m_file.read ((char *)header, sizeof (header));
+  uint16_t version = header[4] | (header[5] << 8);
+  m_fail = m_file.fail () || std::memcmp (header, MAGIC, 4) != 0 || version != VERSION;
+}
+
+bool
+BinaryTraceReader::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_fail;
+}
+
+bool
+BinaryTraceReader::ReadBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint8_t header[8];
+  m_file.read ((char *)header, sizeof (header));
+  if (m_file.gcount () == 0 && m_file.eof ())
+    {
+      return false;
+    }
+  uint32_t size = ReadLe32 (header);
+  uint32_t storedSize = ReadLe32 (header + 4);
+  if (m_file.fail () || size == 0 || size > MAX_BLOCK_SIZE || storedSize > size)
+    {
+      m_fail = true;
+      return false;
+    }
+  m_block.resize (size);
+  if (storedSize == size)
+    {
+      m_file.read ((char *)m_block.data (), size);
+      m_fail = m_file.fail ();
+    }
+  else
+    {
+      m_compressed.resize (storedSize);
+      m_file.read ((char *)m_compressed.data (), storedSize);
+      m_fail = m_file.fail ()
+        || !Decompress (m_compressed.data (), storedSize, m_block.data (), size);
+    }
+  m_offset = 0;
+  return !m_fail;
+}
+
+bool
+BinaryTraceReader::ReadVarint (uint64_t &value)
+{
+  value = 0;
+  for (uint32_t shift = 0; shift < 64 && m_offset < m_block.size (); shift += 7)
+    {
+      uint8_t byte = m_block[m_offset++];
+      value |= uint64_t (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  m_fail = true;
+  return false;
+}
+
+bool
+BinaryTraceReader::Next (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_fail)
+    {
+      if (m_offset == m_block.size () && !ReadBlock ())
+        {
+          return false;
+        }
+      uint8_t type = m_block[m_offset++];
+      if (type == LABEL_DEFINITION)
+        {
+          uint64_t length;
+          if (!ReadVarint (length) || length > m_block.size () - m_offset)
+            {
+              m_fail = true;
+              return false;
+            }
+          m_labels.push_back (std::string ((const char *)m_block.data () + m_offset, length));
+          m_offset += length;
+          continue;
+        }
+
+      uint64_t delta, label, packetSize, packetLength;
+      if (!ReadVarint (delta) || !ReadVarint (label) || !ReadVarint (packetSize)
+          || !ReadVarint (packetLength)
+          || label >= m_labels.size () || packetLength > m_block.size () - m_offset)
+        {
+          m_fail = true;
+          return false;
+        }
+      m_type = type;
+      m_time += int64_t (delta >> 1) ^ -int64_t (delta & 1);
+      m_label = label;
+      m_packetSize = packetSize;
+      m_packetOffset = m_offset;
+      m_packetLength = packetLength;
+      m_offset += packetLength;
+      return true;
+    }
+  return false;
+}
+
+char
+BinaryTraceReader::GetType (void) const
+{
+  return m_type;
+}
+
+Time
+BinaryTraceReader::GetTime (void) const
+{
+  return TimeStep (m_time);
+}
+
+std::string const &
+BinaryTraceReader::GetLabel (void) const
+{
+  return m_labels[m_label];
+}
+
+uint32_t
+BinaryTraceReader::GetPacketSize (void) const
+{
+  return m_packetSize;
+}
+
+Ptr<Packet>
+BinaryTraceReader::GetPacket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  // Packet::Deserialize reads 32-bit words
+  std::vector<uint32_t> serialized ((m_packetLength + 3) / 4);
+  std::memcpy (serialized.data (), m_block.data () + m_packetOffset, m_packetLength);
+  return Create<Packet> (reinterpret_cast<const uint8_t *> (serialized.data ()), m_packetLength, true);
+}
+
+void
+BinaryTraceReader::PrintAscii (std::ostream &os) const
+{
+  os << m_type << " " << GetTime ().GetSeconds () << GetLabel () << " " << *GetPacket () << std::endl;
+}
+
+} // namespace ns3
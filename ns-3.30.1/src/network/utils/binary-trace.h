@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include <string>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "buffered-file-writer.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief Write the events of an ascii trace as compact binary records.
+ *
+ * Each record holds the type of the event (the character starting the
+ * line of the ascii trace, such as '+', '-', 'd' or 'r'), its time, a
+ * label and the packet.  The label is the text printed between the time
+ * and the packet in the ascii trace, usually a space followed by the trace
+ * context; every distinct label is stored once in the file and referred
+ * to by its index afterwards.  The time is stored as the difference with
+ * the time of the previous record, and the packet is stored serialized
+ * with its metadata, so that a BinaryTraceReader can print the ascii line
+ * of the record.
+ *
+ * The records are grouped in blocks of about BLOCK_SIZE bytes, which are
+ * compressed with an LZ77 codec when compression is enabled and when this
+ * makes them smaller.  The blocks are written through a BufferedFileWriter,
+ * optionally from its background thread.
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  /// The number of record bytes collected before a block is written
+  static const uint32_t BLOCK_SIZE = 65536;
+
+  /**
+   * Create a new binary trace file.
+   *
+   * \param filename the name of the file
+   * \param compress whether the blocks are compressed
+   */
+  BinaryTraceWriter (std::string const &filename, bool compress = true);
+  ~BinaryTraceWriter ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   *         With asynchronous writes, true if a write of the writer thread failed.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \param async whether the blocks are written from a background thread
+   */
+  void SetAsync (bool async);
+
+  /**
+   * Write a record.
+   *
+   * \param type the type of the event
+   * \param time the time of the event
+   * \param label the text printed between the time and the packet
+   * \param p the packet
+   */
+  void Write (char type, Time time, std::string const &label, Ptr<const Packet> p);
+
+  /**
+   * End the current block, and write all the blocks to the file.
+   */
+  void Flush (void);
+
+  /**
+   * Write the last block and close the file.
+   */
+  void Close (void);
+
+private:
+  /**
+   * Append an unsigned LEB128 value to the current block.
+   * \param value the value
+   */
+  void WriteVarint (uint64_t value);
+  /**
+   * \param label a label
+   * \return the index of the label, defined in the current block if it is new
+   */
+  uint32_t Intern (std::string const &label);
+  /**
+   * Compress the current block if enabled, and hand it to the file writer.
+   */
+  void EndBlock (void);
+
+  std::ofstream m_file;                    //!< the file stream
+  BufferedFileWriter m_writer;             //!< the writer of the blocks
+  bool m_compress;                         //!< whether the blocks are compressed
+  std::vector<uint8_t> m_block;            //!< the records of the current block
+  std::vector<uint8_t> m_compressed;       //!< the current block, compressed
+  std::vector<uint32_t> m_packet;          //!< the serialized packet, 32-bit aligned
+  std::map<std::string, uint32_t> m_labels; //!< the index of the labels already defined
+  int64_t m_lastTime;                      //!< the time of the previous record, in time steps
+};
+
+/**
+ * \brief Read the records of a binary trace file written by a
+ * BinaryTraceWriter, one at a time.
+ *
+ * \code
+ *   BinaryTraceReader reader;
+ *   reader.Open ("trace.nstr");
+ *   while (reader.Next ())
+ *     {
+ *       if (reader.GetType () == 'r')
+ *         {
+ *           bytes += reader.GetPacketSize ();
+ *         }
+ *     }
+ * \endcode
+ *
+ * The packet of a record is only deserialized by GetPacket, which needs
+ * the same header types as the program which wrote the file.
+ */
+class BinaryTraceReader
+{
+public:
+  BinaryTraceReader ();
+  ~BinaryTraceReader ();
+
+  /**
+   * Open a binary trace file, and check its file header.
+   *
+   * \param filename the name of the file
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * \return true if the file could not be read or holds invalid data, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Move to the next record.
+   *
+   * \return false at the end of the file or if the file holds invalid data, true otherwise.
+   */
+  bool Next (void);
+
+  /**
+   * \return the type of the event of the current record
+   */
+  char GetType (void) const;
+  /**
+   * \return the time of the event of the current record
+   */
+  Time GetTime (void) const;
+  /**
+   * \return the label of the current record
+   */
+  std::string const & GetLabel (void) const;
+  /**
+   * \return the size of the packet of the current record
+   */
+  uint32_t GetPacketSize (void) const;
+  /**
+   * \return a copy of the packet of the current record
+   */
+  Ptr<Packet> GetPacket (void) const;
+  /**
+   * Print the current record as the line of an ascii trace.
+   *
+   * \param os the output stream
+   */
+  void PrintAscii (std::ostream &os) const;
+
+private:
+  /**
+   * Read the next block of the file.
+   * \return false at the end of the file or if the block is invalid, true otherwise.
+   */
+  bool ReadBlock (void);
+  /**
+   * \param value the unsigned LEB128 value read from the current block
+   * \return false if the block ends before the value, true otherwise.
+   */
+  bool ReadVarint (uint64_t &value);
+
+  std::ifstream m_file;                //!< the file stream
+  bool m_fail;                         //!< whether the file is invalid
+  std::vector<uint8_t> m_block;        //!< the records of the current block
+  std::vector<uint8_t> m_compressed;   //!< the current block, compressed
+  uint32_t m_offset;                   //!< the offset of the next record in m_block
+  std::vector<std::string> m_labels;   //!< the labels defined so far
+  char m_type;                         //!< the type of the current record
+  int64_t m_time;                      //!< the time of the current record, in time steps
+  uint32_t m_label;                    //!< the label index of the current record
+  uint32_t m_packetSize;               //!< the packet size of the current record
+  uint32_t m_packetOffset;             //!< the offset of the serialized packet in m_block
+  uint32_t m_packetLength;             //!< the length of the serialized packet
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_H */
@@ -0,0 +1,332 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "buffered-file-writer.h"
+#include <cstring>
+#ifdef HAVE_PTHREAD_H
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BufferedFileWriter");
+
+#ifdef HAVE_PTHREAD_H
+namespace {
+
+/**
+ * \brief The thread writing the buffers of all the asynchronous
+ * BufferedFileWriter instances, in the order they were submitted.
+ */
+class WriterThread
+{
+public:
+  /**
+   * \return the writer thread
+   */
+  static WriterThread * Get (void)
+  {
+    static WriterThread thread;
+    return &thread;
+  }
+
+  /**
+   * Queue a buffer to be written to a stream, waiting first until fewer than
+   * BufferedFileWriter::MAX_PENDING_BUFFERS buffers are pending.
+   *
+   * \param stream the stream
+   * \param data the buffer, which is swapped with an empty one
+   * \param failed set if the write fails
+   */
+  void Submit (std::ostream *stream, std::vector<uint8_t> &data, std::atomic<bool> *failed)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (m_jobs.size () + (m_busy ? 1 : 0) >= BufferedFileWriter::MAX_PENDING_BUFFERS)
+      {
+        m_doneCondition.wait (lock);
+      }
+    if (!m_thread.joinable ())
+      {
+        m_thread = std::thread (&WriterThread::DoRun, this);
+      }
+    m_jobs.push_back (Job ());
+    m_jobs.back ().stream = stream;
+    m_jobs.back ().data.swap (data);
+    m_jobs.back ().failed = failed;
+    if (!m_free.empty ())
+      {
+        // hand back the storage of a buffer already written
+        data.swap (m_free.back ());
+        m_free.pop_back ();
+      }
+    m_jobCondition.notify_one ();
+  }
+
+  /**
+   * Wait until all the queued buffers are written.
+   */
+  void Wait (void)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (!m_jobs.empty () || m_busy)
+      {
+        m_doneCondition.wait (lock);
+      }
+  }
+
+private:
+  WriterThread ()
+    : m_busy (false),
+      m_stop (false)
+  {
+  }
+
+  ~WriterThread ()
+  {
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_stop = true;
+      m_jobCondition.notify_one ();
+    }
+    if (m_thread.joinable ())
+      {
+        m_thread.join ();
+      }
+  }
+
+  /**
+   * The loop of the writer thread.
+   */
+  void DoRun (void)
+  {
+    std::vector<uint8_t> data;
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (true)
+      {
+        while (m_jobs.empty () && !m_stop)
+          {
+            m_jobCondition.wait (lock);
+          }
+        if (m_jobs.empty ())
+          {
+            return;
+          }
+        std::ostream *stream = m_jobs.front ().stream;
+        std::atomic<bool> *failed = m_jobs.front ().failed;
+        data.swap (m_jobs.front ().data);
+        m_jobs.pop_front ();
+        m_busy = true;
+        lock.unlock ();
+        stream->write ((const char *)data.data (), data.size ());
+        if (stream->fail ())
+          {
+            failed->store (true);
+          }
+        data.clear ();
+        lock.lock ();
+        m_busy = false;
+        if (m_free.size () < BufferedFileWriter::MAX_PENDING_BUFFERS)
+          {
+            m_free.push_back (std::vector<uint8_t> ());
+            m_free.back ().swap (data);
+          }
+        m_doneCondition.notify_all ();
+      }
+  }
+
+  /// A buffer to write
+  struct Job
+  {
+    std::ostream *stream;      //!< the stream
+    std::vector<uint8_t> data; //!< the buffer
+    std::atomic<bool> *failed; //!< set if the write fails
+  };
+
+  std::mutex m_mutex;                       //!< the mutex protecting the state below
+  std::condition_variable m_jobCondition;   //!< signalled when a job is queued or the thread must stop
+  std::condition_variable m_doneCondition;  //!< signalled when a job is done
+  std::deque<Job> m_jobs;                   //!< the queued jobs
+  std::vector<std::vector<uint8_t> > m_free; //!< the storage of the buffers already written
+  bool m_busy;                              //!< whether a job is being written
+  bool m_stop;                              //!< whether the thread must stop
+  std::thread m_thread;                     //!< the thread
+};
+
+} // unnamed namespace
+#endif /* HAVE_PTHREAD_H */
+
+BufferedFileWriter::BufferedFileWriter ()
+  : m_stream (0),
+    m_bufferSize (0),
+    m_async (false),
+    m_failed (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BufferedFileWriter::~BufferedFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      // the writer thread records the failures of the queued buffers in m_failed
+      WriterThread::Get ()->Wait ();
+    }
+#endif
+}
+
+void
+BufferedFileWriter::SetStream (std::ostream *stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_stream = stream;
+}
+
+void
+BufferedFileWriter::SetBufferSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_bufferSize = size;
+  m_buffer.reserve (size);
+}
+
+uint32_t
+BufferedFileWriter::GetBufferSize (void) const
+{
+  return m_bufferSize;
+}
+
+void
+BufferedFileWriter::SetAsync (bool async)
+{
+  NS_LOG_FUNCTION (this << async);
+#ifdef HAVE_PTHREAD_H
+  if (m_async && !async)
+    {
+      // the next buffers must not be written before the queued ones
+      WriterThread::Get ()->Wait ();
+    }
+#endif
+  m_async = async;
+}
+
+bool
+BufferedFileWriter::IsAsync (void) const
+{
+  return m_async;
+}
+
+uint8_t *
+BufferedFileWriter::Reserve (uint32_t size)
+{
+  std::size_t offset = m_buffer.size ();
+  m_buffer.resize (offset + size);
+  return m_buffer.data () + offset;
+}
+
+void
+BufferedFileWriter::Append (const void *data, uint32_t size)
+{
+  std::memcpy (Reserve (size), data, size);
+}
+
+void
+BufferedFileWriter::Commit (void)
+{
+  if (m_buffer.size () >= m_bufferSize)
+    {
+      Flush ();
+    }
+}
+
+void
+BufferedFileWriter::Sync (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      WriterThread::Get ()->Wait ();
+    }
+#endif
+  if (!m_buffer.empty ())
+    {
+      Write ();
+    }
+  if (m_stream == 0)
+    {
+      return;
+    }
+  // no buffer is being written, so the stream can be accessed
+  if (m_stream->fail ())
+    {
+      m_failed.store (true);
+    }
+  else if (m_failed.load ())
+    {
+      m_stream->setstate (std::ios::failbit);
+    }
+}
+
+bool
+BufferedFileWriter::Fail (void) const
+{
+  return m_failed.load ();
+}
+
+void
+BufferedFileWriter::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_failed.store (false);
+}
+
+void
+BufferedFileWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_buffer.size ());
+  NS_ASSERT (m_stream != 0);
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      WriterThread::Get ()->Submit (m_stream, m_buffer, &m_failed);
+      m_buffer.reserve (m_bufferSize);
+      return;
+    }
+#endif
+  Write ();
+}
+
+void
+BufferedFileWriter::Write (void)
+{
+  NS_ASSERT (m_stream != 0);
+  m_stream->write ((const char *)m_buffer.data (), m_buffer.size ());
+  m_buffer.clear ();
+  if (m_stream->fail ())
+    {
+      m_failed.store (true);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUFFERED_FILE_WRITER_H
+#define BUFFERED_FILE_WRITER_H
+
+#include <atomic>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Collect the records written to a binary trace file in a user-space
+ * buffer, and optionally write the full buffers from a background thread.
+ *
+ * A record is appended with Reserve, which returns the bytes to fill, and
+ * ended with Commit, which writes the buffer to the stream once it holds
+ * at least the buffer size.  With a buffer size of zero, every record is
+ * written to the stream by the Commit which ends it, with a single write.
+ *
+ * In asynchronous mode the full buffers are handed to a writer thread
+ * shared by all the BufferedFileWriter instances.  The writer thread holds
+ * at most MAX_PENDING_BUFFERS buffers: when they are all pending, Commit
+ * blocks until the oldest one is written.  The stream must not be used by
+ * the caller until Sync returns: the errors of the writes are recorded by
+ * the thread which makes them, reported by Fail, and set on the stream by
+ * Sync.  If threads are not supported by the build, the buffers are
+ * written by the calling thread.
+ */
+class BufferedFileWriter
+{
+public:
+  /// The maximum number of buffers waiting for the writer thread
+  static const uint32_t MAX_PENDING_BUFFERS = 8;
+
+  BufferedFileWriter ();
+  ~BufferedFileWriter ();
+
+  /**
+   * \param stream the stream the buffers are written to
+   */
+  void SetStream (std::ostream *stream);
+  /**
+   * \param size the number of bytes collected before they are written to the stream
+   */
+  void SetBufferSize (uint32_t size);
+  /**
+   * \return the number of bytes collected before they are written to the stream
+   */
+  uint32_t GetBufferSize (void) const;
+  /**
+   * \param async whether the full buffers are written by the writer thread
+   */
+  void SetAsync (bool async);
+  /**
+   * \return true if the full buffers are written by the writer thread
+   */
+  bool IsAsync (void) const;
+
+  /**
+   * Append size bytes to the current record.
+   *
+   * \param size the number of bytes to append
+   * \return the appended bytes, which are valid until the next call to Reserve or Commit
+   */
+  uint8_t * Reserve (uint32_t size);
+  /**
+   * Append a copy of size bytes to the current record.
+   *
+   * \param data the bytes to append
+   * \param size the number of bytes to append
+   */
+  void Append (const void *data, uint32_t size);
+  /**
+   * End the current record, and write the buffer if it is full.
+   */
+  void Commit (void);
+  /**
+   * Write the records collected so far to the stream, and wait until all
+   * the buffers of the writer thread are written.  The stream can be
+   * used by the caller until the next Commit, and its failbit is set if
+   * a write failed.
+   */
+  void Sync (void);
+  /**
+   * \return true if a write to the stream failed, or if the stream had
+   *         failed at the last Sync; the stream itself is not accessed
+   */
+  bool Fail (void) const;
+  /**
+   * Forget the failed writes, after the caller cleared the error state of
+   * the stream.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * Write the buffer to the stream, or hand it to the writer thread.
+   */
+  void Flush (void);
+  /**
+   * Write the buffer to the stream from the calling thread, and record a failure.
+   */
+  void Write (void);
+
+  std::ostream *m_stream;        //!< the stream
+  std::vector<uint8_t> m_buffer; //!< the records not written yet
+  uint32_t m_bufferSize;         //!< the number of bytes collected before they are written
+  bool m_async;                  //!< whether the writer thread writes the buffers
+  std::atomic<bool> m_failed;    //!< whether a write failed, set by the thread writing
+};
+
+} // namespace ns3
+
+#endif /* BUFFERED_FILE_WRITER_H */
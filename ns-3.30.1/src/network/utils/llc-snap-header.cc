@@ -98,5 +98,11 @@ LlcSnapHeader::Deserialize (Buffer::Iterator start)
   return GetSerializedSize ();
 }
 
+bool
+LlcSnapHeader::IsSelfContained (void) const
+{
+  return true;
+}
+
 
 } // namespace ns3
@@ -65,6 +65,7 @@ public:
   virtual uint32_t GetSerializedSize (void) const;
   virtual void Serialize (Buffer::Iterator start) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual bool IsSelfContained (void) const;
 private:
   uint16_t m_etherType; //!< the Ethertype
 };
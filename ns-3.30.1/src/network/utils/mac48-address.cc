@@ -246,6 +246,19 @@ Mac48Address Mac48Address::GetMulticast (Ipv6Address addr)
   return etherAddr;
 }
 
+size_t
+Mac48AddressHash::operator() (Mac48Address const &x) const
+{
+  uint8_t buffer[6];
+  x.CopyTo (buffer);
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      value = (value << 8) | buffer[i];
+    }
+  return static_cast<size_t> (value);
+}
+
 std::ostream& operator<< (std::ostream& os, const Mac48Address & address)
 {
   uint8_t ad[6];
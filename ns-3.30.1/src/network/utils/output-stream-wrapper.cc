@@ -46,6 +46,15 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
   NS_ABORT_MSG_UNLESS (m_ostream->good (), "Output stream is not valid for writing.");
 }
 
+OutputStreamWrapper::OutputStreamWrapper (Ptr<BinaryTraceWriter> writer)
+  : m_destroyable (true),
+    m_binaryWriter (writer)
+{
+  NS_LOG_FUNCTION (this << writer);
+  // a stream without buffer, which discards the text written to it
+  m_ostream = new std::ostream (0);
+}
+
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
@@ -61,4 +70,11 @@ OutputStreamWrapper::GetStream (void)
   return m_ostream;
 }
 
+Ptr<BinaryTraceWriter>
+OutputStreamWrapper::GetBinaryWriter (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_binaryWriter;
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace.h"
 
 namespace ns3 {
 
@@ -66,6 +67,10 @@ namespace ns3 {
  *
  * This class uses a basic ns-3 reference counting base class but is not 
  * an ns3::Object with attributes, TypeId, or aggregation.
+ *
+ * The wrapper can also hold a BinaryTraceWriter instead of a stream.  The
+ * trace sinks which support binary traces write their events to it, and the
+ * text written to the stream returned by GetStream is discarded.
  */
 class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 {
@@ -81,6 +86,11 @@ public:
    * \param os output stream
    */
   OutputStreamWrapper (std::ostream* os);
+  /**
+   * Constructor
+   * \param writer binary trace writer
+   */
+  OutputStreamWrapper (Ptr<BinaryTraceWriter> writer);
   ~OutputStreamWrapper ();
 
   /**
@@ -92,9 +102,15 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * \returns the binary trace writer, if any
+   */
+  Ptr<BinaryTraceWriter> GetBinaryWriter (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<BinaryTraceWriter> m_binaryWriter; //!< The binary trace writer, if any
 };
 
 } // namespace ns3
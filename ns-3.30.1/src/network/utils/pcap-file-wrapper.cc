@@ -46,12 +46,24 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("BufferSize",
+                   "Number of bytes collected in a user-space buffer before they are "
+                   "written to the file (zero writes every packet as it comes).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AsyncWriter",
+                   "Whether the full buffers are written to the file from a background thread.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWriter),
+                   MakeBooleanChecker())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_interface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +78,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -86,6 +102,7 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -94,6 +111,33 @@ PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
   m_file.Open (filename, mode);
+  if (mode & std::ios::out)
+    {
+      m_file.SetWriteBuffer (m_bufferSize, m_asyncWriter);
+    }
+}
+
+void
+PcapFileWrapper::Open (Ptr<PcapNgFile> file, std::string const &interfaceName)
+{
+  NS_LOG_FUNCTION (this << file << interfaceName);
+  m_ngFile = file;
+  m_interfaceName = interfaceName;
+  m_ngFile->SetWriteBuffer (m_bufferSize, m_asyncWriter);
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Flush ();
+    }
+  else
+    {
+      m_file.Flush ();
+    }
 }
 
 void
@@ -105,7 +149,16 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
-  if (snapLen != std::numeric_limits<uint32_t>::max ())
+  if (m_ngFile != 0)
+    {
+      // the timestamps of a pcapng file are always in UTC
+      if (snapLen == std::numeric_limits<uint32_t>::max ())
+        {
+          snapLen = m_snapLen;
+        }
+      m_interface = m_ngFile->AddInterface (dataLinkType, snapLen, m_interfaceName);
+    }
+  else if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
     } 
@@ -119,6 +172,11 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_interface, t.GetNanoSeconds (), p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +197,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_interface, t.GetNanoSeconds (), header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +222,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_interface, t.GetNanoSeconds (), buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -246,6 +314,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->GetSnapLen (m_interface);
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -253,6 +325,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->GetDataLinkType (m_interface);
+    }
   return m_file.GetDataLinkType ();
 }
 
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -35,6 +36,9 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * A wrapper can also write its packets as one interface of a pcapng file
+ * shared with other wrappers, see Open (Ptr<PcapNgFile>, std::string const &).
  */
 class PcapFileWrapper : public Object
 {
@@ -77,6 +81,21 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Write the packets as a new interface of a pcapng file, instead of a
+   * pcap file of their own.  The interface is described in the file by
+   * Init, and Read is not supported.  The pcapng file is closed when the
+   * last wrapper writing to it is closed.
+   *
+   * The write buffer of the pcapng file is set from the attributes of the
+   * wrapper.
+   *
+   * \param file The pcapng file.
+   *
+   * \param interfaceName The name of the interface in the pcapng file.
+   */
+  void Open (Ptr<PcapNgFile> file, std::string const &interfaceName);
+
   /**
    * Close the underlying pcap file.
    */
@@ -142,6 +161,11 @@ public:
    */
   void Write (Time t, uint8_t const *buffer, uint32_t length);
 
+  /**
+   * \brief Write the packets collected in the write buffer to the file.
+   */
+  void Flush (void);
+
   /**
    * \brief Read the next packet from the file.
    * 
@@ -224,6 +248,11 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_bufferSize; //!< size of the write buffer
+  bool     m_asyncWriter; //!< whether the write buffers are written from a background thread
+  Ptr<PcapNgFile> m_ngFile; //!< pcapng file written instead of m_file, if any
+  std::string m_interfaceName; //!< name of the interface in m_ngFile
+  uint32_t m_interface; //!< index of the interface in m_ngFile
 };
 
 } // namespace ns3
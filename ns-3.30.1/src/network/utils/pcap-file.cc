@@ -54,6 +54,7 @@ PcapFile::PcapFile ()
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
+  m_writer.SetStream (&m_file);
 }
 
 PcapFile::~PcapFile ()
@@ -68,6 +69,11 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer.IsAsync ())
+    {
+      // the stream may be written by the writer thread
+      return m_writer.Fail ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -80,7 +86,9 @@ void
 PcapFile::Clear (void)
 {
   NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
   m_file.clear ();
+  m_writer.Clear ();
 }
 
 
@@ -88,6 +96,7 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
   m_file.close ();
 }
 
@@ -396,14 +405,33 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
   //
   m_swapMode = swapMode | bigEndian;
 
+  m_writer.Sync ();
   WriteFileHeader ();
 }
 
+void
+PcapFile::SetWriteBuffer (uint32_t bufferSize, bool async)
+{
+  NS_LOG_FUNCTION (this << bufferSize << async);
+  m_writer.Sync ();
+  m_writer.SetBufferSize (bufferSize);
+  m_writer.SetAsync (async);
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
+  m_file.flush ();
+}
+
 uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  // the stream is written by the writer thread in asynchronous mode
+  NS_ASSERT (m_writer.IsAsync () || m_file.good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -422,21 +450,31 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  m_writer.Append (&header.m_tsSec, sizeof(header.m_tsSec));
+  m_writer.Append (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  m_writer.Append (&header.m_inclLen, sizeof(header.m_inclLen));
+  m_writer.Append (&header.m_origLen, sizeof(header.m_origLen));
   return inclLen;
 }
 
+void
+PcapFile::CommitRecord (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Commit ();
+  if (!m_writer.IsAsync ())
+    {
+      NS_BUILD_DEBUG(m_file.flush());
+    }
+}
+
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  m_writer.Append (data, inclLen);
+  CommitRecord ();
 }
 
 void 
@@ -444,8 +482,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  p->CopyData (m_writer.Reserve (inclLen), inclLen);
+  CommitRecord ();
 }
 
 void 
@@ -460,9 +498,10 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
+  headerBuffer.CopyData (m_writer.Reserve (toCopy), toCopy);
   inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  p->CopyData (m_writer.Reserve (inclLen), inclLen);
+  CommitRecord ();
 }
 
 void
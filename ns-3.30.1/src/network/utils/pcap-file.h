@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "buffered-file-writer.h"
 
 namespace ns3 {
 
@@ -51,6 +52,8 @@ public:
 
   /**
    * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   *         With an asynchronous write buffer, true if a write of the writer
+   *         thread failed, without accessing the iostream.
    */
   bool Fail (void) const;
   /**
@@ -122,6 +125,30 @@ public:
              bool swapMode = false,
              bool nanosecMode = false);
 
+  /**
+   * \brief Collect the packets written to the file in a user-space buffer.
+   *
+   * By default, every packet is written to the file by the call to Write
+   * which provides it.  With a buffer, the packets are written to the file
+   * when the buffer is full, when Flush is called and when the file is
+   * closed; the packets still in the buffer are lost if the program
+   * aborts.  The packets are truncated to the snap length before they are
+   * copied to the buffer.
+   *
+   * \param bufferSize the number of bytes collected before they are written
+   * to the file.  Zero disables the buffer.
+   *
+   * \param async Whether the full buffers are written from a background
+   * thread shared by all the files.  Write blocks when this thread has
+   * BufferedFileWriter::MAX_PENDING_BUFFERS buffers to write.
+   */
+  void SetWriteBuffer (uint32_t bufferSize, bool async = false);
+
+  /**
+   * \brief Write the packets collected in the user-space buffer to the file.
+   */
+  void Flush (void);
+
   /**
    * \brief Write next packet to file
    * 
@@ -351,8 +378,8 @@ private:
   /**
    * \brief Write a Pcap packet header
    *
-   * The pcap header has a fixed length of 24 bytes. The last 4 bytes
-   * represent the link-layer type
+   * The record header is appended to the write buffer, and must be
+   * followed by the packet data and a call to CommitRecord.
    *
    * \param tsSec Time stamp (seconds part)
    * \param tsUsec Time stamp (microseconds part)
@@ -360,6 +387,10 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief End the record started by WritePacketHeader
+   */
+  void CommitRecord (void);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -368,6 +399,7 @@ private:
 
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  BufferedFileWriter m_writer;  //!< buffer of the records written to m_file
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
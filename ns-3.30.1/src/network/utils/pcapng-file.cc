@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/log.h"
+#include "ns3/build-profile.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;    /**< Block type of the section header */
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;      /**< Block type of an interface description */
+const uint32_t ENHANCED_PACKET_BLOCK = 6;            /**< Block type of a packet */
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;        /**< Identifies the byte order of the section */
+const uint16_t NG_VERSION_MAJOR = 1;                 /**< Major version of the pcapng format */
+const uint16_t NG_VERSION_MINOR = 0;                 /**< Minor version of the pcapng format */
+const uint16_t OPT_ENDOFOPT = 0;                     /**< Option ending the options of a block */
+const uint16_t IF_NAME = 2;                          /**< Interface option holding its name */
+const uint16_t IF_TSRESOL = 9;                       /**< Interface option holding the timestamp resolution */
+const uint8_t TSRESOL_NSEC = 9;                      /**< Timestamps in units of 10^-9 seconds */
+
+/**
+ * \param length a length in bytes
+ * \return the number of bytes padding length to a multiple of 32 bits
+ */
+static uint32_t
+Padding (uint32_t length)
+{
+  return (4 - (length % 4)) % 4;
+}
+
+PcapNgFile::PcapNgFile ()
+  : m_file ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::RegisterStream (&m_file);
+  m_writer.SetStream (&m_file);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer.IsAsync ())
+    {
+      // the stream may be written by the writer thread
+      return m_writer.Fail ();
+    }
+  return m_file.fail ();
+}
+
+void
+PcapNgFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT (!m_file.is_open ());
+
+  m_filename = filename;
+  m_interfaces.clear ();
+  m_file.open (filename.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+
+  //
+  // The section header has no options, and an unspecified section length.
+  //
+  uint32_t blockLen = 28;
+  Append32 (SECTION_HEADER_BLOCK);
+  Append32 (blockLen);
+  Append32 (BYTE_ORDER_MAGIC);
+  m_writer.Append (&NG_VERSION_MAJOR, sizeof (NG_VERSION_MAJOR));
+  m_writer.Append (&NG_VERSION_MINOR, sizeof (NG_VERSION_MINOR));
+  Append32 (0xffffffff);
+  Append32 (0xffffffff);
+  Append32 (blockLen);
+  m_writer.Commit ();
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
+  m_file.close ();
+}
+
+void
+PcapNgFile::SetWriteBuffer (uint32_t bufferSize, bool async)
+{
+  NS_LOG_FUNCTION (this << bufferSize << async);
+  m_writer.Sync ();
+  m_writer.SetBufferSize (bufferSize);
+  m_writer.SetAsync (async);
+}
+
+void
+PcapNgFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
+  m_file.flush ();
+}
+
+uint32_t
+PcapNgFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name);
+  NS_ASSERT (name.size () <= 0xffff);
+
+  Interface interface;
+  interface.dataLinkType = dataLinkType;
+  interface.snapLen = snapLen;
+  m_interfaces.push_back (interface);
+
+  //
+  // The interface options are its name, if any, and the resolution of the
+  // timestamps of its packets.
+  //
+  uint16_t nameLen = name.size ();
+  uint32_t blockLen = 32;
+  if (nameLen > 0)
+    {
+      blockLen += 4 + nameLen + Padding (nameLen);
+    }
+  Append32 (INTERFACE_DESCRIPTION_BLOCK);
+  Append32 (blockLen);
+  uint16_t linkType = dataLinkType;
+  uint16_t reserved = 0;
+  m_writer.Append (&linkType, sizeof (linkType));
+  m_writer.Append (&reserved, sizeof (reserved));
+  Append32 (snapLen);
+  if (nameLen > 0)
+    {
+      m_writer.Append (&IF_NAME, sizeof (IF_NAME));
+      m_writer.Append (&nameLen, sizeof (nameLen));
+      m_writer.Append (name.data (), nameLen);
+      std::memset (m_writer.Reserve (Padding (nameLen)), 0, Padding (nameLen));
+    }
+  uint16_t tsresolLen = 1;
+  m_writer.Append (&IF_TSRESOL, sizeof (IF_TSRESOL));
+  m_writer.Append (&tsresolLen, sizeof (tsresolLen));
+  uint8_t *tsresol = m_writer.Reserve (4);
+  std::memset (tsresol, 0, 4);
+  tsresol[0] = TSRESOL_NSEC;
+  Append32 (OPT_ENDOFOPT);
+  Append32 (blockLen);
+  m_writer.Commit ();
+
+  return m_interfaces.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_interfaces.size ();
+}
+
+uint32_t
+PcapNgFile::GetDataLinkType (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].dataLinkType;
+}
+
+uint32_t
+PcapNgFile::GetSnapLen (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].snapLen;
+}
+
+void
+PcapNgFile::Append32 (uint32_t value)
+{
+  m_writer.Append (&value, sizeof (value));
+}
+
+uint32_t
+PcapNgFile::WritePacketBlockHeader (uint32_t interface, uint64_t tsNsec, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interface << tsNsec << totalLen);
+  NS_ASSERT (interface < m_interfaces.size ());
+
+  uint32_t inclLen = std::min (totalLen, m_interfaces[interface].snapLen);
+  Append32 (ENHANCED_PACKET_BLOCK);
+  Append32 (32 + inclLen + Padding (inclLen));
+  Append32 (interface);
+  Append32 (tsNsec >> 32);
+  Append32 (tsNsec & 0xffffffff);
+  Append32 (inclLen);
+  Append32 (totalLen);
+  return inclLen;
+}
+
+void
+PcapNgFile::CommitPacketBlock (uint32_t inclLen)
+{
+  NS_LOG_FUNCTION (this << inclLen);
+  std::memset (m_writer.Reserve (Padding (inclLen)), 0, Padding (inclLen));
+  Append32 (32 + inclLen + Padding (inclLen));
+  m_writer.Commit ();
+  if (!m_writer.IsAsync ())
+    {
+      NS_BUILD_DEBUG(m_file.flush());
+    }
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t tsNsec, uint8_t const * const data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interface << tsNsec << &data << totalLen);
+  uint32_t inclLen = WritePacketBlockHeader (interface, tsNsec, totalLen);
+  m_writer.Append (data, inclLen);
+  CommitPacketBlock (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t tsNsec, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << tsNsec << p);
+  uint32_t inclLen = WritePacketBlockHeader (interface, tsNsec, p->GetSize ());
+  p->CopyData (m_writer.Reserve (inclLen), inclLen);
+  CommitPacketBlock (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t tsNsec, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << tsNsec << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t totalSize = headerSize + p->GetSize ();
+  uint32_t inclLen = WritePacketBlockHeader (interface, tsNsec, totalSize);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (m_writer.Reserve (toCopy), toCopy);
+  p->CopyData (m_writer.Reserve (inclLen - toCopy), inclLen - toCopy);
+  CommitPacketBlock (inclLen);
+}
+
+} // namespace ns3
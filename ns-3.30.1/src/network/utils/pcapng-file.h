@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "buffered-file-writer.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A class representing a pcapng file with several interfaces
+ *
+ * A pcapng file holds the packets captured on several interfaces, each
+ * with its own data link type and snap length, in a single file which may
+ * be viewed using standard tools.  The packets of all the interfaces are
+ * stored in the order they are written, with nanosecond timestamps, in
+ * the byte order of the writing system.
+ *
+ * Only writing is supported.  The file is written through a
+ * BufferedFileWriter, as with PcapFile::SetWriteBuffer.
+ *
+ * See https://github.com/pcapng/pcapng for the format.
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  PcapNgFile ();
+  ~PcapNgFile ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   *         With an asynchronous write buffer, true if a write of the writer
+   *         thread failed, without accessing the iostream.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Create a new pcapng file, and write its section header.
+   *
+   * \param filename String containing the name of the file.
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * Close the underlying file.
+   */
+  void Close (void);
+
+  /**
+   * \brief Collect the packets written to the file in a user-space buffer.
+   *
+   * \param bufferSize the number of bytes collected before they are written
+   * to the file.  Zero disables the buffer.
+   * \param async Whether the full buffers are written from a background thread.
+   *
+   * \see PcapFile::SetWriteBuffer
+   */
+  void SetWriteBuffer (uint32_t bufferSize, bool async = false);
+
+  /**
+   * \brief Write the packets collected in the user-space buffer to the file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Describe a new interface.
+   *
+   * \param dataLinkType A data link type as defined in the pcap library.
+   * \param snapLen The maximum size of the packets of this interface
+   * written to the file.  Longer packets are truncated.
+   * \param name The name of the interface shown by the tools.
+   * \return the index of the interface
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name);
+
+  /**
+   * \return the number of interfaces
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \param interface the index of the interface
+   * \return the data link type of the interface
+   */
+  uint32_t GetDataLinkType (uint32_t interface) const;
+
+  /**
+   * \param interface the index of the interface
+   * \return the snap length of the interface
+   */
+  uint32_t GetSnapLen (uint32_t interface) const;
+
+  /**
+   * \brief Write next packet to file
+   *
+   * \param interface   Index of the interface
+   * \param tsNsec      Packet timestamp, nanoseconds
+   * \param data        Data buffer
+   * \param totalLen    Total packet length
+   */
+  void Write (uint32_t interface, uint64_t tsNsec, uint8_t const * const data, uint32_t totalLen);
+  /**
+   * \brief Write next packet to file
+   *
+   * \param interface   Index of the interface
+   * \param tsNsec      Packet timestamp, nanoseconds
+   * \param p           Packet to write
+   */
+  void Write (uint32_t interface, uint64_t tsNsec, Ptr<const Packet> p);
+  /**
+   * \brief Write next packet to file
+   *
+   * \param interface   Index of the interface
+   * \param tsNsec      Packet timestamp, nanoseconds
+   * \param header      Header to write, in front of packet
+   * \param p           Packet to write
+   */
+  void Write (uint32_t interface, uint64_t tsNsec, const Header &header, Ptr<const Packet> p);
+
+private:
+  /**
+   * \brief An interface described in the file
+   */
+  struct Interface
+  {
+    uint32_t dataLinkType;  //!< data link type of the packets
+    uint32_t snapLen;       //!< maximum length of the packets stored
+  };
+
+  /**
+   * \brief Write the header of an enhanced packet block
+   *
+   * The header is appended to the write buffer, and must be followed by
+   * the packet data and a call to CommitPacketBlock.
+   *
+   * \param interface Index of the interface
+   * \param tsNsec Time stamp, nanoseconds
+   * \param totalLen total packet length
+   * \returns the length of the packet to write in the file
+   */
+  uint32_t WritePacketBlockHeader (uint32_t interface, uint64_t tsNsec, uint32_t totalLen);
+  /**
+   * \brief End the block started by WritePacketBlockHeader
+   *
+   * \param inclLen the length of the packet written in the file
+   */
+  void CommitPacketBlock (uint32_t inclLen);
+  /**
+   * \brief Append a 32 bit value to the write buffer
+   * \param value the value
+   */
+  void Append32 (uint32_t value);
+
+  std::string    m_filename;    //!< file name
+  std::fstream   m_file;        //!< file stream
+  BufferedFileWriter m_writer;  //!< buffer of the blocks written to m_file
+  std::vector<Interface> m_interfaces; //!< the interfaces described in the file
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
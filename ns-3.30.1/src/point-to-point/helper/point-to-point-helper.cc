@@ -91,7 +91,7 @@ PointToPointHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, b
       return;
     }
 
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
 
   std::string filename;
   if (explicitFilename)
@@ -0,0 +1,289 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/mobility-model.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("LossModel",
+                   "The deterministic chain of loss models whose loss is cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetLossModel,
+                                        &CachedPropagationLossModel::GetLossModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("MaxTableSize",
+                   "The largest number of mobility models whose losses are stored in a flat "
+                   "table; the losses between more mobility models are stored in a hash table "
+                   "of the evaluated pairs.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::m_maxTableSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_tableSize (0),
+    m_sparse (false),
+    m_hits (0),
+    m_misses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_mobilities.begin (); i != m_mobilities.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&CachedPropagationLossModel::CourseChanged, this));
+    }
+  m_mobilities.clear ();
+  m_indexes.clear ();
+  m_static.clear ();
+  m_table.clear ();
+  m_tableSize = 0;
+  m_sparseTable.clear ();
+  m_epochs.clear ();
+  m_sparse = false;
+  m_lossModel = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetLossModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ABORT_MSG_IF (model != 0 && !model->IsDeterministic (),
+                   "CachedPropagationLossModel::SetLossModel(): the loss of the chain cannot be cached");
+  m_lossModel = model;
+  for (std::vector<Entry>::iterator i = m_table.begin (); i != m_table.end (); ++i)
+    {
+      i->txPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+    }
+  m_sparseTable.clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetLossModel (void) const
+{
+  return m_lossModel;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+double
+CachedPropagationLossModel::GetHitRate (void) const
+{
+  uint64_t total = m_hits + m_misses;
+  return total == 0 ? 0.0 : static_cast<double> (m_hits) / total;
+}
+
+bool
+CachedPropagationLossModel::IsStatic (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  return velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+}
+
+uint32_t
+CachedPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_indexes.find (PeekPointer (mobility));
+  if (it != m_indexes.end ())
+    {
+      return it->second;
+    }
+
+  uint32_t index = m_mobilities.size ();
+  NS_LOG_DEBUG ("mobility model " << mobility << " has index " << index);
+  m_indexes[PeekPointer (mobility)] = index;
+  m_mobilities.push_back (mobility);
+  m_static.push_back (IsStatic (mobility));
+  m_epochs.push_back (0);
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&CachedPropagationLossModel::CourseChanged, this));
+  if (!m_sparse && index >= m_maxTableSize)
+    {
+      NS_LOG_DEBUG ("switching to a hash table for " << index + 1 << " mobility models");
+      m_sparse = true;
+      for (uint32_t i = 0; i < m_tableSize; i++)
+        {
+          for (uint32_t j = 0; j < m_tableSize; j++)
+            {
+              const Entry &entry = m_table[i * m_tableSize + j];
+              if (!std::isnan (entry.txPowerDbm))
+                {
+                  SparseEntry sparse = { entry, m_epochs[i], m_epochs[j] };
+                  m_sparseTable[(static_cast<uint64_t> (i) << 32) | j] = sparse;
+                }
+            }
+        }
+      std::vector<Entry> ().swap (m_table);
+      m_tableSize = 0;
+    }
+  if (!m_sparse && index >= m_tableSize)
+    {
+      // double the size of the table, keeping the entries already computed
+      uint32_t size = std::min (std::max<uint32_t> (16, 2 * m_tableSize), m_maxTableSize);
+      Entry invalid = { std::numeric_limits<double>::quiet_NaN (), 0.0 };
+      std::vector<Entry> table (size * size, invalid);
+      for (uint32_t i = 0; i < m_tableSize; i++)
+        {
+          std::copy (m_table.begin () + i * m_tableSize, m_table.begin () + (i + 1) * m_tableSize,
+                     table.begin () + i * size);
+        }
+      m_table.swap (table);
+      m_tableSize = size;
+    }
+  return index;
+}
+
+void
+CachedPropagationLossModel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_indexes.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_indexes.end ());
+  uint32_t index = it->second;
+  m_static[index] = IsStatic (mobility);
+  // the entries of the hash table computed before this change are recognized by their epoch
+  m_epochs[index]++;
+  if (m_sparse)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_mobilities.size (); i++)
+    {
+      m_table[index * m_tableSize + i].txPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+      m_table[i * m_tableSize + index].txPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+    }
+}
+
+CachedPropagationLossModel::Entry &
+CachedPropagationLossModel::GetEntry (uint32_t ia, uint32_t ib) const
+{
+  if (!m_sparse)
+    {
+      return m_table[ia * m_tableSize + ib];
+    }
+  std::pair<std::unordered_map<uint64_t, SparseEntry>::iterator, bool> inserted =
+    m_sparseTable.insert (std::make_pair ((static_cast<uint64_t> (ia) << 32) | ib, SparseEntry ()));
+  SparseEntry &sparse = inserted.first->second;
+  if (inserted.second || sparse.epochA != m_epochs[ia] || sparse.epochB != m_epochs[ib])
+    {
+      sparse.entry.txPowerDbm = std::numeric_limits<double>::quiet_NaN ();
+      sparse.epochA = m_epochs[ia];
+      sparse.epochB = m_epochs[ib];
+    }
+  return sparse.entry;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_lossModel != 0, "CachedPropagationLossModel::DoCalcRxPower(): no loss model set");
+  uint32_t ia = GetIndex (a);
+  uint32_t ib = GetIndex (b);
+  if (!m_static[ia] || !m_static[ib])
+    {
+      m_misses++;
+      return m_lossModel->CalcRxPower (txPowerDbm, a, b);
+    }
+
+  Entry &entry = GetEntry (ia, ib);
+  if (entry.txPowerDbm == txPowerDbm)
+    {
+      m_hits++;
+      return entry.rxPowerDbm;
+    }
+  if (!std::isnan (entry.txPowerDbm))
+    {
+      // the loss of a deterministic chain does not depend on the transmit power
+      m_hits++;
+      return txPowerDbm + (entry.rxPowerDbm - entry.txPowerDbm);
+    }
+  m_misses++;
+  entry.txPowerDbm = txPowerDbm;
+  entry.rxPowerDbm = m_lossModel->CalcRxPower (txPowerDbm, a, b);
+  return entry.rxPowerDbm;
+}
+
+double
+CachedPropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (m_lossModel == 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  return m_lossModel->GetMaxRange (txPowerDbm, minRxPowerDbm);
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_lossModel == 0)
+    {
+      return 0;
+    }
+  return m_lossModel->AssignStreams (stream);
+}
+
+bool
+CachedPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+} // namespace ns3
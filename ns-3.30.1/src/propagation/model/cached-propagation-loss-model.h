@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include <unordered_map>
+#include <vector>
+#include "propagation-loss-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the loss of a deterministic chain of loss models between
+ * each pair of mobility models.
+ *
+ * The chain set with SetLossModel must be deterministic (see
+ * PropagationLossModel::IsDeterministic), as are the Friis, TwoRayGround,
+ * LogDistance, ThreeLogDistance, Cost231, ItuR1411, OkumuraHata and
+ * Kun2600Mhz models.  The mobility models are given dense indexes in the
+ * order they are first seen, and the loss between two of them is stored in
+ * a flat table indexed by the pair of indexes.  The flat table is grown up
+ * to MaxTableSize rows and columns; the model then switches to a hash table
+ * holding only the pairs which are evaluated, so that the memory used by
+ * large topologies, whose channels only evaluate the pairs in range, does
+ * not grow with the square of the number of nodes.  An entry is only used while
+ * both mobility models are static, that is while their velocity is zero;
+ * it is invalidated when either of them notifies a course change, as
+ * SetPosition does.  The loss of the other pairs is computed by the chain
+ * every time.
+ *
+ * Random models, such as Nakagami fading, can be chained after this model
+ * with SetNext, and are evaluated after the cached loss is applied.
+ *
+ * This model keeps a state which is not protected against concurrent
+ * accesses, and is therefore never evaluated in parallel (see
+ * PropagationLossModel::IsThreadSafe).
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the deterministic chain of loss models whose loss is cached
+   */
+  void SetLossModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the chain of loss models whose loss is cached
+   */
+  Ptr<PropagationLossModel> GetLossModel (void) const;
+
+  /**
+   * \return the number of evaluations which read the loss from the cache
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \return the number of evaluations which computed the loss with the chain
+   */
+  uint64_t GetMisses (void) const;
+  /**
+   * \return the fraction of the evaluations which read the loss from the cache
+   */
+  double GetHitRate (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsDeterministic (void) const;
+
+  /**
+   * \param mobility a mobility model
+   * \return the index of the mobility model, assigned if it is seen for the first time
+   */
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+  /**
+   * Invalidate the entries of a mobility model whose course changed.
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+  /**
+   * \param mobility a mobility model
+   * \return true if the velocity of the mobility model is zero
+   */
+  static bool IsStatic (Ptr<const MobilityModel> mobility);
+
+  /// The loss between two mobility models
+  struct Entry
+  {
+    double txPowerDbm;  //!< the transmit power of the evaluation, NaN if the entry is invalid
+    double rxPowerDbm;  //!< the Rx power returned by the chain for txPowerDbm
+  };
+
+  /// The loss between two mobility models, in the hash table
+  struct SparseEntry
+  {
+    Entry entry;        //!< the loss
+    uint32_t epochA;    //!< the epoch of the transmitter when the loss was computed
+    uint32_t epochB;    //!< the epoch of the receiver when the loss was computed
+  };
+
+  /**
+   * \param ia the index of the transmitter
+   * \param ib the index of the receiver
+   * \return the entry of the pair, invalid if its loss must be computed
+   */
+  Entry & GetEntry (uint32_t ia, uint32_t ib) const;
+
+  Ptr<PropagationLossModel> m_lossModel;                      //!< the cached chain of loss models
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_indexes; //!< the index of each mobility model
+  mutable std::vector<Ptr<MobilityModel> > m_mobilities;      //!< the mobility models, by index
+  mutable std::vector<bool> m_static;                         //!< whether each mobility model is static
+  mutable std::vector<Entry> m_table;                         //!< the loss from each index to each index
+  mutable uint32_t m_tableSize;                               //!< the number of rows and columns of m_table
+  uint32_t m_maxTableSize;                                    //!< the largest number of rows and columns of m_table
+  mutable bool m_sparse;                                      //!< whether the losses are in m_sparseTable
+  mutable std::unordered_map<uint64_t, SparseEntry> m_sparseTable; //!< the loss of each evaluated pair of indexes
+  mutable std::vector<uint32_t> m_epochs;                     //!< the number of course changes of each mobility model
+  mutable uint64_t m_hits;                                    //!< the number of cache hits
+  mutable uint64_t m_misses;                                  //!< the number of cache misses
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -180,4 +180,16 @@ Cost231PropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+Cost231PropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+Cost231PropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 }
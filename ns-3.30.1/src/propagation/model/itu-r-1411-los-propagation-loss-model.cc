@@ -107,4 +107,16 @@ ItuR1411LosPropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
+
+bool
+ItuR1411LosPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+ItuR1411LosPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
 } // namespace ns3
@@ -226,5 +226,17 @@ ItuR1411NlosOverRooftopPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+ItuR1411NlosOverRooftopPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+ItuR1411NlosOverRooftopPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 
 } // namespace ns3
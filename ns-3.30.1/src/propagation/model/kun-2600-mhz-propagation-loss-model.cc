@@ -77,5 +77,17 @@ Kun2600MhzPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+Kun2600MhzPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+Kun2600MhzPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 
 } // namespace ns3
@@ -80,6 +80,8 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual bool DoIsDeterministic (void) const;
   
 };
 
@@ -158,5 +158,17 @@ OkumuraHataPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+OkumuraHataPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+OkumuraHataPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 
 } // namespace ns3
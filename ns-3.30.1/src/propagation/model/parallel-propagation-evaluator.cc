@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "parallel-propagation-evaluator.h"
+#include "propagation-loss-model.h"
+#include "propagation-delay-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ParallelPropagationEvaluator");
+
+const uint32_t ParallelPropagationEvaluator::NO_RECEIVER;
+
+/// The index of the receiver for which the calling thread evaluates the propagation models
+static thread_local uint32_t g_currentReceiver = ParallelPropagationEvaluator::NO_RECEIVER;
+
+ParallelPropagationEvaluator::ParallelPropagationEvaluator ()
+  : m_loss (0),
+    m_delay (0),
+    m_txPowerDbm (0),
+    m_receiverIds (0),
+    m_rxPowerDbm (0),
+    m_delays (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_task = MakeCallback (&ParallelPropagationEvaluator::EvaluateRange, this);
+}
+
+ParallelPropagationEvaluator::~ParallelPropagationEvaluator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ParallelPropagationEvaluator::SetNThreads (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+  m_pool.SetNThreads (nThreads);
+}
+
+uint32_t
+ParallelPropagationEvaluator::GetNThreads (void) const
+{
+  return m_pool.GetNThreads ();
+}
+
+bool
+ParallelPropagationEvaluator::CanEvaluate (Ptr<const PropagationLossModel> loss, Ptr<const PropagationDelayModel> delay) const
+{
+  return m_pool.GetNThreads () > 1
+         && (loss == 0 || loss->IsThreadSafe ())
+         && (delay == 0 || delay->IsThreadSafe ());
+}
+
+uint32_t
+ParallelPropagationEvaluator::GetCurrentReceiver (void)
+{
+  return g_currentReceiver;
+}
+
+Ptr<RandomVariableStream>
+ParallelPropagationEvaluator::CreateReceiverVariable (Ptr<RandomVariableStream> variable)
+{
+  NS_LOG_FUNCTION (variable);
+  TypeId tid = variable->GetInstanceTypeId ();
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  for (TypeId t = tid; ; t = t.GetParent ())
+    {
+      for (uint32_t i = 0; i < t.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = t.GetAttribute (i);
+          // the new variable gets its own stream
+          if ((info.flags & TypeId::ATTR_CONSTRUCT) && (info.flags & TypeId::ATTR_GET)
+              && info.name != "Stream")
+            {
+              Ptr<AttributeValue> value = info.checker->Create ();
+              variable->GetAttribute (info.name, *value);
+              factory.Set (info.name, *value);
+            }
+        }
+      if (t == RandomVariableStream::GetTypeId ())
+        {
+          break;
+        }
+    }
+  return factory.Create<RandomVariableStream> ();
+}
+
+void
+ParallelPropagationEvaluator::Evaluate (Ptr<PropagationLossModel> loss, Ptr<PropagationDelayModel> delay,
+                                        double txPowerDbm, Ptr<MobilityModel> sender,
+                                        const std::vector<uint32_t> &receiverIds,
+                                        const std::vector<Ptr<MobilityModel> > &receivers,
+                                        std::vector<double> &rxPowerDbm, std::vector<Time> &delays)
+{
+  NS_LOG_FUNCTION (this << loss << delay << txPowerDbm << sender << receiverIds.size ());
+  NS_ASSERT (receiverIds.size () == receivers.size ());
+  // everything creating objects or changing reference counts is done here,
+  // from the main thread
+  uint32_t nReceivers = 0;
+  for (std::size_t i = 0; i < receiverIds.size (); i++)
+    {
+      NS_ASSERT (receiverIds[i] != NO_RECEIVER);
+      nReceivers = std::max (nReceivers, receiverIds[i] + 1);
+    }
+  if (loss != 0)
+    {
+      loss->PrepareParallelEvaluation (nReceivers);
+    }
+  if (delay != 0)
+    {
+      delay->PrepareParallelEvaluation (nReceivers);
+    }
+  while (m_senders.size () < m_pool.GetNThreads ())
+    {
+      m_senders.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  while (m_receivers.size () < nReceivers)
+    {
+      m_receivers.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  Vector senderPosition = sender->GetPosition ();
+  for (uint32_t i = 0; i < m_pool.GetNThreads (); i++)
+    {
+      m_senders[i]->SetPosition (senderPosition);
+    }
+  for (std::size_t i = 0; i < receiverIds.size (); i++)
+    {
+      m_receivers[receiverIds[i]]->SetPosition (receivers[i]->GetPosition ());
+    }
+  rxPowerDbm.resize (receiverIds.size ());
+  delays.resize (receiverIds.size ());
+
+  m_loss = PeekPointer (loss);
+  m_delay = PeekPointer (delay);
+  m_txPowerDbm = txPowerDbm;
+  m_receiverIds = &receiverIds;
+  m_rxPowerDbm = &rxPowerDbm;
+  m_delays = &delays;
+  m_pool.Run (receiverIds.size (), m_task);
+  m_loss = 0;
+  m_delay = 0;
+  m_receiverIds = 0;
+  m_rxPowerDbm = 0;
+  m_delays = 0;
+}
+
+void
+ParallelPropagationEvaluator::EvaluateRange (uint32_t thread, uint32_t begin, uint32_t end)
+{
+  // each proxy is only used by a single thread, which can change its reference count
+  Ptr<MobilityModel> sender = m_senders[thread];
+  for (uint32_t i = begin; i < end; i++)
+    {
+      uint32_t id = (*m_receiverIds)[i];
+      Ptr<MobilityModel> receiver = m_receivers[id];
+      g_currentReceiver = id;
+      (*m_rxPowerDbm)[i] = m_loss != 0 ? m_loss->CalcRxPower (m_txPowerDbm, sender, receiver) : m_txPowerDbm;
+      (*m_delays)[i] = m_delay != 0 ? m_delay->GetDelay (sender, receiver) : Seconds (0);
+    }
+  g_currentReceiver = NO_RECEIVER;
+}
+
+} // namespace ns3
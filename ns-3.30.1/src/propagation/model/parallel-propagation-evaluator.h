@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARALLEL_PROPAGATION_EVALUATOR_H
+#define PARALLEL_PROPAGATION_EVALUATOR_H
+
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/thread-pool.h"
+
+namespace ns3 {
+
+class MobilityModel;
+class ConstantPositionMobilityModel;
+class PropagationLossModel;
+class PropagationDelayModel;
+class RandomVariableStream;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Computes the propagation loss and delay from a sender to many
+ * receivers with several threads.
+ *
+ * Channels use this class to evaluate the propagation models for all the
+ * receivers of a transmission in parallel, before scheduling the receptions
+ * in order from the main thread.  Each receiver is identified by an index,
+ * which must be stable across transmissions and lower than the number of
+ * receivers of the channel, since the loss and delay models which draw
+ * random variables use one stream per receiver index (see
+ * PropagationLossModel::PrepareParallelEvaluation).  The values drawn for
+ * a receiver then only depend on its index and on the order of the
+ * transmissions, not on the number of threads.
+ *
+ * The models are not given the mobility models of the nodes, which are
+ * shared with the rest of the simulation and whose reference counts cannot
+ * be changed concurrently, but ConstantPositionMobilityModel proxies
+ * located at the current positions of the sender and of the receivers.
+ * Only the models whose IsThreadSafe method returns true can therefore be
+ * evaluated in parallel; the others must be evaluated by the channel
+ * itself.
+ */
+class ParallelPropagationEvaluator
+{
+public:
+  ParallelPropagationEvaluator ();
+  ~ParallelPropagationEvaluator ();
+
+  /**
+   * \param nThreads the number of threads evaluating the propagation models,
+   *        including the main thread
+   */
+  void SetNThreads (uint32_t nThreads);
+  /**
+   * \return the number of threads evaluating the propagation models,
+   *         including the main thread
+   */
+  uint32_t GetNThreads (void) const;
+  /**
+   * \param loss the propagation loss model, or null if none
+   * \param delay the propagation delay model, or null if none
+   * \return true if more than one thread is configured and both models are
+   *         thread-safe
+   */
+  bool CanEvaluate (Ptr<const PropagationLossModel> loss, Ptr<const PropagationDelayModel> delay) const;
+  /**
+   * Compute the reception power and the propagation delay of a
+   * transmission for each receiver.
+   *
+   * \param loss the propagation loss model, or null if none
+   * \param delay the propagation delay model, or null if none
+   * \param txPowerDbm the transmission power (dBm)
+   * \param sender the mobility model of the sender
+   * \param receiverIds the stable indexes of the receivers
+   * \param receivers the mobility models of the receivers
+   * \param rxPowerDbm the reception power at each receiver (dBm), or the
+   *        transmission power if there is no loss model
+   * \param delays the propagation delay to each receiver, or zero if there
+   *        is no delay model
+   */
+  void Evaluate (Ptr<PropagationLossModel> loss, Ptr<PropagationDelayModel> delay,
+                 double txPowerDbm, Ptr<MobilityModel> sender,
+                 const std::vector<uint32_t> &receiverIds,
+                 const std::vector<Ptr<MobilityModel> > &receivers,
+                 std::vector<double> &rxPowerDbm, std::vector<Time> &delays);
+
+  /**
+   * \return the index of the receiver for which the propagation models
+   *         are evaluated by the calling thread, or NO_RECEIVER outside
+   *         of a parallel evaluation
+   */
+  static uint32_t GetCurrentReceiver (void);
+  /**
+   * Create a new random variable with the same type and attributes as the
+   * given one, but using its own, automatically assigned, stream.
+   *
+   * \param variable the random variable to clone
+   * \return the new random variable
+   */
+  static Ptr<RandomVariableStream> CreateReceiverVariable (Ptr<RandomVariableStream> variable);
+
+  /// The value returned by GetCurrentReceiver outside of a parallel evaluation
+  static const uint32_t NO_RECEIVER = 0xffffffff;
+
+private:
+  /**
+   * Evaluate the propagation models for a range of receivers.
+   *
+   * \param thread the index of the calling thread
+   * \param begin the index of the first receiver
+   * \param end the index past the last receiver
+   */
+  void EvaluateRange (uint32_t thread, uint32_t begin, uint32_t end);
+
+  ThreadPool m_pool;                                                //!< the threads
+  ThreadPool::Task m_task;                                          //!< the task evaluating a range of receivers
+  std::vector<Ptr<ConstantPositionMobilityModel> > m_senders;       //!< the proxies of the sender, per thread
+  std::vector<Ptr<ConstantPositionMobilityModel> > m_receivers;     //!< the proxies of the receivers, per receiver index
+  // the state of the current evaluation
+  const PropagationLossModel *m_loss;       //!< the propagation loss model
+  const PropagationDelayModel *m_delay;     //!< the propagation delay model
+  double m_txPowerDbm;                      //!< the transmission power (dBm)
+  const std::vector<uint32_t> *m_receiverIds; //!< the indexes of the receivers
+  std::vector<double> *m_rxPowerDbm;        //!< the reception powers (dBm)
+  std::vector<Time> *m_delays;              //!< the propagation delays
+};
+
+} // namespace ns3
+
+#endif /* PARALLEL_PROPAGATION_EVALUATOR_H */
@@ -18,10 +18,15 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "propagation-delay-model.h"
+#include "parallel-propagation-evaluator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/mobility-position-store.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -47,6 +52,64 @@ PropagationDelayModel::AssignStreams (int64_t stream)
   return DoAssignStreams (stream);
 }
 
+void
+PropagationDelayModel::GetDelays (Ptr<MobilityModel> a,
+                                  const std::vector<Ptr<MobilityModel> > &b,
+                                  const std::vector<Vector> &positions,
+                                  std::vector<Time> &delays) const
+{
+  NS_ASSERT (b.size () == positions.size ());
+  delays.resize (b.size ());
+  DoGetDelays (a, b, positions, delays);
+}
+
+void
+PropagationDelayModel::DoGetDelays (Ptr<MobilityModel> a,
+                                    const std::vector<Ptr<MobilityModel> > &b,
+                                    const std::vector<Vector> &positions,
+                                    std::vector<Time> &delays) const
+{
+  for (std::size_t i = 0; i < b.size (); i++)
+    {
+      delays[i] = GetDelay (a, b[i]);
+    }
+}
+
+bool
+PropagationDelayModel::IsThreadSafe (void) const
+{
+  return DoIsThreadSafe ();
+}
+
+void
+PropagationDelayModel::PrepareParallelEvaluation (uint32_t nReceivers)
+{
+  DoPrepareParallelEvaluation (nReceivers);
+}
+
+bool
+PropagationDelayModel::DoIsThreadSafe (void) const
+{
+  return false;
+}
+
+Time
+PropagationDelayModel::GetMinimumDelay (const std::vector<Ptr<MobilityModel> > &models) const
+{
+  return DoGetMinimumDelay (models);
+}
+
+Time
+PropagationDelayModel::DoGetMinimumDelay (const std::vector<Ptr<MobilityModel> > &models) const
+{
+  return Seconds (0);
+}
+
+void
+PropagationDelayModel::DoPrepareParallelEvaluation (uint32_t nReceivers)
+{
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationDelayModel);
@@ -76,7 +139,9 @@ RandomPropagationDelayModel::~RandomPropagationDelayModel ()
 Time
 RandomPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
-  return Seconds (m_variable->GetValue ());
+  uint32_t receiver = ParallelPropagationEvaluator::GetCurrentReceiver ();
+  const Ptr<RandomVariableStream> &variable = receiver < m_receiverVariables.size () ? m_receiverVariables[receiver] : m_variable;
+  return Seconds (variable->GetValue ());
 }
 
 int64_t
@@ -86,6 +151,21 @@ RandomPropagationDelayModel::DoAssignStreams (int64_t stream)
   return 1;
 }
 
+bool
+RandomPropagationDelayModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+void
+RandomPropagationDelayModel::DoPrepareParallelEvaluation (uint32_t nReceivers)
+{
+  while (m_receiverVariables.size () < nReceivers)
+    {
+      m_receiverVariables.push_back (ParallelPropagationEvaluator::CreateReceiverVariable (m_variable));
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED (ConstantSpeedPropagationDelayModel);
 
 TypeId
@@ -113,6 +193,53 @@ ConstantSpeedPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<Mobility
   double seconds = distance / m_speed;
   return Seconds (seconds);
 }
+
+void
+ConstantSpeedPropagationDelayModel::DoGetDelays (Ptr<MobilityModel> a,
+                                                 const std::vector<Ptr<MobilityModel> > &b,
+                                                 const std::vector<Vector> &positions,
+                                                 std::vector<Time> &delays) const
+{
+  Vector from = MobilityPositionStore::Get ()->GetPosition (a->GetPositionIndex ());
+  for (std::size_t i = 0; i < positions.size (); i++)
+    {
+      double x = positions[i].x - from.x;
+      double y = positions[i].y - from.y;
+      double z = positions[i].z - from.z;
+      // as MobilityModel::GetDistanceFrom
+      double distance = std::sqrt (x * x + y * y + z * z);
+      delays[i] = Seconds (distance / m_speed);
+    }
+}
+Time
+ConstantSpeedPropagationDelayModel::DoGetMinimumDelay (const std::vector<Ptr<MobilityModel> > &models) const
+{
+  std::vector<Vector> positions;
+  for (std::size_t i = 0; i < models.size (); i++)
+    {
+      Vector velocity = models[i]->GetVelocity ();
+      if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+        {
+          // the distances change
+          return Seconds (0);
+        }
+      positions.push_back (models[i]->GetPosition ());
+    }
+  double minDistance = std::numeric_limits<double>::infinity ();
+  for (std::size_t i = 0; i < positions.size (); i++)
+    {
+      for (std::size_t j = i + 1; j < positions.size (); j++)
+        {
+          minDistance = std::min (minDistance, CalculateDistance (positions[i], positions[j]));
+        }
+    }
+  if (std::isinf (minDistance))
+    {
+      return Seconds (0);
+    }
+  return Seconds (minDistance / m_speed);
+}
+
 void
 ConstantSpeedPropagationDelayModel::SetSpeed (double speed)
 {
@@ -130,5 +257,11 @@ ConstantSpeedPropagationDelayModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+ConstantSpeedPropagationDelayModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
 
 } // namespace ns3
@@ -24,6 +24,8 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -52,6 +54,22 @@ public:
    * source and destination.
    */
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const = 0;
+  /**
+   * Calculate the propagation delays between the specified source and
+   * several destinations.  The delay of each destination is the one
+   * GetDelay returns, but the models which override DoGetDelays evaluate
+   * all the destinations in a single loop over their positions; the others
+   * are invoked once per destination.
+   *
+   * \param a the source
+   * \param b the destinations
+   * \param positions the positions of the destinations
+   * \param delays the propagation delays, resized to the number of destinations
+   */
+  void GetDelays (Ptr<MobilityModel> a,
+                  const std::vector<Ptr<MobilityModel> > &b,
+                  const std::vector<Vector> &positions,
+                  std::vector<Time> &delays) const;
   /**
    * If this delay model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -62,12 +80,71 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+  /**
+   * \returns true if GetDelay can be invoked concurrently from several
+   *          threads for distinct receivers (see ParallelPropagationEvaluator)
+   */
+  bool IsThreadSafe (void) const;
+  /**
+   * Prepares this delay model for concurrent invocations of GetDelay for
+   * the receivers with indexes lower than nReceivers.  This method must be
+   * invoked from the main thread.
+   *
+   * \param nReceivers the number of receivers
+   */
+  void PrepareParallelEvaluation (uint32_t nReceivers);
+  /**
+   * Calculate a lower bound of the propagation delay between any two of
+   * the given nodes, valid as long as they do not move.  The bound is
+   * computed without drawing any random variable.
+   *
+   * \param models the mobility models of the nodes
+   * \returns the lower bound, or zero if this delay model does not know one
+   */
+  Time GetMinimumDelay (const std::vector<Ptr<MobilityModel> > &models) const;
 private:
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
    */
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
+  /**
+   * Calculate the propagation delays to several destinations.  The default
+   * implementation invokes GetDelay for each destination in turn.
+   *
+   * \param a the source
+   * \param b the destinations
+   * \param positions the positions of the destinations
+   * \param delays the propagation delays, already resized to the number of destinations
+   */
+  virtual void DoGetDelays (Ptr<MobilityModel> a,
+                            const std::vector<Ptr<MobilityModel> > &b,
+                            const std::vector<Vector> &positions,
+                            std::vector<Time> &delays) const;
+  /**
+   * Subclasses whose GetDelay only reads the positions of the mobility
+   * models and their own state, or draws its random variables from the
+   * per-receiver streams created by DoPrepareParallelEvaluation, can return
+   * true.  The default implementation returns false.
+   *
+   * \returns true if this delay model is thread-safe
+   */
+  virtual bool DoIsThreadSafe (void) const;
+  /**
+   * Prepares this delay model for concurrent invocations of GetDelay.
+   * The default implementation does nothing.
+   *
+   * \param nReceivers the number of receivers
+   */
+  virtual void DoPrepareParallelEvaluation (uint32_t nReceivers);
+  /**
+   * Calculate a lower bound of the propagation delay between the nodes.
+   * The default implementation returns zero.
+   *
+   * \param models the mobility models of the nodes
+   * \returns the lower bound
+   */
+  virtual Time DoGetMinimumDelay (const std::vector<Ptr<MobilityModel> > &models) const;
 };
 
 /**
@@ -92,7 +169,10 @@ public:
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 private:
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual void DoPrepareParallelEvaluation (uint32_t nReceivers);
   Ptr<RandomVariableStream> m_variable; //!< random generator
+  std::vector<Ptr<RandomVariableStream> > m_receiverVariables; //!< per-receiver random generators of the parallel evaluations
 };
 
 /**
@@ -124,6 +204,12 @@ public:
   double GetSpeed (void) const;
 private:
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual void DoGetDelays (Ptr<MobilityModel> a,
+                            const std::vector<Ptr<MobilityModel> > &b,
+                            const std::vector<Vector> &positions,
+                            std::vector<Time> &delays) const;
+  virtual bool DoIsThreadSafe (void) const;
+  virtual Time DoGetMinimumDelay (const std::vector<Ptr<MobilityModel> > &models) const;
   double m_speed; //!< speed
 };
 
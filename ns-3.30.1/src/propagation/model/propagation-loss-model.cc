@@ -22,18 +22,35 @@
  */
 
 #include "propagation-loss-model.h"
+#include "parallel-propagation-evaluator.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
+#include "ns3/mobility-position-store.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <cmath>
+#include <limits>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModel");
 
+/**
+ * \param a a position
+ * \param b another position
+ * \return the distance between a and b, computed as MobilityModel::GetDistanceFrom does
+ */
+static inline double
+GetDistance (const Vector &a, const Vector &b)
+{
+  double x = b.x - a.x;
+  double y = b.y - a.y;
+  double z = b.z - a.z;
+  return std::sqrt (x * x + y * y + z * z);
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (PropagationLossModel);
@@ -82,6 +99,57 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowers (double txPowerDbm,
+                                    Ptr<MobilityModel> a,
+                                    const std::vector<Ptr<MobilityModel> > &b,
+                                    const std::vector<Vector> &positions,
+                                    std::vector<double> &rxPowersDbm) const
+{
+  NS_ASSERT (b.size () == positions.size ());
+  rxPowersDbm.assign (b.size (), txPowerDbm);
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowers (a, b, positions, rxPowersDbm);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                      const std::vector<Ptr<MobilityModel> > &b,
+                                      const std::vector<Vector> &positions,
+                                      std::vector<double> &powersDbm) const
+{
+  for (std::size_t i = 0; i < b.size (); i++)
+    {
+      powersDbm[i] = DoCalcRxPower (powersDbm[i], a, b[i]);
+    }
+}
+
+double
+PropagationLossModel::GetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  double range = DoGetMaxRange (txPowerDbm, minRxPowerDbm);
+  if (m_next != 0)
+    {
+      // every model in the chain must be bounded (and hence never amplify
+      // the signal) for the smallest bound to hold for the whole chain
+      double nextRange = m_next->GetMaxRange (txPowerDbm, minRxPowerDbm);
+      if (std::isinf (range) || std::isinf (nextRange))
+        {
+          return std::numeric_limits<double>::infinity ();
+        }
+      range = std::min (range, nextRange);
+    }
+  return range;
+}
+
+double
+PropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -94,6 +162,45 @@ PropagationLossModel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+bool
+PropagationLossModel::IsThreadSafe (void) const
+{
+  return DoIsThreadSafe () && (m_next == 0 || m_next->IsThreadSafe ());
+}
+
+void
+PropagationLossModel::PrepareParallelEvaluation (uint32_t nReceivers)
+{
+  DoPrepareParallelEvaluation (nReceivers);
+  if (m_next != 0)
+    {
+      m_next->PrepareParallelEvaluation (nReceivers);
+    }
+}
+
+bool
+PropagationLossModel::IsDeterministic (void) const
+{
+  return DoIsDeterministic () && (m_next == 0 || m_next->IsDeterministic ());
+}
+
+bool
+PropagationLossModel::DoIsThreadSafe (void) const
+{
+  return false;
+}
+
+void
+PropagationLossModel::DoPrepareParallelEvaluation (uint32_t nReceivers)
+{
+}
+
+bool
+PropagationLossModel::DoIsDeterministic (void) const
+{
+  return false;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationLossModel);
@@ -126,7 +233,9 @@ RandomPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                            Ptr<MobilityModel> a,
                                            Ptr<MobilityModel> b) const
 {
-  double rxc = -m_variable->GetValue ();
+  uint32_t receiver = ParallelPropagationEvaluator::GetCurrentReceiver ();
+  const Ptr<RandomVariableStream> &variable = receiver < m_receiverVariables.size () ? m_receiverVariables[receiver] : m_variable;
+  double rxc = -variable->GetValue ();
   NS_LOG_DEBUG ("attenuation coefficient="<<rxc<<"Db");
   return txPowerDbm + rxc;
 }
@@ -138,6 +247,21 @@ RandomPropagationLossModel::DoAssignStreams (int64_t stream)
   return 1;
 }
 
+bool
+RandomPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+void
+RandomPropagationLossModel::DoPrepareParallelEvaluation (uint32_t nReceivers)
+{
+  while (m_receiverVariables.size () < nReceivers)
+    {
+      m_receiverVariables.push_back (ParallelPropagationEvaluator::CreateReceiverVariable (m_variable));
+    }
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (FriisPropagationLossModel);
@@ -271,12 +395,71 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+void
+FriisPropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                           const std::vector<Ptr<MobilityModel> > &b,
+                                           const std::vector<Vector> &positions,
+                                           std::vector<double> &powersDbm) const
+{
+  // the same computation as DoCalcRxPower, in a loop without calls nor
+  // logging which the compiler can vectorize
+  Vector from = MobilityPositionStore::Get ()->GetPosition (a->GetPositionIndex ());
+  double numerator = m_lambda * m_lambda;
+  const Vector *position = positions.data ();
+  double *power = powersDbm.data ();
+  for (std::size_t i = 0; i < positions.size (); i++)
+    {
+      double distance = GetDistance (from, position[i]);
+      double denominator = 16 * M_PI * M_PI * distance * distance * m_systemLoss;
+      double lossDb = -10 * log10 (numerator / denominator);
+      power[i] = distance <= 0 ? power[i] - m_minLoss : power[i] - std::max (lossDb, m_minLoss);
+    }
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+FriisPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+FriisPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+double
+FriisPropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (m_minLoss < 0 || m_systemLoss <= 0)
+    {
+      // the model may return more power than it is given
+      return std::numeric_limits<double>::infinity ();
+    }
+  double budgetDb = txPowerDbm - minRxPowerDbm;
+  if (budgetDb < m_minLoss)
+    {
+      return 0;
+    }
+  /*
+   * Invert the Friis equation for a loss equal to the budget:
+   *
+   *          lambda       10^(budget/10)
+   * d = ---------- sqrt (----------------)
+   *       4 * pi               L
+   *
+   * A slightly larger value is returned to guard against rounding errors.
+   */
+  double range = m_lambda / (4 * M_PI) * std::sqrt (std::pow (10.0, budgetDb / 10.0) / m_systemLoss);
+  return range * (1 + 1e-9);
+}
+
 // ------------------------------------------------------------------------- //
 // -- Two-Ray Ground Model ported from NS-2 -- tomhewer@mac.com -- Nov09 //
 
@@ -451,6 +634,18 @@ TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+TwoRayGroundPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+TwoRayGroundPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (LogDistancePropagationLossModel);
@@ -534,12 +729,63 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+void
+LogDistancePropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                                 const std::vector<Ptr<MobilityModel> > &b,
+                                                 const std::vector<Vector> &positions,
+                                                 std::vector<double> &powersDbm) const
+{
+  Vector from = MobilityPositionStore::Get ()->GetPosition (a->GetPositionIndex ());
+  const Vector *position = positions.data ();
+  double *power = powersDbm.data ();
+  for (std::size_t i = 0; i < positions.size (); i++)
+    {
+      double distance = GetDistance (from, position[i]);
+      double pathLossDb = 10 * m_exponent * std::log10 (distance / m_referenceDistance);
+      double rxc = -m_referenceLoss - pathLossDb;
+      power[i] = distance <= m_referenceDistance ? power[i] - m_referenceLoss : power[i] + rxc;
+    }
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+LogDistancePropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+LogDistancePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+double
+LogDistancePropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (m_referenceLoss < 0 || m_exponent < 0)
+    {
+      // the model may return more power than it is given
+      return std::numeric_limits<double>::infinity ();
+    }
+  double budgetDb = txPowerDbm - minRxPowerDbm;
+  if (budgetDb < m_referenceLoss)
+    {
+      return 0;
+    }
+  if (m_exponent == 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  double range = m_referenceDistance * std::pow (10.0, (budgetDb - m_referenceLoss) / (10 * m_exponent));
+  return range * (1 + 1e-9);
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeLogDistancePropagationLossModel);
@@ -642,6 +888,60 @@ ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+ThreeLogDistancePropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+bool
+ThreeLogDistancePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+double
+ThreeLogDistancePropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (m_referenceLoss < 0 || m_exponent0 < 0 || m_exponent1 < 0 || m_exponent2 < 0
+      || m_distance0 <= 0 || m_distance1 < m_distance0 || m_distance2 < m_distance1)
+    {
+      // the model may return more power than it is given
+      return std::numeric_limits<double>::infinity ();
+    }
+  double budgetDb = txPowerDbm - minRxPowerDbm;
+  if (budgetDb < 0)
+    {
+      return 0;
+    }
+  if (budgetDb < m_referenceLoss)
+    {
+      // no loss below the first field
+      return m_distance0;
+    }
+  // path loss at the beginning of the middle and of the far fields
+  double loss1Db = m_referenceLoss + 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0);
+  double loss2Db = loss1Db + 10 * m_exponent1 * std::log10 (m_distance2 / m_distance1);
+  double range;
+  if (budgetDb < loss1Db)
+    {
+      range = m_distance0 * std::pow (10.0, (budgetDb - m_referenceLoss) / (10 * m_exponent0));
+    }
+  else if (budgetDb < loss2Db)
+    {
+      range = m_distance1 * std::pow (10.0, (budgetDb - loss1Db) / (10 * m_exponent1));
+    }
+  else if (m_exponent2 > 0)
+    {
+      range = m_distance2 * std::pow (10.0, (budgetDb - loss2Db) / (10 * m_exponent2));
+    }
+  else
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  return range * (1 + 1e-9);
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (NakagamiPropagationLossModel);
@@ -733,11 +1033,17 @@ NakagamiPropagationLossModel::DoCalcRxPower (double txPowerDbm,
 
   if (int_m == m)
     {
-      resultPowerW = m_erlangRandomVariable->GetValue (int_m, powerW / m);
+      uint32_t receiver = ParallelPropagationEvaluator::GetCurrentReceiver ();
+      const Ptr<ErlangRandomVariable> &variable = receiver < m_receiverErlangRandomVariables.size () ?
+        m_receiverErlangRandomVariables[receiver] : m_erlangRandomVariable;
+      resultPowerW = variable->GetValue (int_m, powerW / m);
     }
   else
     {
-      resultPowerW = m_gammaRandomVariable->GetValue (m, powerW / m);
+      uint32_t receiver = ParallelPropagationEvaluator::GetCurrentReceiver ();
+      const Ptr<GammaRandomVariable> &variable = receiver < m_receiverGammaRandomVariables.size () ?
+        m_receiverGammaRandomVariables[receiver] : m_gammaRandomVariable;
+      resultPowerW = variable->GetValue (m, powerW / m);
     }
 
   double resultPowerDbm = 10 * std::log10 (resultPowerW) + 30;
@@ -757,6 +1063,22 @@ NakagamiPropagationLossModel::DoAssignStreams (int64_t stream)
   return 2;
 }
 
+bool
+NakagamiPropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+void
+NakagamiPropagationLossModel::DoPrepareParallelEvaluation (uint32_t nReceivers)
+{
+  while (m_receiverErlangRandomVariables.size () < nReceivers)
+    {
+      m_receiverErlangRandomVariables.push_back (CreateObject<ErlangRandomVariable> ());
+      m_receiverGammaRandomVariables.push_back (CreateObject<GammaRandomVariable> ());
+    }
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (FixedRssLossModel);
@@ -804,6 +1126,12 @@ FixedRssLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+FixedRssLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (MatrixPropagationLossModel);
@@ -924,12 +1252,43 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+void
+RangePropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                           const std::vector<Ptr<MobilityModel> > &b,
+                                           const std::vector<Vector> &positions,
+                                           std::vector<double> &powersDbm) const
+{
+  Vector from = MobilityPositionStore::Get ()->GetPosition (a->GetPositionIndex ());
+  const Vector *position = positions.data ();
+  double *power = powersDbm.data ();
+  for (std::size_t i = 0; i < positions.size (); i++)
+    {
+      power[i] = GetDistance (from, position[i]) <= m_range ? power[i] : -1000;
+    }
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+RangePropagationLossModel::DoIsThreadSafe (void) const
+{
+  return true;
+}
+
+double
+RangePropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (minRxPowerDbm <= -1000)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  return m_range;
+}
+
 // ------------------------------------------------------------------------- //
 
 } // namespace ns3
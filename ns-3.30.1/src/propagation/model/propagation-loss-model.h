@@ -27,7 +27,9 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -93,6 +95,40 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * Computes the Rx power at several destinations, taking into account all
+   * the PropagationLossModel(s) chained to the current one.  The result for
+   * each destination is the one CalcRxPower returns, but the models which
+   * override DoCalcRxPowers evaluate all the destinations in a single loop
+   * over their positions; the others are invoked once per destination.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param positions the positions of the destinations
+   * \param rxPowersDbm the reception powers (in dBm), resized to the number of destinations
+   */
+  void CalcRxPowers (double txPowerDbm,
+                     Ptr<MobilityModel> a,
+                     const std::vector<Ptr<MobilityModel> > &b,
+                     const std::vector<Vector> &positions,
+                     std::vector<double> &rxPowersDbm) const;
+
+  /**
+   * Returns a distance beyond which the Rx power returned by CalcRxPower,
+   * taking into account all the PropagationLossModel(s) chained to the
+   * current one, is guaranteed to be lower than minRxPowerDbm.
+   *
+   * Channels can use this bound to skip receivers which cannot possibly
+   * detect a transmission.  The bound is finite only if every model in
+   * the chain provides one.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param minRxPowerDbm the reception power threshold (in dBm)
+   * \returns the maximum range (in meters), or infinity if unbounded
+   */
+  double GetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -106,6 +142,38 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Returns true if CalcRxPower can be invoked concurrently from several
+   * threads for distinct receivers (see ParallelPropagationEvaluator),
+   * taking into account all the PropagationLossModel(s) chained to the
+   * current one.
+   *
+   * \returns true if every model in the chain is thread-safe
+   */
+  bool IsThreadSafe (void) const;
+
+  /**
+   * Prepares this model and the models chained to it for concurrent
+   * invocations of CalcRxPower for the receivers with indexes lower than
+   * nReceivers.  Models drawing random variables create one stream per
+   * receiver, so that the values drawn for a receiver do not depend on the
+   * number of threads.  This method must be invoked from the main thread.
+   *
+   * \param nReceivers the number of receivers
+   */
+  void PrepareParallelEvaluation (uint32_t nReceivers);
+
+  /**
+   * Returns true if the Rx power returned by CalcRxPower is the transmit
+   * power minus a loss which only depends on the positions of the mobility
+   * models, taking into account all the PropagationLossModel(s) chained to
+   * the current one.  The loss of such a chain can be cached until one of
+   * the mobility models moves (see CachedPropagationLossModel).
+   *
+   * \returns true if every model in the chain is deterministic
+   */
+  bool IsDeterministic (void) const;
+
 private:
   /**
    * \brief Copy constructor
@@ -134,12 +202,70 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Applies only this particular PropagationLossModel to the powers at
+   * several destinations.  The default implementation invokes DoCalcRxPower
+   * for each destination in turn.
+   *
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param positions the positions of the destinations
+   * \param powersDbm the powers at the destinations (in dBm), before and after this model
+   */
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               const std::vector<Vector> &positions,
+                               std::vector<double> &powersDbm) const;
+
+  /**
+   * Returns a distance beyond which this particular PropagationLossModel
+   * returns less than minRxPowerDbm for any input power lower than or
+   * equal to txPowerDbm.
+   *
+   * A model may return a finite value only if it never returns more power
+   * than it is given, so that the bounds of chained models can be combined.
+   * The default implementation returns infinity (no bound known).
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param minRxPowerDbm the reception power threshold (in dBm)
+   * \returns the maximum range (in meters), or infinity if unbounded
+   */
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
+
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
    */
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
+  /**
+   * Returns true if DoCalcRxPower only reads the positions of the mobility
+   * models and the state of this particular PropagationLossModel, or draws
+   * its random variables from the per-receiver streams created by
+   * DoPrepareParallelEvaluation.  The default implementation returns false.
+   *
+   * \returns true if this particular model is thread-safe
+   */
+  virtual bool DoIsThreadSafe (void) const;
+
+  /**
+   * Prepares this particular PropagationLossModel for concurrent invocations
+   * of DoCalcRxPower.  The default implementation does nothing.
+   *
+   * \param nReceivers the number of receivers
+   */
+  virtual void DoPrepareParallelEvaluation (uint32_t nReceivers);
+
+  /**
+   * Returns true if DoCalcRxPower returns the transmit power minus a loss
+   * which only depends on the positions of the mobility models and on the
+   * attributes of this particular PropagationLossModel.  The default
+   * implementation returns false.
+   *
+   * \returns true if this particular model is deterministic
+   */
+  virtual bool DoIsDeterministic (void) const;
+
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
 };
 
@@ -178,7 +304,10 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual void DoPrepareParallelEvaluation (uint32_t nReceivers);
   Ptr<RandomVariableStream> m_variable; //!< random generator
+  std::vector<Ptr<RandomVariableStream> > m_receiverVariables; //!< per-receiver random generators of the parallel evaluations
 };
 
 /**
@@ -321,7 +450,14 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               const std::vector<Vector> &positions,
+                               std::vector<double> &powersDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -442,6 +578,8 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual bool DoIsDeterministic (void) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -529,7 +667,14 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               const std::vector<Vector> &positions,
+                               std::vector<double> &powersDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
 
   /**
    *  Creates a default reference loss model
@@ -613,6 +758,9 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
 
   double m_distance0; //!< Beginning of the first (near) distance field
   double m_distance1; //!< Beginning of the second (middle) distance field.
@@ -684,6 +832,8 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual void DoPrepareParallelEvaluation (uint32_t nReceivers);
 
   double m_distance1; //!< Distance1
   double m_distance2; //!< Distance2
@@ -694,6 +844,8 @@ private:
 
   Ptr<ErlangRandomVariable>  m_erlangRandomVariable; //!< Erlang random variable
   Ptr<GammaRandomVariable> m_gammaRandomVariable;    //!< Gamma random variable
+  std::vector<Ptr<ErlangRandomVariable> > m_receiverErlangRandomVariables; //!< per-receiver Erlang random variables of the parallel evaluations
+  std::vector<Ptr<GammaRandomVariable> > m_receiverGammaRandomVariables;   //!< per-receiver Gamma random variables of the parallel evaluations
 };
 
 /**
@@ -747,6 +899,7 @@ private:
                                 Ptr<MobilityModel> b) const;
 
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
   double m_rss; //!< the received signal strength
 };
 
@@ -851,7 +1004,13 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               const std::vector<Vector> &positions,
+                               std::vector<double> &powersDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool DoIsThreadSafe (void) const;
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
 private:
   double m_range; //!< Maximum Transmission Range (meters)
 };
@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/cost231-propagation-loss-model.h"
+#include "ns3/cached-propagation-loss-model.h"
+
+using namespace ns3;
+
+/**
+ * \brief Check that CachedPropagationLossModel returns the loss of the
+ * chain it wraps, and only reuses it while the nodes do not move.
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  /**
+   * \param maxTableSize the MaxTableSize attribute of the cache
+   */
+  CachedPropagationLossModelTestCase (uint32_t maxTableSize);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the cached and the direct evaluations between all the nodes.
+   */
+  void CheckAll (void);
+
+  uint32_t m_maxTableSize;                       //!< the MaxTableSize attribute of the cache
+  Ptr<PropagationLossModel> m_chain;             //!< the deterministic chain
+  Ptr<CachedPropagationLossModel> m_cache;       //!< the cache of the chain
+  std::vector<Ptr<MobilityModel> > m_nodes;      //!< the mobility models of the nodes
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase (uint32_t maxTableSize)
+  : TestCase ("Check the cached loss of a deterministic chain with at most " +
+              std::to_string (maxTableSize) + " nodes in the flat table"),
+    m_maxTableSize (maxTableSize)
+{
+}
+
+void
+CachedPropagationLossModelTestCase::CheckAll (void)
+{
+  for (uint32_t i = 0; i < m_nodes.size (); i++)
+    {
+      for (uint32_t j = 0; j < m_nodes.size (); j++)
+        {
+          if (i != j)
+            {
+              NS_TEST_EXPECT_MSG_EQ (m_cache->CalcRxPower (16.0, m_nodes[i], m_nodes[j]),
+                                     m_chain->CalcRxPower (16.0, m_nodes[i], m_nodes[j]),
+                                     "Unexpected cached Rx power at " << Simulator::Now ().GetSeconds ()
+                                     << " between " << i << " and " << j);
+            }
+        }
+    }
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  m_chain = CreateObject<LogDistancePropagationLossModel> ();
+  m_chain->SetNext (CreateObject<Cost231PropagationLossModel> ());
+  NS_TEST_ASSERT_MSG_EQ (m_chain->IsDeterministic (), true, "Chain of deterministic models");
+  Ptr<PropagationLossModel> fadingChain = CreateObject<LogDistancePropagationLossModel> ();
+  fadingChain->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  NS_TEST_ASSERT_MSG_EQ (fadingChain->IsDeterministic (), false,
+                         "A chain including a random model is not deterministic");
+
+  m_cache = CreateObject<CachedPropagationLossModel> ();
+  m_cache->SetAttribute ("MaxTableSize", UintegerValue (m_maxTableSize));
+  m_cache->SetLossModel (m_chain);
+
+  // enough nodes to grow the table, or to switch to the hash table
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<MobilityModel> node = CreateObject<ConstantPositionMobilityModel> ();
+      node->SetPosition (Vector (5.0 * i, 3.0 * (i % 4), 1.5));
+      m_nodes.push_back (node);
+    }
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (0.0, 10.0, 1.5));
+  moving->SetVelocity (Vector (2.0, 0.0, 0.0));
+  m_nodes.push_back (moving);
+
+  uint64_t nPairs = m_nodes.size () * (m_nodes.size () - 1);
+  uint64_t nMovingPairs = 2 * (m_nodes.size () - 1);
+  CheckAll ();
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetHits (), 0, "No hit on the first evaluation");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetMisses (), nPairs, "Unexpected number of misses");
+
+  // the moving node is evaluated again, the static ones are read from the cache
+  Simulator::Schedule (Seconds (1), &CachedPropagationLossModelTestCase::CheckAll, this);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetHits (), nPairs - nMovingPairs, "Unexpected number of hits");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetMisses (), nPairs + nMovingPairs, "Unexpected number of misses");
+
+  // a node which moves invalidates its entries
+  m_nodes[3]->SetPosition (Vector (7.0, 70.0, 3.0));
+  moving->SetVelocity (Vector (0.0, 0.0, 0.0));
+  uint64_t misses = m_cache->GetMisses ();
+  CheckAll ();
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetMisses () - misses, 4 * (m_nodes.size () - 2) + 2,
+                         "The entries of the moved nodes must be computed again");
+  misses = m_cache->GetMisses ();
+  CheckAll ();
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetMisses (), misses, "All the nodes are static");
+
+  // the loss does not depend on the transmit power
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_cache->CalcRxPower (20.0, m_nodes[0], m_nodes[1]),
+                             m_chain->CalcRxPower (20.0, m_nodes[0], m_nodes[1]), 1e-9,
+                             "Unexpected Rx power for another transmit power");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->GetMisses (), misses, "Cache hit for another transmit power");
+  NS_TEST_EXPECT_MSG_GT (m_cache->GetHitRate (), 0.5, "Unexpected hit rate");
+
+  Simulator::Destroy ();
+  m_cache->Dispose ();
+  m_nodes.clear ();
+}
+
+/**
+ * \brief CachedPropagationLossModel TestSuite
+ */
+class CachedPropagationLossModelTestSuite : public TestSuite
+{
+public:
+  CachedPropagationLossModelTestSuite ();
+};
+
+CachedPropagationLossModelTestSuite::CachedPropagationLossModelTestSuite ()
+  : TestSuite ("cached-propagation-loss-model", UNIT)
+{
+  AddTestCase (new CachedPropagationLossModelTestCase (1024), TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase (8), TestCase::QUICK);
+}
+
+static CachedPropagationLossModelTestSuite g_cachedPropagationLossModelTestSuite; ///< the test suite
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/parallel-propagation-evaluator.h"
+
+using namespace ns3;
+
+/**
+ * \brief Check that the parallel evaluation of thread-safe models gives
+ * the same results as the serial evaluation.
+ */
+class ParallelPropagationDeterministicTestCase : public TestCase
+{
+public:
+  ParallelPropagationDeterministicTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ParallelPropagationDeterministicTestCase::ParallelPropagationDeterministicTestCase ()
+  : TestCase ("Check the parallel evaluation of deterministic propagation models")
+{
+}
+
+void
+ParallelPropagationDeterministicTestCase::DoRun (void)
+{
+  Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+  loss->SetNext (CreateObject<ThreeLogDistancePropagationLossModel> ());
+  Ptr<ConstantSpeedPropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  NS_TEST_ASSERT_MSG_EQ (loss->IsThreadSafe (), true, "Chain of thread-safe models");
+  NS_TEST_ASSERT_MSG_EQ (delay->IsThreadSafe (), true, "Thread-safe delay model");
+  NS_TEST_ASSERT_MSG_EQ (CreateObject<MatrixPropagationLossModel> ()->IsThreadSafe (), false,
+                         "The matrix model is not thread-safe");
+  Ptr<LogDistancePropagationLossModel> fadingChain = CreateObject<LogDistancePropagationLossModel> ();
+  fadingChain->SetNext (CreateObject<JakesPropagationLossModel> ());
+  NS_TEST_ASSERT_MSG_EQ (fadingChain->IsThreadSafe (), false,
+                         "A chain including a model which is not thread-safe is not thread-safe");
+
+  Ptr<MobilityModel> sender = CreateObject<ConstantPositionMobilityModel> ();
+  sender->SetPosition (Vector (10.0, 20.0, 1.5));
+  std::vector<uint32_t> ids;
+  std::vector<Ptr<MobilityModel> > receivers;
+  for (uint32_t i = 0; i < 23; i++)
+    {
+      Ptr<MobilityModel> receiver = CreateObject<ConstantPositionMobilityModel> ();
+      receiver->SetPosition (Vector (3.0 * i * i, 40.0 - 7.0 * i, 1.5));
+      // the indexes do not need to be contiguous nor sorted
+      ids.push_back (30 - i);
+      receivers.push_back (receiver);
+    }
+
+  // the same evaluator restarts its threads when their number changes
+  ParallelPropagationEvaluator evaluator;
+  for (uint32_t nThreads : {1, 2, 4, 7, 3})
+    {
+      evaluator.SetNThreads (nThreads);
+      NS_TEST_ASSERT_MSG_EQ (evaluator.CanEvaluate (loss, delay), (nThreads > 1), "Unexpected CanEvaluate result");
+      NS_TEST_ASSERT_MSG_EQ (evaluator.CanEvaluate (fadingChain, delay), false, "Unexpected CanEvaluate result");
+      std::vector<double> rxPowerDbm;
+      std::vector<Time> delays;
+      evaluator.Evaluate (loss, delay, 20.0, sender, ids, receivers, rxPowerDbm, delays);
+      NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), receivers.size (), "One reception power per receiver");
+      NS_TEST_ASSERT_MSG_EQ (delays.size (), receivers.size (), "One delay per receiver");
+      for (std::size_t i = 0; i < receivers.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[i], loss->CalcRxPower (20.0, sender, receivers[i]),
+                                 "Reception power differs from the serial evaluation for receiver " << i);
+          NS_TEST_EXPECT_MSG_EQ (delays[i], delay->GetDelay (sender, receivers[i]),
+                                 "Delay differs from the serial evaluation for receiver " << i);
+        }
+      evaluator.Evaluate (0, 0, 20.0, sender, ids, receivers, rxPowerDbm, delays);
+      for (std::size_t i = 0; i < receivers.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[i], 20.0, "No loss without loss model");
+          NS_TEST_EXPECT_MSG_EQ (delays[i], Seconds (0), "No delay without delay model");
+        }
+    }
+}
+
+/**
+ * \brief Check that the models drawing random variables use one stream per
+ * receiver, independently of the number of threads.
+ */
+class ParallelPropagationRandomTestCase : public TestCase
+{
+public:
+  ParallelPropagationRandomTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ParallelPropagationRandomTestCase::ParallelPropagationRandomTestCase ()
+  : TestCase ("Check the per-receiver random variables of the parallel evaluation")
+{
+}
+
+void
+ParallelPropagationRandomTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> sender = CreateObject<ConstantPositionMobilityModel> ();
+  std::vector<Ptr<MobilityModel> > allReceivers;
+  for (uint32_t i = 0; i < 17; i++)
+    {
+      Ptr<MobilityModel> receiver = CreateObject<ConstantPositionMobilityModel> ();
+      receiver->SetPosition (Vector (i, 0.0, 0.0));
+      allReceivers.push_back (receiver);
+    }
+
+  for (uint32_t nThreads : {1, 2, 4, 7})
+    {
+      // every per-receiver clone of these variables draws 0, 1, 2...
+      Ptr<SequentialRandomVariable> lossVariable = CreateObject<SequentialRandomVariable> ();
+      lossVariable->SetAttribute ("Min", DoubleValue (0.0));
+      lossVariable->SetAttribute ("Max", DoubleValue (100.0));
+      lossVariable->SetAttribute ("Increment", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      Ptr<RandomPropagationLossModel> loss = CreateObject<RandomPropagationLossModel> ();
+      loss->SetAttribute ("Variable", PointerValue (lossVariable));
+      Ptr<SequentialRandomVariable> delayVariable = CreateObject<SequentialRandomVariable> ();
+      delayVariable->SetAttribute ("Min", DoubleValue (0.0));
+      delayVariable->SetAttribute ("Max", DoubleValue (100.0));
+      delayVariable->SetAttribute ("Increment", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      Ptr<RandomPropagationDelayModel> delay = CreateObject<RandomPropagationDelayModel> ();
+      delay->SetAttribute ("Variable", PointerValue (delayVariable));
+      NS_TEST_ASSERT_MSG_EQ (loss->IsThreadSafe (), true, "Random loss model is thread-safe");
+      NS_TEST_ASSERT_MSG_EQ (delay->IsThreadSafe (), true, "Random delay model is thread-safe");
+
+      ParallelPropagationEvaluator evaluator;
+      evaluator.SetNThreads (nThreads);
+      std::vector<uint32_t> nDraws (allReceivers.size (), 0);
+      for (uint32_t round = 0; round < 6; round++)
+        {
+          // a different subset of the receivers in each round
+          std::vector<uint32_t> ids;
+          std::vector<Ptr<MobilityModel> > receivers;
+          for (uint32_t i = 0; i < allReceivers.size (); i++)
+            {
+              if ((i + round) % 3 != 0)
+                {
+                  ids.push_back (i);
+                  receivers.push_back (allReceivers[i]);
+                }
+            }
+          std::vector<double> rxPowerDbm;
+          std::vector<Time> delays;
+          evaluator.Evaluate (loss, delay, 10.0, sender, ids, receivers, rxPowerDbm, delays);
+          for (std::size_t j = 0; j < ids.size (); j++)
+            {
+              uint32_t k = nDraws[ids[j]]++;
+              NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[j], 10.0 - k, "Unexpected loss for receiver " << ids[j]
+                                     << " in round " << round << " with " << nThreads << " threads");
+              NS_TEST_EXPECT_MSG_EQ (delays[j], Seconds (k), "Unexpected delay for receiver " << ids[j]
+                                     << " in round " << round << " with " << nThreads << " threads");
+            }
+        }
+      // the serial evaluations still use the variable of the model
+      NS_TEST_EXPECT_MSG_EQ (loss->CalcRxPower (10.0, sender, allReceivers[0]), 10.0,
+                             "The serial evaluation uses the variable of the model");
+    }
+}
+
+/**
+ * \brief Parallel propagation evaluation test suite
+ */
+class ParallelPropagationTestSuite : public TestSuite
+{
+public:
+  ParallelPropagationTestSuite ();
+};
+
+ParallelPropagationTestSuite::ParallelPropagationTestSuite ()
+  : TestSuite ("parallel-propagation", UNIT)
+{
+  AddTestCase (new ParallelPropagationDeterministicTestCase, TestCase::QUICK);
+  AddTestCase (new ParallelPropagationRandomTestCase, TestCase::QUICK);
+}
+
+static ParallelPropagationTestSuite g_parallelPropagationTestSuite; ///< the test suite
@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +437,173 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class MaxRangePropagationLossModelTestCase : public TestCase
+{
+public:
+  MaxRangePropagationLossModelTestCase ();
+  virtual ~MaxRangePropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that the Rx power is below the threshold just beyond the
+   * maximum range reported by the model, and above it just within
+   * \param model the loss model to check
+   * \param txPowerDbm the transmit power (dBm)
+   * \param minRxPowerDbm the reception threshold (dBm)
+   */
+  void CheckMaxRange (Ptr<PropagationLossModel> model, double txPowerDbm, double minRxPowerDbm);
+};
+
+MaxRangePropagationLossModelTestCase::MaxRangePropagationLossModelTestCase ()
+  : TestCase ("Test the maximum range bound of propagation loss models")
+{
+}
+
+MaxRangePropagationLossModelTestCase::~MaxRangePropagationLossModelTestCase ()
+{
+}
+
+void
+MaxRangePropagationLossModelTestCase::CheckMaxRange (Ptr<PropagationLossModel> model, double txPowerDbm, double minRxPowerDbm)
+{
+  double range = model->GetMaxRange (txPowerDbm, minRxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (std::isinf (range), false, "Expected a finite range");
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (range * 1.001, 0, 0));
+  NS_TEST_EXPECT_MSG_LT (model->CalcRxPower (txPowerDbm, a, b), minRxPowerDbm, "Rx power beyond the maximum range is above the threshold");
+  b->SetPosition (Vector (range * 0.999, 0, 0));
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (model->CalcRxPower (txPowerDbm, a, b), minRxPowerDbm, "Maximum range is not tight");
+}
+
+void
+MaxRangePropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  CheckMaxRange (friis, 16.0206, -82);
+
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  CheckMaxRange (logDistance, 16.0206, -82);
+  CheckMaxRange (logDistance, 20, -101);
+
+  Ptr<ThreeLogDistancePropagationLossModel> threeLog = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  CheckMaxRange (threeLog, 16.0206, -62);  // near field
+  CheckMaxRange (threeLog, 16.0206, -82);  // middle field
+  CheckMaxRange (threeLog, 16.0206, -101); // far field
+
+  // the range of a chain is bounded by its most restrictive model
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (50.0));
+  logDistance->SetNext (range);
+  NS_TEST_EXPECT_MSG_EQ_TOL (logDistance->GetMaxRange (16.0206, -82), 50.0, 1e-9, "Unexpected range of the chain");
+
+  // a random model in the chain makes the whole chain unbounded
+  Ptr<NakagamiPropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  range->SetNext (nakagami);
+  NS_TEST_EXPECT_MSG_EQ (std::isinf (logDistance->GetMaxRange (16.0206, -82)), true, "Chain with a fading model should be unbounded");
+  Simulator::Destroy ();
+}
+
+class BatchPropagationLossModelTestCase : public TestCase
+{
+public:
+  BatchPropagationLossModelTestCase ();
+  virtual ~BatchPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that the batch evaluation of a chain returns exactly the Rx
+   * powers of the evaluations of each pair
+   * \param batch the chain evaluated in a batch
+   * \param serial an identical chain evaluated for each pair
+   */
+  void CheckRxPowers (Ptr<PropagationLossModel> batch, Ptr<PropagationLossModel> serial);
+
+  Ptr<MobilityModel> m_sender;                   //!< the sender
+  std::vector<Ptr<MobilityModel> > m_receivers;  //!< the receivers
+  std::vector<Vector> m_positions;               //!< the positions of the receivers
+};
+
+BatchPropagationLossModelTestCase::BatchPropagationLossModelTestCase ()
+  : TestCase ("Test the batch evaluation of propagation loss and delay models")
+{
+}
+
+BatchPropagationLossModelTestCase::~BatchPropagationLossModelTestCase ()
+{
+}
+
+void
+BatchPropagationLossModelTestCase::CheckRxPowers (Ptr<PropagationLossModel> batch, Ptr<PropagationLossModel> serial)
+{
+  batch->AssignStreams (1);
+  serial->AssignStreams (1);
+  std::vector<double> rxPowersDbm;
+  batch->CalcRxPowers (16.0206, m_sender, m_receivers, m_positions, rxPowersDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowersDbm.size (), m_receivers.size (), "Unexpected number of Rx powers");
+  for (std::size_t i = 0; i < m_receivers.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxPowersDbm[i], serial->CalcRxPower (16.0206, m_sender, m_receivers[i]),
+                             "Unexpected Rx power of receiver " << i << " of " << batch->GetInstanceTypeId ().GetName ());
+    }
+}
+
+void
+BatchPropagationLossModelTestCase::DoRun (void)
+{
+  m_sender = CreateObject<ConstantPositionMobilityModel> ();
+  m_sender->SetPosition (Vector (3.5, -2.0, 1.5));
+  for (uint32_t i = 0; i < 37; i++)
+    {
+      Ptr<MobilityModel> receiver = CreateObject<ConstantPositionMobilityModel> ();
+      // including a receiver at the position of the sender, and some within
+      // the reference distance of the log distance model
+      receiver->SetPosition (Vector (3.5 + 0.7 * i * i, -2.0 + 0.3 * i, 1.5));
+      m_receivers.push_back (receiver);
+      m_positions.push_back (receiver->GetPosition ());
+    }
+
+  CheckRxPowers (CreateObject<FriisPropagationLossModel> (), CreateObject<FriisPropagationLossModel> ());
+  CheckRxPowers (CreateObject<LogDistancePropagationLossModel> (), CreateObject<LogDistancePropagationLossModel> ());
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (100.0));
+  Ptr<RangePropagationLossModel> serialRange = CreateObject<RangePropagationLossModel> ();
+  serialRange->SetAttribute ("MaxRange", DoubleValue (100.0));
+  CheckRxPowers (range, serialRange);
+
+  // the models without a batch implementation are evaluated for each receiver
+  Ptr<PropagationLossModel> chain = CreateObject<LogDistancePropagationLossModel> ();
+  chain->SetNext (CreateObject<ThreeLogDistancePropagationLossModel> ());
+  chain->GetNext ()->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  Ptr<PropagationLossModel> serialChain = CreateObject<LogDistancePropagationLossModel> ();
+  serialChain->SetNext (CreateObject<ThreeLogDistancePropagationLossModel> ());
+  serialChain->GetNext ()->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  CheckRxPowers (chain, serialChain);
+
+  Ptr<ConstantSpeedPropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  std::vector<Time> delays;
+  delay->GetDelays (m_sender, m_receivers, m_positions, delays);
+  NS_TEST_ASSERT_MSG_EQ (delays.size (), m_receivers.size (), "Unexpected number of delays");
+  for (std::size_t i = 0; i < m_receivers.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (delays[i], delay->GetDelay (m_sender, m_receivers[i]), "Unexpected delay of receiver " << i);
+    }
+  Ptr<RandomPropagationDelayModel> randomDelay = CreateObject<RandomPropagationDelayModel> ();
+  Ptr<RandomPropagationDelayModel> serialRandomDelay = CreateObject<RandomPropagationDelayModel> ();
+  randomDelay->AssignStreams (1);
+  serialRandomDelay->AssignStreams (1);
+  randomDelay->GetDelays (m_sender, m_receivers, m_positions, delays);
+  for (std::size_t i = 0; i < m_receivers.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (delays[i], serialRandomDelay->GetDelay (m_sender, m_receivers[i]), "Unexpected random delay of receiver " << i);
+    }
+  m_receivers.clear ();
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +618,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new MaxRangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BatchPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -29,7 +29,9 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/uinteger.h>
 #include <ns3/mobility-model.h>
+#include <ns3/mobility-position-store.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
 #include <ns3/spectrum-propagation-loss-model.h>
@@ -90,6 +92,7 @@ MultiModelSpectrumChannel::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_rxPhySpectrumModelUids.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -100,11 +103,31 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("PropagationThreads",
+                   "The number of threads computing the propagation loss and delay towards the "
+                   "receivers of a transmission, if the propagation models are thread-safe. "
+                   "With a single thread, the propagation models are evaluated serially.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultiModelSpectrumChannel::SetPropagationThreads,
+                                         &MultiModelSpectrumChannel::GetPropagationThreads),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
+void
+MultiModelSpectrumChannel::SetPropagationThreads (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+  m_evaluator.SetNThreads (nThreads);
+}
+
+uint32_t
+MultiModelSpectrumChannel::GetPropagationThreads (void) const
+{
+  return m_evaluator.GetNThreads ();
+}
+
 void
 MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
@@ -117,20 +140,26 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
   SpectrumModelUid_t rxSpectrumModelUid = rxSpectrumModel->GetUid ();
 
   // remove a previous entry of this phy if it exists
-  // we need to scan for all rxSpectrumModel values since we don't
-  // know which spectrum model the phy had when it was previously added
-  // (it's probably different than the current one)
-  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
-       rxInfoIterator !=  m_rxSpectrumModelInfoMap.end ();
-       ++rxInfoIterator)
+  std::map<Ptr<SpectrumPhy>, SpectrumModelUid_t>::iterator previousUid = m_rxPhySpectrumModelUids.find (phy);
+  uint32_t phyId;
+  if (previousUid != m_rxPhySpectrumModelUids.end ())
     {
-      auto phyIt = std::find (rxInfoIterator->second.m_rxPhys.begin(), rxInfoIterator->second.m_rxPhys.end(), phy);
-      if (phyIt != rxInfoIterator->second.m_rxPhys.end ())
-        {
-          rxInfoIterator->second.m_rxPhys.erase (phyIt);
-          --m_numDevices;
-          break; // there should be at most one entry
-        }       
+      RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.find (previousUid->second);
+      NS_ASSERT (rxInfoIterator != m_rxSpectrumModelInfoMap.end ());
+      auto phyIt = std::find (rxInfoIterator->second.m_rxPhys.begin (), rxInfoIterator->second.m_rxPhys.end (), phy);
+      NS_ASSERT (phyIt != rxInfoIterator->second.m_rxPhys.end ());
+      // the phy keeps its index
+      auto phyIdIt = rxInfoIterator->second.m_rxPhyIds.begin () + (phyIt - rxInfoIterator->second.m_rxPhys.begin ());
+      phyId = *phyIdIt;
+      rxInfoIterator->second.m_rxPhys.erase (phyIt);
+      rxInfoIterator->second.m_rxPhyIds.erase (phyIdIt);
+      --m_numDevices;
+      previousUid->second = rxSpectrumModelUid;
+    }
+  else
+    {
+      phyId = m_rxPhySpectrumModelUids.size ();
+      m_rxPhySpectrumModelUids.insert (std::make_pair (phy, rxSpectrumModelUid));
     }
 
   ++m_numDevices;
@@ -145,6 +174,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       NS_ASSERT (ret.second);
       // also add the phy to the newly created set of SpectrumPhy for this RxSpectrumModel
       ret.first->second.m_rxPhys.push_back (phy);
+      ret.first->second.m_rxPhyIds.push_back (phyId);
 
       // and create the necessary converters for all the TX spectrum models that we know of
       for (TxSpectrumModelInfoMap_t::iterator txInfoIterator = m_txSpectrumModelInfoMap.begin ();
@@ -168,6 +198,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     {
       // spectrum model is already known, just add the device to the corresponding list
       rxInfoIterator->second.m_rxPhys.push_back (phy);
+      rxInfoIterator->second.m_rxPhyIds.push_back (phyId);
     }
 }
 
@@ -217,6 +248,9 @@ void
 MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 {
   NS_LOG_FUNCTION (this << txParams);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (m_sendMutex);
+#endif
 
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
@@ -224,6 +258,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   m_txSigParamsTrace (txParamsTrace);
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
   NS_LOG_LOGIC ("txSpectrumModelUid " << txSpectrumModelUid);
 
@@ -260,6 +295,32 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
+      // compute the propagation loss and delay towards all the receivers at once
+      // if they can be computed by several threads
+      bool parallel = txMobility && m_evaluator.CanEvaluate (m_propagationLoss, m_propagationDelay);
+      if (parallel)
+        {
+          const RxSpectrumModelInfo &rxInfo = rxInfoIterator->second;
+          m_receiverIds.clear ();
+          m_receiverMobilities.clear ();
+          for (std::size_t i = 0; i < rxInfo.m_rxPhys.size (); i++)
+            {
+              Ptr<MobilityModel> receiverMobility = rxInfo.m_rxPhys[i]->GetMobility ();
+              if (rxInfo.m_rxPhys[i] != txParams->txPhy && receiverMobility)
+                {
+                  m_receiverIds.push_back (rxInfo.m_rxPhyIds[i]);
+                  m_receiverMobilities.push_back (receiverMobility);
+                }
+            }
+          m_evaluator.Evaluate (m_propagationLoss, m_propagationDelay, 0, txMobility,
+                                m_receiverIds, m_receiverMobilities, m_propagationGainsDb, m_delays);
+          m_receiverMobilities.clear ();
+        }
+      // the index of the next result of the parallel evaluation
+      std::size_t nextResult = 0;
+      // the signal parameters shared by the receivers of this SpectrumModel
+      Ptr<SpectrumSignalParameters> rxModelParams;
+
       for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
            ++rxPhyIterator)
@@ -269,37 +330,37 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC ("copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
+              double pathGainLinear = 1.0;
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
               if (txMobility && receiverMobility)
                 {
+                  std::size_t result = nextResult++;
                   double txAntennaGain = 0;
                   double rxAntennaGain = 0;
                   double propagationGainDb = 0;
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (txParams->txAntenna != 0)
                     {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      Angles txAngles (store->GetPosition (receiverMobility->GetPositionIndex ()), store->GetPosition (txMobility->GetPositionIndex ()));
+                      txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
                   Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
                   if (rxAntenna != 0)
                     {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+                      Angles rxAngles (store->GetPosition (txMobility->GetPositionIndex ()), store->GetPosition (receiverMobility->GetPositionIndex ()));
                       rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
                       NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
                       pathLossDb -= rxAntennaGain;
                     }
                   if (m_propagationLoss)
                     {
-                      propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                      propagationGainDb = parallel ? m_propagationGainsDb[result]
+                        : m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
                       NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
                       pathLossDb -= propagationGainDb;
                     }                    
@@ -313,33 +374,58 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
+                  pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
 
-                  if (m_spectrumPropagationLoss)
+                  if (m_propagationDelay)
                     {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+                      delay = parallel ? m_delays[result] : m_propagationDelay->GetDelay (txMobility, receiverMobility);
                     }
+                }
 
-                  if (m_propagationDelay)
+              if (rxModelParams == 0)
+                {
+                  // the signal parameters are copied once for all the receivers in range
+                  // of this SpectrumModel, with the TX PSD converted to it; each receiver
+                  // only copies them, scaled by its path gain, when the signal arrives
+                  NS_LOG_LOGIC ("copying signal parameters " << txParams);
+                  rxModelParams = txParams->Copy ();
+                  if (convertedTxPowerSpectrum != txParams->psd)
                     {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+                      rxModelParams->psd = convertedTxPowerSpectrum;
                     }
                 }
 
               Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
+              // the receiver has a NetDevice, so we expect that it is attached to a Node;
+              // if not, we cannot assume that it is attached to a node
+              uint32_t dstNode = netDev ? netDev->GetNode ()->GetId () : 0;
+              if (txMobility && receiverMobility && m_spectrumPropagationLoss)
+                {
+                  // the frequency-dependent loss depends on the positions at the start
+                  // of the transmission, so the received PSD is computed now
+                  Ptr<SpectrumSignalParameters> rxParams = rxModelParams->Copy ();
+                  *(rxParams->psd) *= pathGainLinear;
+                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+                  if (netDev)
+                    {
+                      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                                      rxParams, *rxPhyIterator);
+                    }
+                  else
+                    {
+                      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                                           rxParams, *rxPhyIterator);
+                    }
+                }
+              else if (netDev)
                 {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
+                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRxScaled, this,
+                                                  rxModelParams, pathGainLinear, *rxPhyIterator);
                 }
               else
                 {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
+                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRxScaled, this,
+                                       rxModelParams, pathGainLinear, *rxPhyIterator);
                 }
             }
         }
@@ -355,6 +441,18 @@ MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<Sp
   receiver->StartRx (params);
 }
 
+void
+MultiModelSpectrumChannel::StartRxScaled (Ptr<SpectrumSignalParameters> params, double pathGainLinear, Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this << params << pathGainLinear << receiver);
+  Ptr<SpectrumSignalParameters> rxParams = params->Copy ();
+  if (pathGainLinear != 1.0)
+    {
+      *(rxParams->psd) *= pathGainLinear;
+    }
+  StartRx (rxParams, receiver);
+}
+
 std::size_t
 MultiModelSpectrumChannel::GetNDevices (void) const
 {
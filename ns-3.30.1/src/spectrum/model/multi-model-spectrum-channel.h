@@ -27,6 +27,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/parallel-propagation-evaluator.h>
 #include <map>
 #include <set>
 
@@ -81,6 +82,7 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
   std::vector<Ptr<SpectrumPhy> > m_rxPhys;     //!< Container of the Rx Spectrum phy objects.
+  std::vector<uint32_t> m_rxPhyIds;            //!< Stable index of each Rx Spectrum phy object in the channel.
 };
 
 /**
@@ -102,6 +104,15 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * If the PropagationThreads attribute is higher than one and the
+ * propagation loss and delay models are thread-safe (see
+ * PropagationLossModel::IsThreadSafe), the propagation loss and delay
+ * towards the receivers of each RX SpectrumModel are computed by several
+ * threads (see ParallelPropagationEvaluator).  The antenna gains, the
+ * traces, the SpectrumPropagationLossModel and the scheduling of the
+ * receptions are still handled serially, in the same order as in the
+ * serial case.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -149,6 +160,28 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Used internally to reschedule transmission after the propagation delay,
+   * when the PSD received is the PSD transmitted scaled by the path gain.
+   * The receiver gets a copy of the signal parameters, with the PSD
+   * scaled by the path gain.
+   *
+   * \param params The signal parameters shared by the receivers of the same SpectrumModel,
+   * which are left unchanged.
+   * \param pathGainLinear The path gain towards the receiver.
+   * \param receiver A pointer to the receiver SpectrumPhy.
+   */
+  void StartRxScaled (Ptr<SpectrumSignalParameters> params, double pathGainLinear, Ptr<SpectrumPhy> receiver);
+
+  /**
+   * \param nThreads the number of threads computing the propagation loss and delay
+   */
+  void SetPropagationThreads (uint32_t nThreads);
+  /**
+   * \return the number of threads computing the propagation loss and delay
+   */
+  uint32_t GetPropagationThreads (void) const;
+
   /**
    * Data structure holding, for each TX SpectrumModel,  all the
    * converters to any RX SpectrumModel, and all the corresponding
@@ -164,11 +197,26 @@ private:
    */
   RxSpectrumModelInfoMap_t m_rxSpectrumModelInfoMap;
 
+  /**
+   * Data structure holding, for each SpectrumPhy instance, the uid of the
+   * RX spectrum model it was last added with, so that a SpectrumPhy whose
+   * spectrum model changed can be moved without scanning all the RX
+   * spectrum models.
+   */
+  std::map<Ptr<SpectrumPhy>, SpectrumModelUid_t> m_rxPhySpectrumModelUids;
+
   /**
    * Number of devices connected to the channel.
    */
   std::size_t m_numDevices;
 
+  ParallelPropagationEvaluator m_evaluator; //!< Parallel evaluation of the propagation models
+  // scratch buffers of the parallel evaluation
+  std::vector<uint32_t> m_receiverIds;                   //!< Indexes of the receivers
+  std::vector<Ptr<MobilityModel> > m_receiverMobilities; //!< Mobility models of the receivers
+  std::vector<double> m_propagationGainsDb;              //!< Propagation gains to the receivers (dB)
+  std::vector<Time> m_delays;                            //!< Propagation delays to the receivers
+
 };
 
 
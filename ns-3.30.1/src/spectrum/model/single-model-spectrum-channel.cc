@@ -27,6 +27,7 @@
 #include <ns3/node.h>
 #include <ns3/double.h>
 #include <ns3/mobility-model.h>
+#include <ns3/mobility-position-store.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-loss-model.h>
@@ -83,6 +84,9 @@ void
 SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 {
   NS_LOG_FUNCTION (this << txParams->psd << txParams->duration << txParams->txPhy);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (m_sendMutex);
+#endif
   NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
   NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
 
@@ -105,6 +109,7 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
 
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
@@ -126,7 +131,7 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               double pathLossDb = 0;
               if (rxParams->txAntenna != 0)
                 {
-                  Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+                  Angles txAngles (store->GetPosition (receiverMobility->GetPositionIndex ()), store->GetPosition (senderMobility->GetPositionIndex ()));
                   txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
                   NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                   pathLossDb -= txAntennaGain;
@@ -134,7 +139,7 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
               if (rxAntenna != 0)
                 {
-                  Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+                  Angles rxAngles (store->GetPosition (senderMobility->GetPositionIndex ()), store->GetPosition (receiverMobility->GetPositionIndex ()));
                   rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
                   NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
                   pathLossDb -= rxAntennaGain;
@@ -21,6 +21,8 @@
 #include <ns3/log.h>
 #include <ns3/double.h>
 #include <ns3/pointer.h>
+#include <ns3/net-device.h>
+#include <ns3/node.h>
 
 #include "spectrum-channel.h"
 
@@ -76,6 +78,17 @@ SpectrumChannel::GetTypeId (void)
                    MakePointerAccessor (&SpectrumChannel::m_propagationLoss),
                    MakePointerChecker<PropagationLossModel> ())
 
+    .AddAttribute ("MinimumDelay",
+                   "The smallest propagation delay between the nodes of two devices, which "
+                   "the multithreaded simulator uses as its lookahead to simulate the nodes "
+                   "in several logical processes.  If zero, it is computed by the propagation "
+                   "delay model from the positions of the nodes when the simulation starts, "
+                   "provided none of them moves.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&SpectrumChannel::SetMinimumDelay,
+                                     &SpectrumChannel::GetMinimumDelay),
+                   MakeTimeChecker (Seconds (0)))
+
     .AddTraceSource ("Gain",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The parameters to this trace are : "
@@ -142,6 +155,38 @@ SpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
   m_propagationDelay = delay;
 }
 
+void
+SpectrumChannel::SetMinimumDelay (Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  m_minimumDelay = delay;
+}
+
+Time
+SpectrumChannel::GetMinimumDelay (void) const
+{
+  if (m_minimumDelay.IsStrictlyPositive () || m_propagationDelay == 0)
+    {
+      return m_minimumDelay;
+    }
+  std::vector<Ptr<MobilityModel> > mobilities;
+  for (std::size_t i = 0; i < GetNDevices (); i++)
+    {
+      Ptr<NetDevice> device = GetDevice (i);
+      if (device == 0 || device->GetNode () == 0)
+        {
+          return m_minimumDelay;
+        }
+      Ptr<MobilityModel> mobility = device->GetNode ()->GetObject<MobilityModel> ();
+      if (mobility == 0)
+        {
+          return m_minimumDelay;
+        }
+      mobilities.push_back (mobility);
+    }
+  return m_propagationDelay->GetMinimumDelay (mobilities);
+}
+
 Ptr<SpectrumPropagationLossModel>
 SpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
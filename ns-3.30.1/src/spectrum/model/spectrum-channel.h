@@ -32,6 +32,9 @@
 #include <ns3/spectrum-phy.h>
 #include <ns3/traced-callback.h>
 #include <ns3/mobility-model.h>
+#ifdef NS3_MTP
+#include <mutex>
+#endif
 
 namespace ns3 {
 
@@ -44,6 +47,10 @@ class SpectrumValue;
  *
  * Defines the interface for spectrum-aware channel implementations
  *
+ * The multithreaded simulator (see ns3::MultithreadedSimulatorImpl) may
+ * simulate the nodes of the channel in several logical processes, with the
+ * MinimumDelay attribute as its lookahead.  The transmissions are then
+ * serialized by a mutex, and the propagation models must be deterministic.
  */
 class SpectrumChannel : public Channel
 {
@@ -95,6 +102,18 @@ public:
    */
   Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
+  /**
+   * \param delay the lower bound of the propagation delay between two nodes
+   */
+  void SetMinimumDelay (Time delay);
+  /**
+   * \return the MinimumDelay attribute if positive, or else the lower bound
+   *         of the propagation delay between the nodes of two devices of the
+   *         channel computed by the propagation delay model, which is zero
+   *         if some nodes move
+   */
+  Time GetMinimumDelay (void) const;
+
 
 
   /**
@@ -194,6 +213,18 @@ protected:
    */
   Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
 
+  /**
+   * The MinimumDelay attribute.
+   */
+  Time m_minimumDelay;
+
+#ifdef NS3_MTP
+  /**
+   * Serializes the transmissions of the logical processes of the
+   * multithreaded simulator.
+   */
+  std::mutex m_sendMutex;
+#endif
 
 };
 
@@ -82,21 +82,44 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
+  // only the bands of fvvf between first and last contribute to tvvf,
+  // the values of the other bands being zero: the rows and the
+  // coefficients outside of this range are skipped, which leaves
+  // the sums unchanged
+  uint32_t first;
+  uint32_t length;
+  fvvf->GetNonZeroBands (first, length);
+  if (length == 0)
+    {
+      return tvvf;
+    }
+  size_t last = first + length - 1;
+
+  const double *from = &fvvf->ValuesAt (0);
   Values::iterator tvit = tvvf->ValuesBegin ();
   size_t i = 0; // Index of conversion coefficient
 
   for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin ();
        convIt != m_conversionRowPtr.end ();
-       ++convIt)
+       ++convIt, ++tvit)
     {
+      size_t rowEnd = *convIt;
+      if (i == rowEnd || m_conversionColInd[i] > last || m_conversionColInd[rowEnd - 1] < first)
+        {
+          // the value stays zero
+          i = rowEnd;
+          continue;
+        }
       double sum = 0;
-      while (i < *convIt)
+      for (; i < rowEnd; i++)
         {
-          sum += (*fvvf)[m_conversionColInd.at (i)] * m_conversionMatrix.at (i);
-          i++;
+          size_t col = m_conversionColInd[i];
+          if (col >= first && col <= last)
+            {
+              sum += from[col] * m_conversionMatrix[i];
+            }
         }
       *tvit = sum;
-      ++tvit;
     }
 
   return tvvf;
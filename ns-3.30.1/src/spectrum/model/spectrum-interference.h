@@ -147,6 +147,8 @@ private:
 
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
 
+  SpectrumValue m_sinr; //!< the SINR of the last chunk, reused to avoid allocations
+
 
 
 };
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spectrum-value-pool.h"
+#include <new>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
+namespace {
+
+/**
+ * \ingroup spectrum
+ * \brief A free block, linked to the next free block of its size
+ */
+struct FreeBlock
+{
+  FreeBlock *next; //!< the next free block
+};
+
+/**
+ * \ingroup spectrum
+ * \brief The free blocks of a size
+ *
+ * The free lists only contain plain pointers, so that they are
+ * initialized before any static constructor runs and never destroyed.
+ */
+struct Pool
+{
+  std::size_t size;       //!< the size of the blocks, zero if the pool is unused
+  FreeBlock *freeBlocks;  //!< the free blocks
+  uint32_t nFreeBlocks;   //!< the number of free blocks
+};
+
+#ifdef NS3_MTP
+/// A counter shared by the threads
+typedef std::atomic<uint64_t> Counter;
+// per thread, for the multithreaded simulator
+thread_local Pool g_pools[ns3::SpectrumValuePool::N_POOLS]; //!< the pools
+#else
+/// A counter
+typedef uint64_t Counter;
+Pool g_pools[ns3::SpectrumValuePool::N_POOLS]; //!< the pools
+#endif
+
+Counter g_allocations (0);        //!< number of blocks allocated
+Counter g_systemAllocations (0);  //!< number of blocks taken from the system allocator
+
+/**
+ * \param size the size of a block
+ * \param create whether a pool without free blocks is assigned to the
+ * size if none is
+ * \return the pool of the blocks of this size, or 0
+ */
+inline Pool *
+GetPool (std::size_t size, bool create)
+{
+  if (size < sizeof (FreeBlock))
+    {
+      return 0;
+    }
+  Pool *empty = 0;
+  for (uint32_t i = 0; i < ns3::SpectrumValuePool::N_POOLS; i++)
+    {
+      if (g_pools[i].size == size)
+        {
+          return &g_pools[i];
+        }
+      if (empty == 0 && g_pools[i].freeBlocks == 0)
+        {
+          empty = &g_pools[i];
+        }
+    }
+  if (create && empty != 0)
+    {
+      // the blocks of the previous size still in use will be released
+      // to the system allocator
+      empty->size = size;
+      return empty;
+    }
+  return 0;
+}
+
+} // anonymous namespace
+
+namespace ns3 {
+
+void *
+SpectrumValuePool::Allocate (std::size_t size)
+{
+  g_allocations++;
+  Pool *pool = GetPool (size, true);
+  if (pool != 0 && pool->freeBlocks != 0)
+    {
+      FreeBlock *block = pool->freeBlocks;
+      pool->freeBlocks = block->next;
+      pool->nFreeBlocks--;
+      return block;
+    }
+  g_systemAllocations++;
+  return ::operator new (size);
+}
+
+void
+SpectrumValuePool::Deallocate (void *block, std::size_t size)
+{
+  Pool *pool = GetPool (size, false);
+  if (pool == 0 || pool->nFreeBlocks >= MAX_FREE_BLOCKS)
+    {
+      ::operator delete (block);
+      return;
+    }
+  FreeBlock *freeBlock = static_cast<FreeBlock *> (block);
+  freeBlock->next = pool->freeBlocks;
+  pool->freeBlocks = freeBlock;
+  pool->nFreeBlocks++;
+}
+
+SpectrumValuePool::Statistics
+SpectrumValuePool::GetStatistics (void)
+{
+  Statistics statistics;
+  statistics.allocations = g_allocations;
+  statistics.systemAllocations = g_systemAllocations;
+  return statistics;
+}
+
+} // namespace ns3
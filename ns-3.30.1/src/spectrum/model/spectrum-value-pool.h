@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_VALUE_POOL_H
+#define SPECTRUM_VALUE_POOL_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Recycle the storage of the values of the SpectrumValue instances
+ *
+ * A simulation uses the same few SpectrumModel instances for all its
+ * power spectral densities, so that the storage of the values of a
+ * SpectrumValue is nearly always one of a few sizes.  The pool keeps a
+ * free list for up to N_POOLS sizes, and returns the released blocks of
+ * these sizes to their free list instead of the system allocator, up to
+ * MAX_FREE_BLOCKS blocks per size.  A new size takes over a free list
+ * which is empty; when all the free lists hold blocks, the blocks of
+ * the new size are allocated by the system allocator.
+ *
+ * Under --enable-mtp the free lists are thread_local.
+ */
+class SpectrumValuePool
+{
+public:
+  /// The number of block sizes with a free list
+  static const uint32_t N_POOLS = 8;
+  /// The maximum number of free blocks kept for each size
+  static const uint32_t MAX_FREE_BLOCKS = 256;
+
+  /**
+   * \param size the size of the block, in bytes
+   * \return a block of at least size bytes
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * \param block a block returned by Allocate
+   * \param size the size passed to Allocate
+   */
+  static void Deallocate (void *block, std::size_t size);
+
+  /// The allocations done by the pool
+  struct Statistics
+  {
+    uint64_t allocations;        //!< number of blocks allocated
+    uint64_t systemAllocations;  //!< number of blocks taken from the system allocator
+  };
+
+  /**
+   * \return the allocations done by the pool since the start of the program
+   */
+  static Statistics GetStatistics (void);
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief A standard allocator taking its blocks from the SpectrumValuePool
+ */
+template <typename T>
+class SpectrumValueAllocator
+{
+public:
+  typedef T value_type; //!< the type of the elements allocated
+
+  SpectrumValueAllocator ()
+  {
+  }
+  /**
+   * Copy constructor from the allocator of another type
+   * \param o the other allocator
+   */
+  template <typename U>
+  SpectrumValueAllocator (const SpectrumValueAllocator<U> &o)
+  {
+  }
+
+  /**
+   * \param n the number of elements
+   * \return storage for n elements
+   */
+  T * allocate (std::size_t n)
+  {
+    return static_cast<T *> (SpectrumValuePool::Allocate (n * sizeof (T)));
+  }
+  /**
+   * \param p the storage returned by allocate
+   * \param n the number of elements passed to allocate
+   */
+  void deallocate (T *p, std::size_t n)
+  {
+    SpectrumValuePool::Deallocate (p, n * sizeof (T));
+  }
+};
+
+/**
+ * \param a an allocator
+ * \param b another allocator
+ * \return true, since all the allocators share the same pool
+ */
+template <typename T, typename U>
+inline bool
+operator == (const SpectrumValueAllocator<T> &a, const SpectrumValueAllocator<U> &b)
+{
+  return true;
+}
+
+/**
+ * \param a an allocator
+ * \param b another allocator
+ * \return false, since all the allocators share the same pool
+ */
+template <typename T, typename U>
+inline bool
+operator != (const SpectrumValueAllocator<T> &a, const SpectrumValueAllocator<U> &b)
+{
+  return false;
+}
+
+} // namespace ns3
+
+#endif /* SPECTRUM_VALUE_POOL_H */
@@ -23,6 +23,265 @@
 #include <ns3/math.h>
 #include <ns3/log.h>
 
+#if defined (__GNUC__) && defined (__x86_64__)
+#define SPECTRUM_VALUE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/*
+ * The element to element kernels. The vectorized kernels only use the
+ * AVX additions, subtractions, multiplications and divisions, which are
+ * rounded like the scalar SSE2 ones, and no fused multiply-add, so that
+ * they give the same results as the scalar loops, bit for bit.
+ */
+
+/// x + y
+struct AddOp
+{
+  /**
+   * \param x the first operand
+   * \param y the second operand
+   * \return x + y
+   */
+  static double Apply (double x, double y)
+  {
+    return x + y;
+  }
+#ifdef SPECTRUM_VALUE_AVX2
+  /**
+   * \param x the first operands
+   * \param y the second operands
+   * \return x + y
+   */
+  __attribute__ ((target ("avx2"))) static __m256d Apply (__m256d x, __m256d y)
+  {
+    return _mm256_add_pd (x, y);
+  }
+#endif
+};
+
+/// x - y
+struct SubtractOp
+{
+  /**
+   * \param x the first operand
+   * \param y the second operand
+   * \return x - y
+   */
+  static double Apply (double x, double y)
+  {
+    return x - y;
+  }
+#ifdef SPECTRUM_VALUE_AVX2
+  /**
+   * \param x the first operands
+   * \param y the second operands
+   * \return x - y
+   */
+  __attribute__ ((target ("avx2"))) static __m256d Apply (__m256d x, __m256d y)
+  {
+    return _mm256_sub_pd (x, y);
+  }
+#endif
+};
+
+/// x * y
+struct MultiplyOp
+{
+  /**
+   * \param x the first operand
+   * \param y the second operand
+   * \return x * y
+   */
+  static double Apply (double x, double y)
+  {
+    return x * y;
+  }
+#ifdef SPECTRUM_VALUE_AVX2
+  /**
+   * \param x the first operands
+   * \param y the second operands
+   * \return x * y
+   */
+  __attribute__ ((target ("avx2"))) static __m256d Apply (__m256d x, __m256d y)
+  {
+    return _mm256_mul_pd (x, y);
+  }
+#endif
+};
+
+/// x / y
+struct DivideOp
+{
+  /**
+   * \param x the first operand
+   * \param y the second operand
+   * \return x / y
+   */
+  static double Apply (double x, double y)
+  {
+    return x / y;
+  }
+#ifdef SPECTRUM_VALUE_AVX2
+  /**
+   * \param x the first operands
+   * \param y the second operands
+   * \return x / y
+   */
+  __attribute__ ((target ("avx2"))) static __m256d Apply (__m256d x, __m256d y)
+  {
+    return _mm256_div_pd (x, y);
+  }
+#endif
+};
+
+/**
+ * \param x the values, replaced by x OP y
+ * \param y the second operands
+ * \param n the number of values
+ */
+template <typename OP>
+void
+ApplyScalar (double *x, const double *y, std::size_t n)
+{
+  for (std::size_t i = 0; i < n; i++)
+    {
+      x[i] = OP::Apply (x[i], y[i]);
+    }
+}
+
+/**
+ * \param x the values, replaced by x OP s
+ * \param s the second operand
+ * \param n the number of values
+ */
+template <typename OP>
+void
+ApplyScalar (double *x, double s, std::size_t n)
+{
+  for (std::size_t i = 0; i < n; i++)
+    {
+      x[i] = OP::Apply (x[i], s);
+    }
+}
+
+/**
+ * \param sinr the signal to interference plus noise ratios
+ * \param signal the signal
+ * \param allSignals the sum of all the signals
+ * \param noise the noise
+ * \param n the number of values
+ */
+void
+SinrScalar (double *sinr, const double *signal, const double *allSignals, const double *noise, std::size_t n)
+{
+  for (std::size_t i = 0; i < n; i++)
+    {
+      sinr[i] = signal[i] / ((allSignals[i] - signal[i]) + noise[i]);
+    }
+}
+
+#ifdef SPECTRUM_VALUE_AVX2
+/**
+ * \param x the values, replaced by x OP y
+ * \param y the second operands
+ * \param n the number of values
+ */
+template <typename OP>
+__attribute__ ((target ("avx2"))) void
+ApplyAvx2 (double *x, const double *y, std::size_t n)
+{
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      _mm256_storeu_pd (x + i, OP::Apply (_mm256_loadu_pd (x + i), _mm256_loadu_pd (y + i)));
+    }
+  for (; i < n; i++)
+    {
+      x[i] = OP::Apply (x[i], y[i]);
+    }
+}
+
+/**
+ * \param x the values, replaced by x OP s
+ * \param s the second operand
+ * \param n the number of values
+ */
+template <typename OP>
+__attribute__ ((target ("avx2"))) void
+ApplyAvx2 (double *x, double s, std::size_t n)
+{
+  __m256d vs = _mm256_set1_pd (s);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      _mm256_storeu_pd (x + i, OP::Apply (_mm256_loadu_pd (x + i), vs));
+    }
+  for (; i < n; i++)
+    {
+      x[i] = OP::Apply (x[i], s);
+    }
+}
+
+/**
+ * \param sinr the signal to interference plus noise ratios
+ * \param signal the signal
+ * \param allSignals the sum of all the signals
+ * \param noise the noise
+ * \param n the number of values
+ */
+__attribute__ ((target ("avx2"))) void
+SinrAvx2 (double *sinr, const double *signal, const double *allSignals, const double *noise, std::size_t n)
+{
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      __m256d s = _mm256_loadu_pd (signal + i);
+      __m256d interference = _mm256_sub_pd (_mm256_loadu_pd (allSignals + i), s);
+      __m256d in = _mm256_add_pd (interference, _mm256_loadu_pd (noise + i));
+      _mm256_storeu_pd (sinr + i, _mm256_div_pd (s, in));
+    }
+  SinrScalar (sinr + i, signal + i, allSignals + i, noise + i, n - i);
+}
+
+/**
+ * \return true if the processor supports AVX2, false otherwise
+ */
+bool
+HasAvx2 (void)
+{
+  // the static constructors may run before the one of the cpu model
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2");
+}
+
+/// whether the vectorized kernels are used
+bool g_simdEnabled = HasAvx2 ();
+#endif
+
+/**
+ * \param x the values, replaced by x OP y
+ * \param y the second operands
+ * \param n the number of values
+ */
+template <typename OP, typename T>
+inline void
+Apply (double *x, T y, std::size_t n)
+{
+#ifdef SPECTRUM_VALUE_AVX2
+  if (g_simdEnabled)
+    {
+      ApplyAvx2<OP> (x, y, n);
+      return;
+    }
+#endif
+  ApplyScalar<OP> (x, y, n);
+}
+
+} // anonymous namespace
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
@@ -106,31 +365,16 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
-    {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
-    }
+  NS_ASSERT (m_values.size () <= x.m_values.size ());
+  Apply<AddOp> (m_values.data (), x.m_values.data (), m_values.size ());
 }
 
 
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 += s;
-      ++it1;
-    }
+  Apply<AddOp> (m_values.data (), s, m_values.size ());
 }
 
 
@@ -138,18 +382,9 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
-    {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
-    }
+  NS_ASSERT (m_values.size () <= x.m_values.size ());
+  Apply<SubtractOp> (m_values.data (), x.m_values.data (), m_values.size ());
 }
 
 
@@ -164,31 +399,16 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
-    {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
-    }
+  NS_ASSERT (m_values.size () <= x.m_values.size ());
+  Apply<MultiplyOp> (m_values.data (), x.m_values.data (), m_values.size ());
 }
 
 
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 *= s;
-      ++it1;
-    }
+  Apply<MultiplyOp> (m_values.data (), s, m_values.size ());
 }
 
 
@@ -197,18 +417,9 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
-    {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
-    }
+  NS_ASSERT (m_values.size () <= x.m_values.size ());
+  Apply<DivideOp> (m_values.data (), x.m_values.data (), m_values.size ());
 }
 
 
@@ -216,13 +427,7 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 /= s;
-      ++it1;
-    }
+  Apply<DivideOp> (m_values.data (), s, m_values.size ());
 }
 
 
@@ -403,6 +608,58 @@ Integral (const SpectrumValue& arg)
   return i;
 }
 
+double
+Integral (const SpectrumValue& lhs, const SpectrumValue& rhs)
+{
+  NS_ASSERT (lhs.m_spectrumModel == rhs.m_spectrumModel);
+  NS_ASSERT (lhs.m_values.size () == rhs.m_values.size ());
+  double i = 0;
+  Bands::const_iterator bit = lhs.ConstBandsBegin ();
+  for (std::size_t k = 0; k < lhs.m_values.size (); ++k, ++bit)
+    {
+      NS_ASSERT (bit != lhs.ConstBandsEnd ());
+      i += (lhs.m_values[k] * rhs.m_values[k]) * (bit->fh - bit->fl);
+    }
+  NS_ASSERT (bit == lhs.ConstBandsEnd ());
+  return i;
+}
+
+void
+SpectrumValue::AssignSinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise)
+{
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  m_spectrumModel = signal.m_spectrumModel;
+  m_values.resize (signal.m_values.size ());
+#ifdef SPECTRUM_VALUE_AVX2
+  if (g_simdEnabled)
+    {
+      SinrAvx2 (m_values.data (), signal.m_values.data (), allSignals.m_values.data (), noise.m_values.data (), m_values.size ());
+      return;
+    }
+#endif
+  SinrScalar (m_values.data (), signal.m_values.data (), allSignals.m_values.data (), noise.m_values.data (), m_values.size ());
+}
+
+void
+SpectrumValue::SetSimdEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (enabled);
+#ifdef SPECTRUM_VALUE_AVX2
+  g_simdEnabled = enabled && HasAvx2 ();
+#endif
+}
+
+bool
+SpectrumValue::IsSimdEnabled (void)
+{
+#ifdef SPECTRUM_VALUE_AVX2
+  return g_simdEnabled;
+#else
+  return false;
+#endif
+}
+
 
 
 Ptr<SpectrumValue>
@@ -704,5 +961,21 @@ SpectrumValue::ValuesAt (uint32_t pos) const
   return m_values.at (pos);
 }
 
+void
+SpectrumValue::GetNonZeroBands (uint32_t &start, uint32_t &length) const
+{
+  uint32_t end = m_values.size ();
+  while (end > 0 && m_values[end - 1] == 0)
+    {
+      end--;
+    }
+  start = 0;
+  while (start < end && m_values[start] == 0)
+    {
+      start++;
+    }
+  length = end - start;
+}
+
 } // namespace ns3
 
@@ -24,14 +24,15 @@
 #include <ns3/ptr.h>
 #include <ns3/simple-ref-count.h>
 #include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value-pool.h>
 #include <ostream>
 #include <vector>
 
 namespace ns3 {
 
 
-/// Container for element values
-typedef std::vector<double> Values;
+/// Container for element values, with storage recycled by the SpectrumValuePool
+typedef std::vector<double, SpectrumValueAllocator<double> > Values;
 
 /**
  * \ingroup spectrum
@@ -170,6 +171,16 @@ public:
    */
   const double & ValuesAt (uint32_t pos) const;
 
+  /**
+   * \brief Get the smallest range of bands outside of which all the
+   * values are zero, such as the bands occupied by a narrowband signal
+   * in a wideband SpectrumModel
+   * \param start the index of the first band of the range
+   * \param length the number of bands of the range, zero if all the
+   * values are zero
+   */
+  void GetNonZeroBands (uint32_t &start, uint32_t &length) const;
+
   /**
    *  addition operator
    *
@@ -508,6 +519,47 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Integrate the product of two SpectrumValue instances, without
+   * creating the product. The result is the same, bit for bit, as
+   * Integral (lhs * rhs).
+   *
+   * @param lhs Left Hand Side of the product
+   * @param rhs Right Hand Side of the product
+   *
+   * @return the value of the integral \f$\int_F g(f) h(f) df  \f$
+   */
+  friend double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
+
+  /**
+   * Set each component of *this to the signal to interference plus
+   * noise ratio signal / (allSignals - signal + noise), without creating
+   * any temporary SpectrumValue. The result is the same, bit for bit,
+   * as the one of the arithmetic operators, and *this takes the
+   * SpectrumModel of signal.
+   *
+   * @param signal the power spectral density of the signal
+   * @param allSignals the sum of the power spectral densities of all
+   * the signals, including signal
+   * @param noise the power spectral density of the noise
+   */
+  void AssignSinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise);
+
+  /**
+   * Enable or disable the vectorized kernels of the element to element
+   * arithmetic operations. The kernels are enabled by default when the
+   * processor supports AVX2, and give the same results, bit for bit,
+   * as the scalar loops.
+   *
+   * @param enabled whether the vectorized kernels are used when the processor supports them
+   */
+  static void SetSimdEnabled (bool enabled);
+
+  /**
+   * @return true if the vectorized kernels are used, false otherwise
+   */
+  static bool IsSimdEnabled (void);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -630,6 +682,7 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
 
 
 } // namespace ns3
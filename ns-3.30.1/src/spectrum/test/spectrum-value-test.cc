@@ -25,6 +25,7 @@
 #include <ns3/test.h>
 #include <iostream>
 #include <cmath>
+#include <cstring>
 
 #include "spectrum-test.h"
 
@@ -80,6 +81,107 @@ SpectrumValueTestCase::DoRun (void)
 
 
 
+/**
+ * Test that the vectorized kernels and the fused operations give the
+ * same results, bit for bit, as the scalar arithmetic operators, and
+ * that the storage of the values is recycled.
+ */
+class SpectrumValueKernelsTestCase : public TestCase
+{
+public:
+  SpectrumValueKernelsTestCase ();
+  virtual ~SpectrumValueKernelsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param x a SpectrumValue
+   * \param y another SpectrumValue
+   * \return true if x and y hold the same values, bit for bit
+   */
+  static bool BitEqual (const SpectrumValue &x, const SpectrumValue &y);
+};
+
+SpectrumValueKernelsTestCase::SpectrumValueKernelsTestCase ()
+  : TestCase ("vectorized and fused operations match the scalar operators bit for bit")
+{
+}
+
+SpectrumValueKernelsTestCase::~SpectrumValueKernelsTestCase ()
+{
+}
+
+bool
+SpectrumValueKernelsTestCase::BitEqual (const SpectrumValue &x, const SpectrumValue &y)
+{
+  return x.GetValuesN () == y.GetValuesN ()
+         && std::memcmp (&x.ValuesAt (0), &y.ValuesAt (0), x.GetValuesN () * sizeof (double)) == 0;
+}
+
+void
+SpectrumValueKernelsTestCase::DoRun (void)
+{
+  // an odd number of bands, so that the vectorized loops have a remainder
+  std::vector<double> freqs;
+  for (int i = 0; i < 37; i++)
+    {
+      freqs.push_back (2.4e9 + i * 312.5e3 * (1 + 0.01 * i));
+    }
+  Ptr<SpectrumModel> sm = Create<SpectrumModel> (freqs);
+  SpectrumValue a (sm), b (sm), c (sm);
+  for (int i = 0; i < 37; i++)
+    {
+      a[i] = std::exp (std::sin (i * 1.7)) * 1e-13;
+      b[i] = std::exp (std::cos (i * 0.3)) * 1e-12;
+      c[i] = 1.0 / (3 + i) * 1e-14;
+    }
+  double s = 1.2345678901234567;
+
+  bool simdEnabled = SpectrumValue::IsSimdEnabled ();
+  SpectrumValue results[2][9];
+  for (int simd = 0; simd < 2; simd++)
+    {
+      SpectrumValue::SetSimdEnabled (simd == 1);
+      SpectrumValue *r = results[simd];
+      r[0] = a + b;
+      r[1] = a - b;
+      r[2] = a * b;
+      r[3] = a / b;
+      r[4] = a + s;
+      r[5] = a - s;
+      r[6] = a * s;
+      r[7] = a / s;
+      r[8].AssignSinr (a, b, c);
+    }
+  SpectrumValue::SetSimdEnabled (simdEnabled);
+
+  const char *names[9] = { "a + b", "a - b", "a * b", "a / b", "a + s", "a - s", "a * s", "a / s", "sinr" };
+  for (int k = 0; k < 9; k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (BitEqual (results[0][k], results[1][k]), true, "vectorized " << names[k] << " differs from the scalar loop");
+    }
+
+  // the fused operations against the arithmetic operators
+  SpectrumValue sinr = a / (b - a + c);
+  NS_TEST_EXPECT_MSG_EQ (BitEqual (results[0][8], sinr), true, "AssignSinr differs from a / (b - a + c)");
+  double integral = Integral (a, b);
+  double expected = Integral (a * b);
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (&integral, &expected, sizeof (double)), 0, "Integral (a, b) differs from Integral (a * b)");
+
+  // the storage of a released SpectrumValue is reused
+  SpectrumValuePool::Statistics before = SpectrumValuePool::GetStatistics ();
+  for (int i = 0; i < 10; i++)
+    {
+      Ptr<SpectrumValue> v = a.Copy ();
+      *v *= s;
+    }
+  SpectrumValuePool::Statistics after = SpectrumValuePool::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (after.allocations - before.allocations, 10u, "unexpected number of allocations");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (after.systemAllocations - before.systemAllocations, 1u, "the storage was not recycled");
+}
+
+
+
 
 
 class SpectrumValueTestSuite : public TestSuite
@@ -241,6 +343,8 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   tv1rs3 = v1 >> 3;
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
+  AddTestCase (new SpectrumValueKernelsTestCase, TestCase::QUICK);
+
 
 }
 
@@ -328,6 +432,21 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
 //   NS_LOG_LOGIC(*res);
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""), TestCase::QUICK);
 
+  // only the bands around the non-zero values are converted
+  Ptr<SpectrumValue> v2c = Create<SpectrumValue> (sof2);
+  (*v2c)[2] = 7;
+  res = c21.Convert (v2c);
+  SpectrumValue t21c (sof1);
+  t21c[0] = 7 * 0.25;
+  t21c[1] = 7 * 0.25;
+  t21c[2] = 0;
+  AddTestCase (new SpectrumValueTestCase (t21c, *res, "sparse PSD"), TestCase::QUICK);
+
+  Ptr<SpectrumValue> v2d = Create<SpectrumValue> (sof2);
+  res = c21.Convert (v2d);
+  SpectrumValue t21d (sof1);
+  AddTestCase (new SpectrumValueTestCase (t21d, *res, "zero PSD"), TestCase::QUICK);
+
 
 }
 
@@ -63,6 +63,7 @@ public:
   virtual EventId ScheduleDestroy (EventImpl *event);
   virtual void Remove (const EventId &id);
   virtual void Cancel (const EventId &id);
+  virtual EventId Reschedule (const EventId &id, const Time &delay);
   virtual bool IsExpired (const EventId &id) const;
   virtual void Run (void);
   virtual Time Now (void) const;
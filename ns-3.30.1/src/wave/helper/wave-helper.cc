@@ -145,7 +145,7 @@ YansWavePhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
   std::vector<Ptr<WifiPhy> > phys = device->GetPhys ();
   NS_ABORT_MSG_IF (phys.size () == 0, "EnablePcapInternal(): Phy layer in WaveNetDevice must be set");
 
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
 
   std::string filename;
   if (explicitFilename)
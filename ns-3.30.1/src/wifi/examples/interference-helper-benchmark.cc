@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// This program measures the time spent by InterferenceHelper to record
+// signals and to evaluate receptions, for each of the data structures
+// available to store the noise and interference changes.
+//
+// A busy medium is emulated by adding signals with random start times,
+// durations and powers.  The first signal arriving while no signal is
+// being received is received: the SNR and the PER of its PHY header and
+// payload are evaluated at its end, as done by WifiPhy.
+//
+// The number of signals (--nSignals option) and the mean number of
+// overlapping signals (--overlap option) can be configured at run-time.
+// The program displays the run time for each data structure, as well as
+// the sum of the computed SNRs, which must be the same for all of them.
+//
+
+#include <iomanip>
+#include <iostream>
+#include "ns3/command-line.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-utils.h"
+
+using namespace ns3;
+
+/// Feeds an InterferenceHelper with random signals and evaluates receptions
+class InterferenceBenchmark
+{
+public:
+  /**
+   * \param storage the data structure used to store the noise and interference changes
+   */
+  InterferenceBenchmark (InterferenceHelper::NiChangesStorage storage);
+  /**
+   * Run the benchmark
+   * \param nSignals the number of signals
+   * \param overlap the mean number of overlapping signals
+   * \returns the sum of the computed SNRs
+   */
+  double Run (uint32_t nSignals, double overlap);
+  /**
+   * \returns the number of receptions
+   */
+  uint32_t GetNReceptions (void) const;
+
+private:
+  /**
+   * Add a signal
+   * \param duration the duration of the signal
+   * \param rxPowerW the receive power (W)
+   */
+  void AddSignal (Time duration, double rxPowerW);
+  /**
+   * End the reception of the signal being received
+   */
+  void EndReception (void);
+
+  InterferenceHelper m_interference; ///< the interference helper
+  Ptr<Event> m_rxEvent;              ///< event being received
+  WifiTxVector m_txVector;           ///< TXVECTOR of the signals
+  uint32_t m_nReceptions;            ///< number of receptions
+  double m_snrSum;                   ///< sum of the computed SNRs
+};
+
+InterferenceBenchmark::InterferenceBenchmark (InterferenceHelper::NiChangesStorage storage)
+  : m_txVector (WifiPhy::GetHeMcs7 (), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 20, false, false),
+    m_nReceptions (0),
+    m_snrSum (0)
+{
+  m_interference.SetNoiseFigure (DbToRatio (7));
+  m_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  m_interference.SetNiChangesStorage (storage);
+}
+
+void
+InterferenceBenchmark::AddSignal (Time duration, double rxPowerW)
+{
+  m_interference.GetEnergyDuration (DbmToW (-62));
+  Ptr<Event> event = m_interference.Add (0, m_txVector, duration, rxPowerW);
+  if (m_rxEvent == 0)
+    {
+      m_rxEvent = event;
+      m_interference.NotifyRxStart ();
+      Simulator::Schedule (duration, &InterferenceBenchmark::EndReception, this);
+    }
+}
+
+void
+InterferenceBenchmark::EndReception (void)
+{
+  InterferenceHelper::SnrPer snrPer = m_interference.CalculateLegacyPhyHeaderSnrPer (m_rxEvent);
+  m_snrSum += snrPer.snr;
+  snrPer = m_interference.CalculateNonLegacyPhyHeaderSnrPer (m_rxEvent);
+  m_snrSum += snrPer.snr;
+  snrPer = m_interference.CalculatePayloadSnrPer (m_rxEvent, std::make_pair (Seconds (0), m_rxEvent->GetEndTime () - m_rxEvent->GetStartTime ()));
+  m_snrSum += snrPer.snr;
+  m_interference.NotifyRxEnd ();
+  m_rxEvent = 0;
+  m_nReceptions++;
+}
+
+double
+InterferenceBenchmark::Run (uint32_t nSignals, double overlap)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  // signals last 500 us on average
+  double meanInterval = 500.0 / overlap;
+  for (uint32_t i = 0; i < nSignals; i++)
+    {
+      Time start = MicroSeconds (random->GetValue (0, nSignals * meanInterval));
+      Time duration = MicroSeconds (random->GetInteger (100, 900));
+      double rxPowerW = DbmToW (random->GetValue (-90, -50));
+      Simulator::Schedule (start, &InterferenceBenchmark::AddSignal, this, duration, rxPowerW);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_snrSum;
+}
+
+uint32_t
+InterferenceBenchmark::GetNReceptions (void) const
+{
+  return m_nReceptions;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nSignals = 100000;
+  double overlap = 4;
+
+  CommandLine cmd;
+  cmd.AddValue ("nSignals", "Number of signals", nSignals);
+  cmd.AddValue ("overlap", "Mean number of overlapping signals", overlap);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (14) << "storage" << std::setw (12) << "receptions"
+            << std::setw (12) << "time (ms)" << std::setw (20) << "SNR sum" << std::endl;
+  InterferenceHelper::NiChangesStorage storages[] = {InterferenceHelper::NI_CHANGES_MULTIMAP,
+                                                     InterferenceHelper::NI_CHANGES_SORTED_VECTOR};
+  const char *names[] = {"Multimap", "SortedVector"};
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      InterferenceBenchmark benchmark (storages[i]);
+      SystemWallClockMs clock;
+      clock.Start ();
+      double snrSum = benchmark.Run (nSignals, overlap);
+      int64_t elapsed = clock.End ();
+      std::cout << std::setw (14) << names[i] << std::setw (12) << benchmark.GetNReceptions ()
+                << std::setw (12) << elapsed << std::setw (20) << std::setprecision (12) << snrSum << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// This program measures the time spent by the remote station manager of
+// an 802.11n AP for each frame it transmits, as the number of associated
+// stations grows.
+//
+// For every frame, the AP checks that the receiver is associated, asks
+// for the TXVECTOR of the frame and of the RTS, and reports the
+// successful reception of the ACK, as done by MacLow.  The receivers are
+// visited in a round-robin fashion.
+//
+// The maximum number of stations (--maxStations option) and the number of
+// frames (--nFrames option) can be configured at run-time.  The program
+// displays the mean time per frame, for the Ideal and the MinstrelHt
+// managers, with 1, 10, 100... up to maxStations associated stations.
+//
+
+#include <iomanip>
+#include <iostream>
+#include "ns3/command-line.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/regular-wifi-mac.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/ssid.h"
+
+using namespace ns3;
+
+/**
+ * Run the benchmark for a given manager and number of stations
+ * \param manager the type of the remote station manager
+ * \param nStations the number of associated stations
+ * \param nFrames the number of frames
+ * \returns the mean time per frame (ns)
+ */
+double
+RunBenchmark (std::string manager, uint32_t nStations, uint32_t nFrames)
+{
+  NodeContainer node;
+  node.Create (1);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager (manager);
+
+  WifiMacHelper mac;
+  mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (Ssid ("benchmark")));
+  NetDeviceContainer device = wifi.Install (phy, mac, node);
+  // the managers build their internal tables when they are initialized
+  node.Get (0)->Initialize ();
+
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (device.Get (0));
+  Ptr<WifiRemoteStationManager> stationManager = dev->GetRemoteStationManager ();
+  HtCapabilities htCapabilities = DynamicCast<RegularWifiMac> (dev->GetMac ())->GetHtCapabilities ();
+
+  std::vector<Mac48Address> stations;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      stationManager->AddAllSupportedModes (address);
+      stationManager->AddStationHtCapabilities (address, htCapabilities);
+      stationManager->AddAllSupportedMcs (address);
+      stationManager->SetQosSupport (address, true);
+      stationManager->RecordWaitAssocTxOk (address);
+      stationManager->RecordGotAssocTxOk (address);
+      stations.push_back (address);
+    }
+
+  Ptr<Packet> packet = Create<Packet> (1500);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  WifiMode ackMode = WifiPhy::GetOfdmRate24Mbps ();
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      Mac48Address address = stations[i % nStations];
+      hdr.SetAddr1 (address);
+      NS_ABORT_IF (!stationManager->IsAssociated (address));
+      WifiTxVector txVector = stationManager->GetDataTxVector (address, &hdr, packet);
+      if (stationManager->NeedRts (address, &hdr, packet, txVector))
+        {
+          stationManager->GetRtsTxVector (address, &hdr, packet);
+        }
+      stationManager->ReportDataOk (address, &hdr, 1000, ackMode, 1000, packet->GetSize ());
+    }
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed * 1e6 / nFrames;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t maxStations = 1000;
+  uint32_t nFrames = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("maxStations", "Maximum number of associated stations", maxStations);
+  cmd.AddValue ("nFrames", "Number of frames", nFrames);
+  cmd.Parse (argc, argv);
+
+  std::string managers[] = {"ns3::IdealWifiManager", "ns3::MinstrelHtWifiManager"};
+  std::cout << std::setw (28) << "manager" << std::setw (12) << "stations"
+            << std::setw (20) << "time/frame (ns)" << std::endl;
+  for (const std::string &manager : managers)
+    {
+      for (uint32_t nStations = 1; nStations <= maxStations; nStations *= 10)
+        {
+          double timePerFrame = RunBenchmark (manager, nStations, nFrames);
+          std::cout << std::setw (28) << manager << std::setw (12) << nStations
+                    << std::setw (20) << std::fixed << std::setprecision (1) << timePerFrame << std::endl;
+        }
+    }
+
+  return 0;
+}
@@ -63,6 +63,12 @@ AsciiPhyTransmitSinkWithContext (
   uint8_t txLevel)
 {
   NS_LOG_FUNCTION (stream << context << p << mode << preamble << txLevel);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('t', Simulator::Now (), " " + context + " " + mode.GetUniqueName (), p);
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << mode << " " << *p << std::endl;
 }
 
@@ -83,6 +89,12 @@ AsciiPhyTransmitSinkWithoutContext (
   uint8_t txLevel)
 {
   NS_LOG_FUNCTION (stream << p << mode << preamble << txLevel);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('t', Simulator::Now (), " " + mode.GetUniqueName (), p);
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << mode << " " << *p << std::endl;
 }
 
@@ -105,6 +117,12 @@ AsciiPhyReceiveSinkWithContext (
   WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (stream << context << p << snr << mode << preamble);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('r', Simulator::Now (), " " + mode.GetUniqueName () + context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << mode << "" << context << " " << *p << std::endl;
 }
 
@@ -125,6 +143,12 @@ AsciiPhyReceiveSinkWithoutContext (
   WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (stream << p << snr << mode << preamble);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryWriter ();
+  if (writer)
+    {
+      writer->Write ('r', Simulator::Now (), " " + mode.GetUniqueName (), p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << mode << " " << *p << std::endl;
 }
 
@@ -552,7 +576,7 @@ WifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool p
   Ptr<WifiPhy> phy = device->GetPhy ();
   NS_ABORT_MSG_IF (phy == 0, "WifiPhyHelper::EnablePcapInternal(): Phy layer in WifiNetDevice must be set");
 
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
 
   std::string filename;
   if (explicitFilename)
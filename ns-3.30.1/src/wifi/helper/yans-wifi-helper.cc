@@ -23,6 +23,7 @@
 #include "ns3/names.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/frame-capture-model.h"
 #include "ns3/preamble-detection-model.h"
@@ -34,6 +35,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("YansWifiHelper");
 
 YansWifiChannelHelper::YansWifiChannelHelper ()
+  : m_propagationLossCache (false)
 {
 }
 
@@ -94,14 +96,42 @@ YansWifiChannelHelper::SetPropagationDelay (std::string type,
   m_propagationDelay = factory;
 }
 
+void
+YansWifiChannelHelper::SetPropagationLossCache (bool enable)
+{
+  m_propagationLossCache = enable;
+}
+
 Ptr<YansWifiChannel>
 YansWifiChannelHelper::Create (void) const
 {
   Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
   Ptr<PropagationLossModel> prev = 0;
+  Ptr<CachedPropagationLossModel> cache = 0;
   for (std::vector<ObjectFactory>::const_iterator i = m_propagationLoss.begin (); i != m_propagationLoss.end (); ++i)
     {
       Ptr<PropagationLossModel> cur = (*i).Create<PropagationLossModel> ();
+      if (m_propagationLossCache && prev == 0 && cur->IsDeterministic ())
+        {
+          cache = CreateObject<CachedPropagationLossModel> ();
+          cache->SetLossModel (cur);
+          channel->SetPropagationLossModel (cache);
+          prev = cur;
+          continue;
+        }
+      if (cache != 0 && cur->IsDeterministic ())
+        {
+          // still in the cached part of the chain
+          prev->SetNext (cur);
+          prev = cur;
+          continue;
+        }
+      if (cache != 0)
+        {
+          // the models following the cached ones are evaluated after the cache
+          prev = cache;
+          cache = 0;
+        }
       if (prev != 0)
         {
           prev->SetNext (cur);
@@ -119,6 +119,17 @@ public:
                             std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
                             std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
 
+  /**
+   * \param enable whether the loss of the deterministic models is cached
+   *
+   * When enabled, the loss models added first which are deterministic
+   * (see PropagationLossModel::IsDeterministic) are wrapped in a
+   * CachedPropagationLossModel by Create, and the loss between static nodes
+   * is then only computed once.  The models following the first one which
+   * is not deterministic are evaluated as usual, after the cached loss.
+   */
+  void SetPropagationLossCache (bool enable);
+
   /**
    * \returns a new channel
    *
@@ -144,6 +155,7 @@ public:
 private:
   std::vector<ObjectFactory> m_propagationLoss; ///< vector of propagation loss models
   ObjectFactory m_propagationDelay; ///< propagation delay model
+  bool m_propagationLossCache; ///< whether the loss of the deterministic models is cached
 };
 
 
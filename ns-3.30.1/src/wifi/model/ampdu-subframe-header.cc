@@ -79,6 +79,12 @@ AmpduSubframeHeader::Deserialize (Buffer::Iterator start)
   return i.GetDistanceFrom (start);
 }
 
+bool
+AmpduSubframeHeader::IsSelfContained (void) const
+{
+  return true;
+}
+
 void
 AmpduSubframeHeader::Print (std::ostream &os) const
 {
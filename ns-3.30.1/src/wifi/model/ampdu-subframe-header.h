@@ -45,6 +45,7 @@ public:
   uint32_t GetSerializedSize (void) const;
   void Serialize (Buffer::Iterator start) const;
   uint32_t Deserialize (Buffer::Iterator start);
+  bool IsSelfContained (void) const;
 
   /**
    * Set the length field.
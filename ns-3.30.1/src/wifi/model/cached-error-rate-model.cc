@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "cached-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "wifi-tx-vector.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedErrorRateModel);
+
+/// The initial SNR step of the tables (dB)
+static const double INITIAL_SNR_STEP = 1.0;
+/// The smallest SNR step of the tables (dB)
+static const double MIN_SNR_STEP = 1.0 / 64;
+/// Error exponents lower than this value are considered equal to it when checking the tolerance
+static const double MIN_EXPONENT = 1e-10;
+
+TypeId
+CachedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CachedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose chunk success rates are interpolated. "
+                   "A NistErrorRateModel is used if none is set.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedErrorRateModel::SetErrorRateModel,
+                                        &CachedErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("Tolerance",
+                   "The maximum relative difference between the interpolated and the exact "
+                   "per-bit error exponents at the middle of the cells of the SNR grid. "
+                   "Differences on exponents x higher than one are weighted by x * exp (1 - x).",
+                   DoubleValue (1e-3),
+                   MakeDoubleAccessor (&CachedErrorRateModel::SetTolerance,
+                                       &CachedErrorRateModel::GetTolerance),
+                   MakeDoubleChecker<double> (1e-9, 1.0))
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR (dB) in the tables. Lower SNRs are handled by the decorated model.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&CachedErrorRateModel::SetMinSnr,
+                                       &CachedErrorRateModel::GetMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR (dB) in the tables. Higher SNRs are handled by the decorated model.",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&CachedErrorRateModel::SetMaxSnr,
+                                       &CachedErrorRateModel::GetMaxSnr),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+CachedErrorRateModel::CachedErrorRateModel ()
+  : m_tolerance (1e-3),
+    m_minSnrDb (-10.0),
+    m_maxSnrDb (60.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedErrorRateModel::~CachedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_errorRateModel = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+CachedErrorRateModel::SetErrorRateModel (const Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_errorRateModel = model;
+  m_tables.clear ();
+}
+
+Ptr<ErrorRateModel>
+CachedErrorRateModel::GetErrorRateModel (void) const
+{
+  if (m_errorRateModel == 0)
+    {
+      m_errorRateModel = CreateObject<NistErrorRateModel> ();
+    }
+  return m_errorRateModel;
+}
+
+void
+CachedErrorRateModel::SetTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  m_tolerance = tolerance;
+  m_tables.clear ();
+}
+
+double
+CachedErrorRateModel::GetTolerance (void) const
+{
+  return m_tolerance;
+}
+
+void
+CachedErrorRateModel::SetMinSnr (double snrDb)
+{
+  NS_LOG_FUNCTION (this << snrDb);
+  m_minSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+CachedErrorRateModel::GetMinSnr (void) const
+{
+  return m_minSnrDb;
+}
+
+void
+CachedErrorRateModel::SetMaxSnr (double snrDb)
+{
+  NS_LOG_FUNCTION (this << snrDb);
+  m_maxSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+CachedErrorRateModel::GetMaxSnr (void) const
+{
+  return m_maxSnrDb;
+}
+
+double
+CachedErrorRateModel::GetExponent (WifiMode mode, WifiTxVector txVector, double snrDb) const
+{
+  double psr = GetErrorRateModel ()->GetChunkSuccessRate (mode, txVector, DbToRatio (snrDb), 1);
+  return psr >= 1.0 ? 0.0 : -std::log (psr);
+}
+
+void
+CachedErrorRateModel::Sample (WifiMode mode, WifiTxVector txVector, double step, Table &table) const
+{
+  std::size_t n = static_cast<std::size_t> (std::floor ((m_maxSnrDb - m_minSnrDb) / step)) + 1;
+  table.step = step;
+  table.values.resize (n);
+  table.exact.assign (n - 1, false);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      table.values[i] = std::log (GetExponent (mode, txVector, m_minSnrDb + i * step));
+    }
+}
+
+bool
+CachedErrorRateModel::Interpolate (const Table &table, double snrDb, double &exponent) const
+{
+  double position = (snrDb - m_minSnrDb) / table.step;
+  if (table.values.size () < 2 || !(position >= 0) || position > table.values.size () - 1)
+    {
+      return false;
+    }
+  std::size_t i = std::min (static_cast<std::size_t> (position), table.values.size () - 2);
+  if (table.exact[i])
+    {
+      return false;
+    }
+  double z0 = table.values[i];
+  double z1 = table.values[i + 1];
+  if (z0 == z1)
+    {
+      // this includes the cells where the per-bit success rate is one at both ends
+      exponent = std::exp (z0);
+      return true;
+    }
+  if (std::isinf (z0) || std::isinf (z1))
+    {
+      return false;
+    }
+  exponent = std::exp (z0 + (position - i) * (z1 - z0));
+  return true;
+}
+
+double
+CachedErrorRateModel::GetError (WifiMode mode, WifiTxVector txVector, const Table &table, std::size_t i) const
+{
+  double snrDb = m_minSnrDb + (i + 0.5) * table.step;
+  double interpolated;
+  if (!Interpolate (table, snrDb, interpolated))
+    {
+      return 0;
+    }
+  double exact = GetExponent (mode, txVector, snrDb);
+  if (std::isinf (exact))
+    {
+      return 0;
+    }
+  double error = std::abs (interpolated - exact) / std::max (exact, MIN_EXPONENT);
+  if (exact > 1)
+    {
+      // bound the absolute error on the chunk success rates instead
+      error *= exact * std::exp (1 - exact);
+    }
+  return error;
+}
+
+const CachedErrorRateModel::Table &
+CachedErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  TableKey key = std::make_tuple (mode.GetUid (), txVector.GetChannelWidth (),
+                                  txVector.GetGuardInterval (), txVector.GetNss ());
+  std::map<TableKey, Table>::const_iterator it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  NS_ASSERT_MSG (m_maxSnrDb > m_minSnrDb, "MaxSnr must be higher than MinSnr");
+  Table table;
+  for (double step = INITIAL_SNR_STEP; ; step /= 2)
+    {
+      Sample (mode, txVector, step, table);
+      bool finest = step / 2 < MIN_SNR_STEP;
+      bool converged = true;
+      for (std::size_t i = 0; i + 1 < table.values.size () && (converged || finest); i++)
+        {
+          if (GetError (mode, txVector, table, i) > m_tolerance)
+            {
+              converged = false;
+              // once the grid cannot be refined further, the cells where the error rate
+              // is not smooth enough (e.g. where the decorated model clamps the per-bit
+              // error rate to one) are left to the decorated model
+              table.exact[i] = finest;
+            }
+        }
+      if (converged || finest)
+        {
+          break;
+        }
+    }
+  NS_LOG_DEBUG ("Table for mode " << mode << ", width=" << txVector.GetChannelWidth ()
+                << ", GI=" << txVector.GetGuardInterval () << ", NSS=" << +txVector.GetNss ()
+                << ": step=" << table.step << "dB, " << table.values.size () << " values, "
+                << std::count (table.exact.begin (), table.exact.end (), true) << " exact cells");
+  return m_tables.insert (std::make_pair (key, table)).first->second;
+}
+
+std::size_t
+CachedErrorRateModel::GetTableSize (WifiMode mode, WifiTxVector txVector) const
+{
+  return GetTable (mode, txVector).values.size ();
+}
+
+double
+CachedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  double exponent;
+  if (Interpolate (GetTable (mode, txVector), RatioToDb (snr), exponent))
+    {
+      return std::exp (-exponent * nbits);
+    }
+  return GetErrorRateModel ()->GetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+} //namespace ns3
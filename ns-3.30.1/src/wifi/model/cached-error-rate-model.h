@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_ERROR_RATE_MODEL_H
+#define CACHED_ERROR_RATE_MODEL_H
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * An error rate model which interpolates the chunk success rates of
+ * another error rate model from precomputed tables.
+ *
+ * The decorated model must compute the success rate of a chunk of n bits
+ * as the success rate of a single bit raised to the power n, which is the
+ * case of the NistErrorRateModel, the YansErrorRateModel and the
+ * DsssErrorRateModel.  For every combination of WifiMode, channel width,
+ * guard interval and number of spatial streams, the first time it is used,
+ * the per-bit success rate is sampled over a uniform grid of SNRs (in dB)
+ * between the MinSnr and MaxSnr attributes.  The table stores the
+ * logarithm of the per-bit error exponent (-log of the per-bit success
+ * rate), which varies smoothly with the SNR in dB and is linearly
+ * interpolated.  The grid step is halved, down to 1/64 dB, until the
+ * interpolated error exponents at the middle of all the grid cells differ
+ * from the exact ones by less than the relative tolerance given by the
+ * Tolerance attribute.  Error exponents lower than 1e-10 are considered
+ * as 1e-10 when computing relative differences, since the decorated
+ * models cannot compute per-bit success rates closer to one than the
+ * double precision allows.  Differences on error exponents x higher than
+ * one are weighted by x * exp (1 - x), so that the tolerance bounds the
+ * absolute error on the chunk success rates, which are then lower than
+ * exp (-x).
+ *
+ * SNRs outside the table, grid cells where the per-bit success rate is
+ * exactly one at a single end and grid cells where the tolerance is not
+ * met with the smallest step (e.g. where the NistErrorRateModel clamps the
+ * per-bit error rate to one) are handled by the decorated model.
+ */
+class CachedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedErrorRateModel ();
+  virtual ~CachedErrorRateModel ();
+
+  /**
+   * Set the decorated error rate model. The tables are recomputed.
+   *
+   * \param model the decorated error rate model
+   */
+  void SetErrorRateModel (const Ptr<ErrorRateModel> model);
+  /**
+   * Return the decorated error rate model. A NistErrorRateModel is
+   * created if none was set.
+   *
+   * \return the decorated error rate model
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * Set the relative tolerance on the interpolated per-bit error exponents.
+   * The tables are recomputed.
+   *
+   * \param tolerance the relative tolerance
+   */
+  void SetTolerance (double tolerance);
+  /**
+   * \return the relative tolerance on the interpolated per-bit error exponents
+   */
+  double GetTolerance (void) const;
+  /**
+   * Set the lowest SNR in the tables. The tables are recomputed.
+   *
+   * \param snrDb the lowest SNR (dB)
+   */
+  void SetMinSnr (double snrDb);
+  /**
+   * \return the lowest SNR in the tables (dB)
+   */
+  double GetMinSnr (void) const;
+  /**
+   * Set the highest SNR in the tables. The tables are recomputed.
+   *
+   * \param snrDb the highest SNR (dB)
+   */
+  void SetMaxSnr (double snrDb);
+  /**
+   * \return the highest SNR in the tables (dB)
+   */
+  double GetMaxSnr (void) const;
+  /**
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \return the number of SNR values in the table of the given mode and
+   *         TXVECTOR, after building it if needed
+   */
+  std::size_t GetTableSize (WifiMode mode, WifiTxVector txVector) const;
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+
+protected:
+  virtual void DoDispose (void);
+
+
+private:
+  /// mode UID, channel width, guard interval and number of spatial streams
+  typedef std::tuple<uint32_t, uint16_t, uint16_t, uint8_t> TableKey;
+
+  /// The table of a given mode and TXVECTOR
+  struct Table
+  {
+    double step;                 //!< the SNR step (dB)
+    std::vector<double> values;  //!< the logarithm of the per-bit error exponent at each SNR
+    std::vector<bool> exact;     //!< whether each cell is handled by the decorated model
+  };
+
+  /**
+   * Return the table of the given mode and TXVECTOR, building it if needed
+   *
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \return the table
+   */
+  const Table & GetTable (WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * Sample the decorated model to build a table with the given step
+   *
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \param step the SNR step (dB)
+   * \param table the table to fill
+   */
+  void Sample (WifiMode mode, WifiTxVector txVector, double step, Table &table) const;
+  /**
+   * Interpolate the per-bit error exponent from a table
+   *
+   * \param table the table
+   * \param snrDb the SNR (dB)
+   * \param exponent the interpolated per-bit error exponent
+   * \return false if the decorated model must be used instead
+   */
+  bool Interpolate (const Table &table, double snrDb, double &exponent) const;
+  /**
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \param table the table
+   * \param i the index of the cell
+   * \return the interpolation error at the middle of the cell, to be compared
+   *         with the tolerance
+   */
+  double GetError (WifiMode mode, WifiTxVector txVector, const Table &table, std::size_t i) const;
+  /**
+   * \param mode the Wi-Fi mode
+   * \param txVector the TXVECTOR of the transmission
+   * \param snrDb the SNR (dB)
+   * \return the per-bit error exponent computed by the decorated model
+   */
+  double GetExponent (WifiMode mode, WifiTxVector txVector, double snrDb) const;
+
+  mutable Ptr<ErrorRateModel> m_errorRateModel; //!< the decorated error rate model
+  double m_tolerance;                           //!< relative tolerance on the interpolated error exponents
+  double m_minSnrDb;                            //!< lowest SNR in the tables (dB)
+  double m_maxSnrDb;                            //!< highest SNR in the tables (dB)
+  mutable std::map<TableKey, Table> m_tables;   //!< tables built so far
+};
+
+} //namespace ns3
+
+#endif /* CACHED_ERROR_RATE_MODEL_H */
@@ -19,6 +19,7 @@
  *          Sébastien Deronne <sebastien.deronne@gmail.com>
  */
 
+#include <algorithm>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
@@ -115,6 +116,85 @@ InterferenceHelper::NiChange::GetEvent (void) const
 }
 
 
+/****************************************************************
+ *       Sorted vector of SNIR change events
+ ****************************************************************/
+
+InterferenceHelper::NiChangeVector::iterator
+InterferenceHelper::NiChangeVector::begin (void)
+{
+  return m_changes.begin ();
+}
+
+InterferenceHelper::NiChangeVector::const_iterator
+InterferenceHelper::NiChangeVector::begin (void) const
+{
+  return m_changes.begin ();
+}
+
+InterferenceHelper::NiChangeVector::iterator
+InterferenceHelper::NiChangeVector::end (void)
+{
+  return m_changes.end ();
+}
+
+InterferenceHelper::NiChangeVector::const_iterator
+InterferenceHelper::NiChangeVector::end (void) const
+{
+  return m_changes.end ();
+}
+
+InterferenceHelper::NiChangeVector::iterator
+InterferenceHelper::NiChangeVector::upper_bound (Time moment)
+{
+  return std::upper_bound (m_changes.begin (), m_changes.end (), moment,
+                           [] (const Time &t, const value_type &change) { return t < change.first; });
+}
+
+InterferenceHelper::NiChangeVector::const_iterator
+InterferenceHelper::NiChangeVector::upper_bound (Time moment) const
+{
+  return std::upper_bound (m_changes.begin (), m_changes.end (), moment,
+                           [] (const Time &t, const value_type &change) { return t < change.first; });
+}
+
+InterferenceHelper::NiChangeVector::iterator
+InterferenceHelper::NiChangeVector::find (Time moment)
+{
+  iterator it = std::lower_bound (m_changes.begin (), m_changes.end (), moment,
+                                   [] (const value_type &change, const Time &t) { return change.first < t; });
+  return (it != m_changes.end () && it->first == moment) ? it : m_changes.end ();
+}
+
+InterferenceHelper::NiChangeVector::const_iterator
+InterferenceHelper::NiChangeVector::find (Time moment) const
+{
+  const_iterator it = std::lower_bound (m_changes.begin (), m_changes.end (), moment,
+                                         [] (const value_type &change, const Time &t) { return change.first < t; });
+  return (it != m_changes.end () && it->first == moment) ? it : m_changes.end ();
+}
+
+InterferenceHelper::NiChangeVector::iterator
+InterferenceHelper::NiChangeVector::insert (const_iterator position, const value_type &value)
+{
+  NS_ASSERT (position == m_changes.begin () || (position - 1)->first <= value.first);
+  NS_ASSERT (position == m_changes.end () || value.first <= position->first);
+  return m_changes.insert (position, value);
+}
+
+InterferenceHelper::NiChangeVector::iterator
+InterferenceHelper::NiChangeVector::erase (const_iterator first, const_iterator last)
+{
+  return m_changes.erase (first, last);
+}
+
+void
+InterferenceHelper::NiChangeVector::clear (void)
+{
+  m_changes.clear ();
+}
+
+
 /****************************************************************
  *       The actual InterferenceHelper
  ****************************************************************/
@@ -122,11 +202,12 @@ InterferenceHelper::NiChange::GetEvent (void) const
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_numRxAntennas (1),
+    m_niChangesStorage (NI_CHANGES_SORTED_VECTOR),
     m_firstPower (0),
     m_rxing (false)
 {
   // Always have a zero power noise event in the list
-  AddNiChangeEvent (Time (0), NiChange (0.0, 0));
+  AddNiChangeEvent (m_niChangeVector, Time (0), NiChange (0.0, 0));
 }
 
 InterferenceHelper::~InterferenceHelper ()
@@ -177,13 +258,58 @@ InterferenceHelper::SetNumberOfReceiveAntennas (uint8_t rx)
   m_numRxAntennas = rx;
 }
 
+void
+InterferenceHelper::SetNiChangesStorage (NiChangesStorage storage)
+{
+  if (storage == m_niChangesStorage)
+    {
+      return;
+    }
+  if (storage == NI_CHANGES_SORTED_VECTOR)
+    {
+      m_niChangeVector.clear ();
+      for (auto it = m_niChanges.begin (); it != m_niChanges.end (); ++it)
+        {
+          m_niChangeVector.insert (m_niChangeVector.end (), *it);
+        }
+      m_niChanges.clear ();
+    }
+  else
+    {
+      m_niChanges.clear ();
+      for (auto it = m_niChangeVector.begin (); it != m_niChangeVector.end (); ++it)
+        {
+          m_niChanges.insert (m_niChanges.end (), *it);
+        }
+      m_niChangeVector.clear ();
+    }
+  m_niChangesStorage = storage;
+}
+
+InterferenceHelper::NiChangesStorage
+InterferenceHelper::GetNiChangesStorage (void) const
+{
+  return m_niChangesStorage;
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW) const
+{
+  if (m_niChangesStorage == NI_CHANGES_SORTED_VECTOR)
+    {
+      return DoGetEnergyDuration (m_niChangeVector, energyW);
+    }
+  return DoGetEnergyDuration (m_niChanges, energyW);
+}
+
+template <class T>
+Time
+InterferenceHelper::DoGetEnergyDuration (const T &niChanges, double energyW) const
 {
   Time now = Simulator::Now ();
-  auto i = GetPreviousPosition (now);
+  auto i = GetPreviousPosition (niChanges, now);
   Time end = i->first;
-  for (; i != m_niChanges.end (); ++i)
+  for (; i != niChanges.end (); ++i)
     {
       double noiseInterferenceW = i->second.GetPower ();
       end = i->first;
@@ -199,24 +325,41 @@ void
 InterferenceHelper::AppendEvent (Ptr<Event> event)
 {
   NS_LOG_FUNCTION (this);
+  if (m_niChangesStorage == NI_CHANGES_SORTED_VECTOR)
+    {
+      DoAppendEvent (m_niChangeVector, event);
+    }
+  else
+    {
+      DoAppendEvent (m_niChanges, event);
+    }
+}
+
+template <class T>
+void
+InterferenceHelper::DoAppendEvent (T &niChanges, Ptr<Event> event)
+{
   double previousPowerStart = 0;
   double previousPowerEnd = 0;
-  previousPowerStart = GetPreviousPosition (event->GetStartTime ())->second.GetPower ();
-  previousPowerEnd = GetPreviousPosition (event->GetEndTime ())->second.GetPower ();
+  previousPowerStart = GetPreviousPosition (niChanges, event->GetStartTime ())->second.GetPower ();
+  previousPowerEnd = GetPreviousPosition (niChanges, event->GetEndTime ())->second.GetPower ();
 
   if (!m_rxing)
     {
       m_firstPower = previousPowerStart;
       // Always leave the first zero power noise event in the list
-      m_niChanges.erase (++(m_niChanges.begin ()),
-                         GetNextPosition (event->GetStartTime ()));
+      niChanges.erase (++(niChanges.begin ()),
+                       GetNextPosition (niChanges, event->GetStartTime ()));
     }
-  auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
-  auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
+  auto first = AddNiChangeEvent (niChanges, event->GetStartTime (), NiChange (previousPowerStart, event));
+  // add the power of the event to the changes up to (and including those at)
+  // its end before inserting the end change, which may invalidate iterators
+  auto last = GetNextPosition (niChanges, event->GetEndTime ());
   for (auto i = first; i != last; ++i)
     {
       i->second.AddPower (event->GetRxPowerW ());
     }
+  AddNiChangeEvent (niChanges, event->GetEndTime (), NiChange (previousPowerEnd, event));
 }
 
 double
@@ -235,22 +378,34 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint1
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiPowers *ni) const
+{
+  if (m_niChangesStorage == NI_CHANGES_SORTED_VECTOR)
+    {
+      return DoCalculateNoiseInterferenceW (m_niChangeVector, event, ni);
+    }
+  return DoCalculateNoiseInterferenceW (m_niChanges, event, ni);
+}
+
+template <class T>
+double
+InterferenceHelper::DoCalculateNoiseInterferenceW (const T &niChanges, Ptr<Event> event, NiPowers *ni) const
 {
   double noiseInterferenceW = m_firstPower;
-  auto it = m_niChanges.find (event->GetStartTime ());
-  for (; it != m_niChanges.end () && it->first < Simulator::Now (); ++it)
+  auto it = niChanges.find (event->GetStartTime ());
+  for (; it != niChanges.end () && it->first < Simulator::Now (); ++it)
     {
       noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW ();
     }
-  it = m_niChanges.find (event->GetStartTime ());
-  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+  it = niChanges.find (event->GetStartTime ());
+  for (; it != niChanges.end () && it->second.GetEvent () != event; ++it);
+  ni->clear ();
+  ni->push_back (std::make_pair (event->GetStartTime (), 0.0));
+  while (++it != niChanges.end () && it->second.GetEvent () != event)
     {
-      ni->insert (*it);
+      ni->push_back (std::make_pair (it->first, it->second.GetPower ()));
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
+  ni->push_back (std::make_pair (event->GetEndTime (), 0.0));
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -278,12 +433,12 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni, std::pair<Time, Time> window) const
+InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, const NiPowers &ni, std::pair<Time, Time> window) const
 {
   NS_LOG_FUNCTION (this << window.first << window.second);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = ni.begin ();
   Time previous = j->first;
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = txVector.GetPreambleType ();
@@ -295,7 +450,7 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni,
   Time windowEnd = plcpPayloadStart + window.second;
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  while (++j != ni.end ())
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -320,7 +475,7 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni,
                                             payloadMode, txVector);
           NS_LOG_DEBUG ("previous is before windowed payload and current is in the windowed payload: mode=" << payloadMode << ", psr=" << psr);
         }
-      noiseInterferenceW = j->second.GetPower () - powerW;
+      noiseInterferenceW = j->second - powerW;
       previous = j->first;
       if (previous > windowEnd)
         {
@@ -334,12 +489,12 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni,
 }
 
 double
-InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, const NiPowers &ni) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = ni.begin ();
   Time previous = j->first;
   WifiPreamble preamble = txVector.GetPreambleType ();
   WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (txVector);
@@ -349,7 +504,7 @@ InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChang
   Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  while (++j != ni.end ())
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -469,7 +624,7 @@ InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChang
             }
         }
 
-      noiseInterferenceW = j->second.GetPower () - powerW;
+      noiseInterferenceW = j->second - powerW;
       previous = j->first;
     }
 
@@ -478,12 +633,12 @@ InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChang
 }
 
 double
-InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, const NiPowers &ni) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = ni.begin ();
   Time previous = j->first;
   WifiPreamble preamble = txVector.GetPreambleType ();
   WifiMode mcsHeaderMode;
@@ -509,7 +664,7 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiCh
   Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  while (++j != ni.end ())
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -838,7 +993,7 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiCh
             }
         }
 
-      noiseInterferenceW = j->second.GetPower () - powerW;
+      noiseInterferenceW = j->second - powerW;
       previous = j->first;
     }
 
@@ -849,8 +1004,7 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiCh
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, std::pair<Time, Time> relativeMpduStartStop) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &m_niPowers);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -858,7 +1012,7 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, std::pair<Time, Ti
   /* calculate the SNIR at the start of the MPDU (located through windowing) and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePayloadPer (event, &ni, relativeMpduStartStop);
+  double per = CalculatePayloadPer (event, m_niPowers, relativeMpduStartStop);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -869,8 +1023,7 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, std::pair<Time, Ti
 double
 InterferenceHelper::CalculateSnr (Ptr<Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &m_niPowers);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -880,8 +1033,7 @@ InterferenceHelper::CalculateSnr (Ptr<Event> event) const
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &m_niPowers);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -889,7 +1041,7 @@ InterferenceHelper::CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculateLegacyPhyHeaderPer (event, &ni);
+  double per = CalculateLegacyPhyHeaderPer (event, m_niPowers);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -900,8 +1052,7 @@ InterferenceHelper::CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateNonLegacyPhyHeaderSnrPer (Ptr<Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &m_niPowers);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -909,7 +1060,7 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderSnrPer (Ptr<Event> event) const
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculateNonLegacyPhyHeaderPer (event, &ni);
+  double per = CalculateNonLegacyPhyHeaderPer (event, m_niPowers);
   
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -921,32 +1072,52 @@ void
 InterferenceHelper::EraseEvents (void)
 {
   m_niChanges.clear ();
+  m_niChangeVector.clear ();
   // Always have a zero power noise event in the list
-  AddNiChangeEvent (Time (0), NiChange (0.0, 0));
+  if (m_niChangesStorage == NI_CHANGES_SORTED_VECTOR)
+    {
+      AddNiChangeEvent (m_niChangeVector, Time (0), NiChange (0.0, 0));
+    }
+  else
+    {
+      AddNiChangeEvent (m_niChanges, Time (0), NiChange (0.0, 0));
+    }
   m_rxing = false;
   m_firstPower = 0;
 }
 
-InterferenceHelper::NiChanges::const_iterator
-InterferenceHelper::GetNextPosition (Time moment) const
+template <class T>
+typename T::iterator
+InterferenceHelper::GetNextPosition (T &niChanges, Time moment) const
 {
-  return m_niChanges.upper_bound (moment);
+  return niChanges.upper_bound (moment);
 }
 
-InterferenceHelper::NiChanges::const_iterator
-InterferenceHelper::GetPreviousPosition (Time moment) const
+template <class T>
+typename T::const_iterator
+InterferenceHelper::GetPreviousPosition (const T &niChanges, Time moment) const
 {
-  auto it = GetNextPosition (moment);
+  auto it = niChanges.upper_bound (moment);
   // This is safe since there is always an NiChange at time 0,
   // before moment.
   --it;
   return it;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
+template <class T>
+typename T::iterator
+InterferenceHelper::AddNiChangeEvent (T &niChanges, Time moment, NiChange change)
+{
+  return niChanges.insert (GetNextPosition (niChanges, moment), std::make_pair (moment, change));
+}
+
+template <class T>
+double
+InterferenceHelper::GetPowerBeforeNow (const T &niChanges) const
 {
-  return m_niChanges.insert (GetNextPosition (moment), std::make_pair (moment, change));
+  auto it = niChanges.find (Simulator::Now ());
+  it--;
+  return it->second.GetPower ();
 }
 
 void
@@ -962,9 +1133,14 @@ InterferenceHelper::NotifyRxEnd ()
   NS_LOG_FUNCTION (this);
   m_rxing = false;
   //Update m_firstPower for frame capture
-  auto it = m_niChanges.find (Simulator::Now ());
-  it--;
-  m_firstPower = it->second.GetPower ();
+  if (m_niChangesStorage == NI_CHANGES_SORTED_VECTOR)
+    {
+      m_firstPower = GetPowerBeforeNow (m_niChangeVector);
+    }
+  else
+    {
+      m_firstPower = GetPowerBeforeNow (m_niChanges);
+    }
 }
 
 } //namespace ns3
@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -114,6 +115,15 @@ public:
     double per; ///< PER
   };
 
+  /**
+   * The data structures available to store the noise and interference changes
+   */
+  enum NiChangesStorage
+  {
+    NI_CHANGES_MULTIMAP,     //!< a multimap of the changes indexed by time
+    NI_CHANGES_SORTED_VECTOR //!< a vector of the changes sorted by time
+  };
+
   InterferenceHelper ();
   ~InterferenceHelper ();
 
@@ -143,6 +153,19 @@ public:
    * \param rx the number of RX antennas
    */
   void SetNumberOfReceiveAntennas (uint8_t rx);
+  /**
+   * Set the data structure used to store the noise and interference changes.
+   * The changes already recorded are moved to the new data structure.
+   *
+   * \param storage the data structure used to store the changes
+   */
+  void SetNiChangesStorage (NiChangesStorage storage);
+  /**
+   * Return the data structure used to store the noise and interference changes.
+   *
+   * \return the data structure used to store the changes
+   */
+  NiChangesStorage GetNiChangesStorage (void) const;
 
   /**
    * \param energyW the minimum energy (W) requested
@@ -269,6 +292,90 @@ private:
    */
   typedef std::multimap<Time, NiChange> NiChanges;
 
+  /**
+   * A vector of NiChanges sorted by time, offering the subset of the
+   * interface of NiChanges used by InterferenceHelper. NiChanges with
+   * the same time are kept in insertion order, as in a multimap.
+   */
+  class NiChangeVector
+  {
+public:
+    /// the type of the stored elements
+    typedef std::pair<Time, NiChange> value_type;
+    /// iterator over the NiChanges
+    typedef std::vector<value_type>::iterator iterator;
+    /// const iterator over the NiChanges
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    /**
+     * \return an iterator to the first NiChange
+     */
+    iterator begin (void);
+    /**
+     * \return a const iterator to the first NiChange
+     */
+    const_iterator begin (void) const;
+    /**
+     * \return an iterator past the last NiChange
+     */
+    iterator end (void);
+    /**
+     * \return a const iterator past the last NiChange
+     */
+    const_iterator end (void) const;
+    /**
+     * \param moment the time to search for
+     * \return an iterator to the first NiChange later than moment
+     */
+    iterator upper_bound (Time moment);
+    /**
+     * \param moment the time to search for
+     * \return a const iterator to the first NiChange later than moment
+     */
+    const_iterator upper_bound (Time moment) const;
+    /**
+     * \param moment the time to search for
+     * \return an iterator to the first NiChange at moment, or end () if none
+     */
+    iterator find (Time moment);
+    /**
+     * \param moment the time to search for
+     * \return a const iterator to the first NiChange at moment, or end () if none
+     */
+    const_iterator find (Time moment) const;
+    /**
+     * Insert a NiChange before the given position, which must keep the
+     * NiChanges sorted by time.
+     *
+     * \param position the position of the new NiChange
+     * \param value the new NiChange
+     * \return an iterator to the new NiChange
+     */
+    iterator insert (const_iterator position, const value_type &value);
+    /**
+     * Erase a range of NiChanges.
+     *
+     * \param first the first NiChange to erase
+     * \param last the NiChange following the last NiChange to erase
+     * \return an iterator to the NiChange following the erased ones
+     */
+    iterator erase (const_iterator first, const_iterator last);
+    /**
+     * Erase all the NiChanges.
+     */
+    void clear (void);
+
+
+private:
+    std::vector<value_type> m_changes; ///< NiChanges sorted by time
+  };
+
+  /**
+   * typedef for a vector of the times and the powers of the NiChanges
+   * seen by a signal
+   */
+  typedef std::vector<std::pair<Time, double> > NiPowers;
+
   /**
    * Append the given Event.
    *
@@ -279,11 +386,12 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event
-   * \param ni
+   * \param ni the list filled with the times and the powers of the NiChanges
+   *        seen by the event, starting with its start and ending with its end
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiPowers *ni) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    *
@@ -317,7 +425,7 @@ private:
    *
    * \return the error rate of the payload
    */
-  double CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni, std::pair<Time, Time> window) const;
+  double CalculatePayloadPer (Ptr<const Event> event, const NiPowers &ni, std::pair<Time, Time> window) const;
   /**
    * Calculate the error rate of the legacy PHY header. The legacy PHY header
    * can be divided into multiple chunks (e.g. due to interference from other transmissions).
@@ -327,7 +435,7 @@ private:
    *
    * \return the error rate of the legacy PHY header
    */
-  double CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculateLegacyPhyHeaderPer (Ptr<const Event> event, const NiPowers &ni) const;
   /**
    * Calculate the error rate of the non-legacy PHY header. The non-legacy PHY header
    * can be divided into multiple chunks (e.g. due to interference from other transmissions).
@@ -337,47 +445,84 @@ private:
    *
    * \return the error rate of the non-legacy PHY header
    */
-  double CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, const NiPowers &ni) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel; ///< error rate model
   uint8_t m_numRxAntennas; /**< the number of RX antennas in the corresponding receiver */
+  NiChangesStorage m_niChangesStorage; ///< the data structure used to store the NiChanges
   /// Experimental: needed for energy duration calculation
   NiChanges m_niChanges;
+  NiChangeVector m_niChangeVector; ///< NiChanges, when stored in a sorted vector
+  mutable NiPowers m_niPowers; ///< NiChanges seen by the last evaluated event, reused to avoid allocations
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
 
   /**
    * Returns an iterator to the first nichange that is later than moment
    *
+   * \param niChanges the NiChanges
    * \param moment time to check from
    * \returns an iterator to the list of NiChanges
    */
-  NiChanges::const_iterator GetNextPosition (Time moment) const;
-  /**
-   * Returns an iterator to the first nichange that is later than moment
-   *
-   * \param moment time to check from
-   * \returns an iterator to the list of NiChanges
-   */
-  //NiChanges::iterator GetNextPosition (Time moment);
+  template <class T>
+  typename T::iterator GetNextPosition (T &niChanges, Time moment) const;
   /**
    * Returns an iterator to the last nichange that is before than moment
    *
+   * \param niChanges the NiChanges
    * \param moment time to check from
    * \returns an iterator to the list of NiChanges
    */
-  NiChanges::const_iterator GetPreviousPosition (Time moment) const;
+  template <class T>
+  typename T::const_iterator GetPreviousPosition (const T &niChanges, Time moment) const;
 
   /**
    * Add NiChange to the list at the appropriate position and
    * return the iterator of the new event.
    *
+   * \param niChanges the NiChanges
    * \param moment
    * \param change
    * \returns the iterator of the new event
    */
-  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change);
+  template <class T>
+  typename T::iterator AddNiChangeEvent (T &niChanges, Time moment, NiChange change);
+  /**
+   * Append the given Event to the given NiChanges.
+   *
+   * \param niChanges the NiChanges
+   * \param event
+   */
+  template <class T>
+  void DoAppendEvent (T &niChanges, Ptr<Event> event);
+  /**
+   * \param niChanges the NiChanges
+   * \param energyW the minimum energy (W) requested
+   *
+   * \returns the expected amount of time the observed
+   *          energy on the medium will be higher than
+   *          the requested threshold.
+   */
+  template <class T>
+  Time DoGetEnergyDuration (const T &niChanges, double energyW) const;
+  /**
+   * Calculate noise and interference power in W from the given NiChanges.
+   *
+   * \param niChanges the NiChanges
+   * \param event
+   * \param ni the list filled with the NiChanges seen by the event
+   *
+   * \return noise and interference power
+   */
+  template <class T>
+  double DoCalculateNoiseInterferenceW (const T &niChanges, Ptr<Event> event, NiPowers *ni) const;
+  /**
+   * \param niChanges the NiChanges
+   * \return the power of the last NiChange before now
+   */
+  template <class T>
+  double GetPowerBeforeNow (const T &niChanges) const;
 };
 
 } //namespace ns3
@@ -1210,4 +1210,17 @@ WifiMacHeader::Deserialize (Buffer::Iterator start)
   return i.GetDistanceFrom (start);
 }
 
+bool
+WifiMacHeader::IsSelfContained (void) const
+{
+  // a copy must not carry the fields which Deserialize leaves untouched:
+  // the addresses and the sequence control of the control frames, and the
+  // fourth address of the frames which are not relayed between two DSs
+  if (m_ctrlType == TYPE_CTL)
+    {
+      return false;
+    }
+  return (m_ctrlToDs && m_ctrlFromDs) || m_addr4 == Mac48Address ();
+}
+
 } //namespace ns3
@@ -118,6 +118,7 @@ public:
   uint32_t GetSerializedSize (void) const;
   void Serialize (Buffer::Iterator start) const;
   uint32_t Deserialize (Buffer::Iterator start);
+  bool IsSelfContained (void) const;
 
   /**
    * Set the From DS bit in the Frame Control field.
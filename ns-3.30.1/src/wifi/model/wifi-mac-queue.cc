@@ -116,6 +116,128 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
   return false;
 }
 
+bool
+WifiMacQueue::HasExpiredItems (void) const
+{
+  return !m_timestamps.empty () && Simulator::Now () > *m_timestamps.begin () + m_maxDelay;
+}
+
+void
+WifiMacQueue::RemoveExpiredItems (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!HasExpiredItems ())
+    {
+      return;
+    }
+  for (ConstIterator it = begin (); it != end (); )
+    {
+      if (!TtlExceeded (it))
+        {
+          it++;
+        }
+    }
+}
+
+WifiMacQueue::ReceiverQueues::ReceiverQueues ()
+  : nDataPackets (0)
+{
+}
+
+void
+WifiMacQueue::AddToIndex (ConstIterator pos)
+{
+  const WifiMacHeader &hdr = (*pos)->GetHeader ();
+  m_timestamps.insert ((*pos)->GetTimeStamp ());
+  if (!hdr.IsData ())
+    {
+      return;
+    }
+  ReceiverQueues &receiver = m_receivers[(*pos)->GetDestinationAddress ()];
+  receiver.nDataPackets++;
+  if (!hdr.IsQosData ())
+    {
+      return;
+    }
+  NS_ASSERT (hdr.GetQosTid () < 16);
+  TidQueue &tidQueue = receiver.tidQueues[hdr.GetQosTid ()];
+  // find the first item of the same TID queue following the new item
+  TidQueue::iterator next = tidQueue.end ();
+  if (!tidQueue.empty () && pos != std::prev (end ()))
+    {
+      if (pos == begin ())
+        {
+          next = tidQueue.begin ();
+        }
+      else
+        {
+          for (ConstIterator it = std::next (pos); it != end (); it++)
+            {
+              auto position = m_tidQueuePositions.find (GetPointer (*it));
+              if (position != m_tidQueuePositions.end ()
+                  && (*it)->GetDestinationAddress () == (*pos)->GetDestinationAddress ()
+                  && (*it)->GetHeader ().GetQosTid () == hdr.GetQosTid ())
+                {
+                  next = position->second;
+                  break;
+                }
+            }
+        }
+    }
+  m_tidQueuePositions[GetPointer (*pos)] = tidQueue.insert (next, pos);
+}
+
+void
+WifiMacQueue::RemoveFromIndex (ConstIterator pos)
+{
+  const WifiMacHeader &hdr = (*pos)->GetHeader ();
+  m_timestamps.erase (m_timestamps.find ((*pos)->GetTimeStamp ()));
+  if (!hdr.IsData ())
+    {
+      return;
+    }
+  auto receiver = m_receivers.find ((*pos)->GetDestinationAddress ());
+  NS_ASSERT (receiver != m_receivers.end () && receiver->second.nDataPackets > 0);
+  receiver->second.nDataPackets--;
+  if (hdr.IsQosData ())
+    {
+      auto position = m_tidQueuePositions.find (GetPointer (*pos));
+      NS_ASSERT (position != m_tidQueuePositions.end ());
+      receiver->second.tidQueues[hdr.GetQosTid ()].erase (position->second);
+      m_tidQueuePositions.erase (position);
+    }
+  if (receiver->second.nDataPackets == 0)
+    {
+      // the TID queues are empty too: forget the receiver
+      m_receivers.erase (receiver);
+    }
+}
+
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  AddToIndex (std::prev (pos));
+  return true;
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  RemoveFromIndex (pos);
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  RemoveFromIndex (pos);
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
 {
@@ -148,7 +270,7 @@ WifiMacQueue::Insert (ConstIterator pos, Ptr<WifiMacQueueItem> item)
     }
 
   // the queue is full; scan the list in the attempt to remove stale packets
-  ConstIterator it = begin ();
+  ConstIterator it = (HasExpiredItems () ? begin () : end ());
   while (it != end ())
     {
       if (it == pos && TtlExceeded (it))
@@ -356,24 +478,51 @@ WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << +tid << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
-  while (it != end ())
+  auto receiver = m_receivers.find (dest);
+  if (receiver == m_receivers.end () || (pos != EMPTY && pos == end ()))
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (Simulator::Now () <= (*it)->GetTimeStamp () + m_maxDelay)
+      NS_LOG_DEBUG ("The queue is empty");
+      return end ();
+    }
+  NS_ASSERT (tid < 16);
+  const TidQueue &tidQueue = receiver->second.tidQueues[tid];
+  TidQueue::const_iterator it = tidQueue.begin ();
+  if (pos != EMPTY)
+    {
+      auto inTidQueue = [tid, dest] (Ptr<const WifiMacQueueItem> item)
+        {
+          return item->GetHeader ().IsQosData () && item->GetDestinationAddress () == dest
+                 && item->GetHeader ().GetQosTid () == tid;
+        };
+      if (inTidQueue (*pos))
+        {
+          it = m_tidQueuePositions.find (GetPointer (*pos))->second;
+        }
+      else if (pos != begin () && inTidQueue (*std::prev (pos)))
+        {
+          // the search typically starts from the item following the one previously returned
+          it = std::next (m_tidQueuePositions.find (GetPointer (*std::prev (pos)))->second);
+        }
+      else
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
+          // find the first item of the TID queue following the given position
+          while (pos != end () && !inTidQueue (*pos))
             {
-              return it;
+              pos++;
             }
+          it = (pos != end () ? m_tidQueuePositions.find (GetPointer (*pos))->second : tidQueue.end ());
         }
-      else
+    }
+  while (it != tidQueue.end ())
+    {
+      // skip packets that stayed in the queue for too long. They will be
+      // actually removed from the queue by the next call to a non-const method
+      if (Simulator::Now () <= (**it)->GetTimeStamp () + m_maxDelay)
         {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
+          return *it;
         }
+      // signal the presence of expired packets
+      m_expiredPacketsPresent = true;
       it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -483,21 +632,9 @@ uint32_t
 WifiMacQueue::GetNPacketsByAddress (Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-
-  uint32_t nPackets = 0;
-
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
-    }
+  RemoveExpiredItems ();
+  auto receiver = m_receivers.find (dest);
+  uint32_t nPackets = (receiver != m_receivers.end () ? receiver->second.nDataPackets : 0);
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
 }
@@ -506,29 +643,26 @@ uint32_t
 WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  uint32_t nPackets = 0;
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
-    }
+  RemoveExpiredItems ();
+  auto receiver = m_receivers.find (dest);
+  NS_ASSERT (tid < 16);
+  uint32_t nPackets = (receiver != m_receivers.end () ? static_cast<uint32_t> (receiver->second.tidQueues[tid].size ()) : 0);
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
 }
 
+std::size_t
+WifiMacQueue::GetNReceivers (void) const
+{
+  return m_receivers.size ();
+}
+
 bool
 WifiMacQueue::IsEmpty (void)
 {
   NS_LOG_FUNCTION (this);
-  for (ConstIterator it = begin (); it != end (); )
+  ConstIterator it = (HasExpiredItems () ? begin () : end ());
+  while (it != end ())
     {
       if (!TtlExceeded (it))
         {
@@ -536,8 +670,9 @@ WifiMacQueue::IsEmpty (void)
           return false;
         }
     }
-  NS_LOG_DEBUG ("returns true");
-  return true;
+  bool isEmpty = QueueBase::IsEmpty ();
+  NS_LOG_DEBUG ("returns " << std::boolalpha << isEmpty);
+  return isEmpty;
 }
 
 uint32_t
@@ -545,13 +680,7 @@ WifiMacQueue::GetNPackets (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpiredItems ();
   return QueueBase::GetNPackets ();
 }
 
@@ -560,13 +689,7 @@ WifiMacQueue::GetNBytes (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpiredItems ();
   return QueueBase::GetNBytes ();
 }
 
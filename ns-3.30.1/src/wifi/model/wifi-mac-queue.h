@@ -24,6 +24,8 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
+#include <set>
+#include <unordered_map>
 #include "wifi-mac-queue-item.h"
 #include "ns3/queue.h"
 
@@ -53,6 +55,14 @@ extern template class Queue<WifiMacQueueItem>;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * The queue keeps, for each receiver, the number of queued Data frames
+ * and the list of queued QoS Data frames of each TID, as well as the
+ * timestamps of all the queued items.  Hence, the number of packets
+ * addressed to a receiver (for a TID) is returned in constant time, the
+ * search for the packets of a given TID and receiver does not visit the
+ * packets of other TIDs or receivers, and the queue is only scanned for
+ * expired packets when the oldest packet has expired.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -289,6 +299,13 @@ public:
    * \return the number of QoS packets
    */
   uint32_t GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest);
+  /**
+   * Return the number of receivers of the queued Data frames, including
+   * the expired ones not removed yet.
+   *
+   * \return the number of receivers
+   */
+  std::size_t GetNReceivers (void) const;
 
   /**
    * \return true if the queue is empty; false otherwise
@@ -323,6 +340,70 @@ private:
    * \return true if the item is removed, false otherwise
    */
   bool TtlExceeded (ConstIterator &it);
+  /**
+   * \return true if the lifetime of some packets in the queue has expired
+   */
+  bool HasExpiredItems (void) const;
+  /**
+   * Remove all the packets whose lifetime has expired.
+   */
+  void RemoveExpiredItems (void);
+
+  /**
+   * Insert the given item before the given position and add it to the index.
+   * Hides the method of the base class, so that the index is updated every
+   * time an item is inserted.
+   *
+   * \param pos the position before which the item is to be inserted
+   * \param item the item to be inserted
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Dequeue the item at the given position and remove it from the index.
+   *
+   * \param pos the position of the item to be dequeued
+   * \return the dequeued item
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Drop the item at the given position and remove it from the index.
+   *
+   * \param pos the position of the item to be dropped
+   * \return the dropped item
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+  /**
+   * Add the item at the given position to the index.
+   *
+   * \param pos the position of the item
+   */
+  void AddToIndex (ConstIterator pos);
+  /**
+   * Remove the item at the given position from the index.
+   *
+   * \param pos the position of the item
+   */
+  void RemoveFromIndex (ConstIterator pos);
+
+  /// The positions in the queue of the QoS Data frames of a given receiver and TID, in queue order
+  typedef std::list<ConstIterator> TidQueue;
+
+  /// The packets queued for a given receiver
+  struct ReceiverQueues
+  {
+    ReceiverQueues ();
+
+    uint32_t nDataPackets;  //!< number of Data frames (including QoS Data frames)
+    TidQueue tidQueues[16]; //!< QoS Data frames, for each TID
+  };
+
+  /// Packets queued for each receiver
+  std::unordered_map<Mac48Address, ReceiverQueues, Mac48AddressHash> m_receivers;
+  /// Position in its TID queue of every queued QoS Data frame
+  std::unordered_map<const WifiMacQueueItem *, TidQueue::iterator> m_tidQueuePositions;
+  /// Timestamps of the queued items, to determine whether some of them expired
+  std::multiset<Time> m_timestamps;
 
   QueueSize m_maxSize;                      //!< max queue size
   Time m_maxDelay;                          //!< Time to live for packets in the queue
@@ -682,6 +682,14 @@ ATTRIBUTE_HELPER_CPP (WifiMode);
 
 WifiModeFactory::WifiModeFactory ()
 {
+  uint32_t uid = AllocateUid ("Invalid-WifiMode");
+  WifiModeItem *item = Get (uid);
+  item->uniqueUid = "Invalid-WifiMode";
+  item->modClass = WIFI_MOD_CLASS_UNKNOWN;
+  item->constellationSize = 0;
+  item->codingRate = WIFI_CODE_RATE_UNDEFINED;
+  item->isMandatory = false;
+  item->mcsValue = 0;
 }
 
 WifiMode
@@ -748,15 +756,10 @@ WifiModeFactory::CreateWifiMcs (std::string uniqueName,
 WifiMode
 WifiModeFactory::Search (std::string name) const
 {
-  WifiModeItemList::const_iterator i;
-  uint32_t j = 0;
-  for (i = m_itemList.begin (); i != m_itemList.end (); i++)
+  std::unordered_map<std::string, uint32_t>::const_iterator it = m_uidByName.find (name);
+  if (it != m_uidByName.end ())
     {
-      if (i->uniqueUid == name)
-        {
-          return WifiMode (j);
-        }
-      j++;
+      return WifiMode (it->second);
     }
 
   //If we get here then a matching WifiMode was not found above. This
@@ -764,7 +767,7 @@ WifiModeFactory::Search (std::string name) const
   //list of WifiModes that are supported.
   NS_LOG_UNCOND ("Could not find match for WifiMode named \""
                  << name << "\". Valid options are:");
-  for (i = m_itemList.begin (); i != m_itemList.end (); i++)
+  for (WifiModeItemList::const_iterator i = m_itemList.begin (); i != m_itemList.end (); i++)
     {
       NS_LOG_UNCOND ("  " << i->uniqueUid);
     }
@@ -783,17 +786,13 @@ WifiModeFactory::Search (std::string name) const
 uint32_t
 WifiModeFactory::AllocateUid (std::string uniqueUid)
 {
-  uint32_t j = 0;
-  for (WifiModeItemList::const_iterator i = m_itemList.begin ();
-       i != m_itemList.end (); i++)
+  uint32_t uid = static_cast<uint32_t> (m_itemList.size ());
+  std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> ret =
+    m_uidByName.insert (std::make_pair (uniqueUid, uid));
+  if (!ret.second)
     {
-      if (i->uniqueUid == uniqueUid)
-        {
-          return j;
-        }
-      j++;
+      return ret.first->second;
     }
-  uint32_t uid = static_cast<uint32_t> (m_itemList.size ());
   m_itemList.push_back (WifiModeItem ());
   return uid;
 }
@@ -808,20 +807,7 @@ WifiModeFactory::Get (uint32_t uid)
 WifiModeFactory *
 WifiModeFactory::GetFactory (void)
 {
-  static bool isFirstTime = true;
   static WifiModeFactory factory;
-  if (isFirstTime)
-    {
-      uint32_t uid = factory.AllocateUid ("Invalid-WifiMode");
-      WifiModeItem *item = factory.Get (uid);
-      item->uniqueUid = "Invalid-WifiMode";
-      item->modClass = WIFI_MOD_CLASS_UNKNOWN;
-      item->constellationSize = 0;
-      item->codingRate = WIFI_CODE_RATE_UNDEFINED;
-      item->isMandatory = false;
-      item->mcsValue = 0;
-      isFirstTime = false;
-    }
   return &factory;
 }
 
@@ -23,6 +23,7 @@
 #define WIFI_MODE_H
 
 #include <vector>
+#include <unordered_map>
 #include "ns3/attribute-helper.h"
 
 namespace ns3 {
@@ -338,7 +339,8 @@ private:
    */
   WifiMode Search (std::string name) const;
   /**
-   * Allocate a WifiModeItem from a given uniqueUid.
+   * Allocate a WifiModeItem from a given uniqueUid, unless one with
+   * the same uniqueUid was already allocated.
    *
    * \param uniqueUid
    *
@@ -359,6 +361,7 @@ private:
    */
   typedef std::vector<WifiModeItem> WifiModeItemList;
   WifiModeItemList m_itemList; ///< item list
+  std::unordered_map<std::string, uint32_t> m_uidByName; ///< the uid of each item, indexed by its unique name
 };
 
 } //namespace ns3
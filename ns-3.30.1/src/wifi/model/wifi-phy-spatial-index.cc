@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/mobility-position-store.h"
+#include "wifi-phy-spatial-index.h"
+#include "wifi-phy.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiPhySpatialIndex");
+
+WifiPhySpatialIndex::WifiPhySpatialIndex ()
+  : m_cellSize (100.0),
+    m_built (false),
+    m_minRxPowerThresholdDbm (std::numeric_limits<double>::infinity ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WifiPhySpatialIndex::~WifiPhySpatialIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+WifiPhySpatialIndex::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT (cellSize > 0);
+  m_cellSize = cellSize;
+  m_built = false;
+}
+
+void
+WifiPhySpatialIndex::Add (Ptr<WifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Entry entry;
+  entry.phy = phy;
+  entry.channelNumber = phy->GetChannelNumber ();
+  entry.static_ = false;
+  m_entries.push_back (entry);
+  m_built = false;
+}
+
+void
+WifiPhySpatialIndex::SetChannelNumber (std::size_t index, uint8_t channelNumber)
+{
+  NS_LOG_FUNCTION (this << index << +channelNumber);
+  NS_ASSERT (index < m_entries.size ());
+  if (m_built)
+    {
+      Remove (index);
+      m_entries[index].channelNumber = channelNumber;
+      Insert (index);
+    }
+  else
+    {
+      m_entries[index].channelNumber = channelNumber;
+    }
+}
+
+void
+WifiPhySpatialIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  Disconnect ();
+  m_entries.clear ();
+  m_grids.clear ();
+  m_candidates.clear ();
+  m_built = false;
+}
+
+void
+WifiPhySpatialIndex::Disconnect (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Entry>::iterator it = m_entries.begin (); it != m_entries.end (); it++)
+    {
+      if (it->mobility != 0 && m_mobilityEntries.erase (PeekPointer (it->mobility)) > 0)
+        {
+          it->mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                       MakeCallback (&WifiPhySpatialIndex::CourseChanged, this));
+        }
+      it->mobility = 0;
+    }
+  m_mobilityEntries.clear ();
+}
+
+int64_t
+WifiPhySpatialIndex::GetCellIndex (double coordinate) const
+{
+  return static_cast<int64_t> (std::floor (coordinate / m_cellSize));
+}
+
+void
+WifiPhySpatialIndex::Build (void)
+{
+  NS_LOG_FUNCTION (this);
+  Disconnect ();
+  m_grids.clear ();
+  for (std::size_t i = 0; i < m_entries.size (); i++)
+    {
+      Entry &entry = m_entries[i];
+      entry.mobility = entry.phy->GetMobility ();
+      if (entry.mobility != 0)
+        {
+          std::vector<std::size_t> &entries = m_mobilityEntries[PeekPointer (entry.mobility)];
+          if (entries.empty ())
+            {
+              entry.mobility->TraceConnectWithoutContext ("CourseChange",
+                                                          MakeCallback (&WifiPhySpatialIndex::CourseChanged, this));
+            }
+          entries.push_back (i);
+        }
+      Insert (i);
+    }
+  m_built = true;
+  UpdateMinRxPowerThreshold ();
+}
+
+void
+WifiPhySpatialIndex::UpdateMinRxPowerThreshold (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_built)
+    {
+      // computed when the grid is built
+      return;
+    }
+  m_minRxPowerThresholdDbm = std::numeric_limits<double>::infinity ();
+  for (std::vector<Entry>::const_iterator it = m_entries.begin (); it != m_entries.end (); it++)
+    {
+      m_minRxPowerThresholdDbm = std::min (m_minRxPowerThresholdDbm,
+                                           it->phy->GetRxSensitivity () - it->phy->GetRxGain ());
+    }
+}
+
+void
+WifiPhySpatialIndex::Insert (std::size_t index)
+{
+  Entry &entry = m_entries[index];
+  Grid &grid = m_grids[entry.channelNumber];
+  entry.static_ = false;
+  if (entry.mobility != 0)
+    {
+      Vector velocity = entry.mobility->GetVelocity ();
+      if (velocity.x == 0 && velocity.y == 0 && velocity.z == 0)
+        {
+          entry.static_ = true;
+          entry.position = entry.mobility->GetPosition ();
+          entry.cell = std::make_pair (GetCellIndex (entry.position.x), GetCellIndex (entry.position.y));
+          grid.cells[entry.cell].push_back (index);
+          return;
+        }
+    }
+  grid.moving.push_back (index);
+}
+
+void
+WifiPhySpatialIndex::Remove (std::size_t index)
+{
+  Entry &entry = m_entries[index];
+  Grid &grid = m_grids[entry.channelNumber];
+  if (entry.static_)
+    {
+      Cells::iterator cell = grid.cells.find (entry.cell);
+      NS_ASSERT (cell != grid.cells.end ());
+      cell->second.erase (std::find (cell->second.begin (), cell->second.end (), index));
+      if (cell->second.empty ())
+        {
+          grid.cells.erase (cell);
+        }
+    }
+  else
+    {
+      grid.moving.erase (std::find (grid.moving.begin (), grid.moving.end (), index));
+    }
+}
+
+void
+WifiPhySpatialIndex::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (!m_built)
+    {
+      return;
+    }
+  std::map<const MobilityModel *, std::vector<std::size_t> >::const_iterator it = m_mobilityEntries.find (PeekPointer (mobility));
+  if (it == m_mobilityEntries.end ())
+    {
+      return;
+    }
+  for (std::vector<std::size_t>::const_iterator i = it->second.begin (); i != it->second.end (); i++)
+    {
+      Remove (*i);
+      Insert (*i);
+    }
+}
+
+double
+WifiPhySpatialIndex::GetMinRxPowerThreshold (void)
+{
+  if (!m_built)
+    {
+      Build ();
+    }
+  return m_minRxPowerThresholdDbm;
+}
+
+const std::vector<std::size_t> &
+WifiPhySpatialIndex::GetCandidates (uint8_t channelNumber, const Vector &position, double range)
+{
+  NS_LOG_FUNCTION (this << +channelNumber << position << range);
+  if (!m_built)
+    {
+      Build ();
+    }
+  m_candidates.clear ();
+  std::map<uint8_t, Grid>::const_iterator it = m_grids.find (channelNumber);
+  if (it == m_grids.end ())
+    {
+      return m_candidates;
+    }
+  const Cells &cells = it->second.cells;
+  double range2 = range * range;
+  int64_t xMin = GetCellIndex (position.x - range);
+  int64_t xMax = GetCellIndex (position.x + range);
+  int64_t yMin = GetCellIndex (position.y - range);
+  int64_t yMax = GetCellIndex (position.y + range);
+  double nWindowCells = (static_cast<double> (xMax - xMin) + 1) * (static_cast<double> (yMax - yMin) + 1);
+  if (nWindowCells <= cells.size ())
+    {
+      for (int64_t x = xMin; x <= xMax; x++)
+        {
+          for (int64_t y = yMin; y <= yMax; y++)
+            {
+              Cells::const_iterator cell = cells.find (std::make_pair (x, y));
+              if (cell == cells.end ())
+                {
+                  continue;
+                }
+              for (std::vector<std::size_t>::const_iterator i = cell->second.begin (); i != cell->second.end (); i++)
+                {
+                  const Vector &p = m_entries[*i].position;
+                  if ((p.x - position.x) * (p.x - position.x) + (p.y - position.y) * (p.y - position.y) <= range2)
+                    {
+                      m_candidates.push_back (*i);
+                    }
+                }
+            }
+        }
+    }
+  else
+    {
+      // fewer occupied cells than cells in the query window
+      for (Cells::const_iterator cell = cells.begin (); cell != cells.end (); cell++)
+        {
+          if (cell->first.first < xMin || cell->first.first > xMax
+              || cell->first.second < yMin || cell->first.second > yMax)
+            {
+              continue;
+            }
+          for (std::vector<std::size_t>::const_iterator i = cell->second.begin (); i != cell->second.end (); i++)
+            {
+              const Vector &p = m_entries[*i].position;
+              if ((p.x - position.x) * (p.x - position.x) + (p.y - position.y) * (p.y - position.y) <= range2)
+                {
+                  m_candidates.push_back (*i);
+                }
+            }
+        }
+    }
+  // querying the position of a moving PHY may trigger a course change,
+  // which updates the list of moving PHYs
+  m_scan = it->second.moving;
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
+  for (std::vector<std::size_t>::const_iterator i = m_scan.begin (); i != m_scan.end (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_entries[*i].mobility;
+      if (mobility != 0)
+        {
+          Vector p = store->GetPosition (mobility->GetPositionIndex ());
+          if ((p.x - position.x) * (p.x - position.x) + (p.y - position.y) * (p.y - position.y) > range2)
+            {
+              continue;
+            }
+        }
+      m_candidates.push_back (*i);
+    }
+  std::sort (m_candidates.begin (), m_candidates.end ());
+  return m_candidates;
+}
+
+} //namespace ns3
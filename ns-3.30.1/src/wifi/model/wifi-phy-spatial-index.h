@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_PHY_SPATIAL_INDEX_H
+#define WIFI_PHY_SPATIAL_INDEX_H
+
+#include <map>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+class WifiPhy;
+class MobilityModel;
+
+/**
+ * \brief a uniform grid of the positions of the PHYs attached to a channel
+ * \ingroup wifi
+ *
+ * The grid allows a channel to retrieve the PHYs operating on a given
+ * channel number and located within a given distance from a transmitter
+ * without visiting all the attached PHYs.  A separate grid is kept for
+ * every channel number.
+ * PHYs are identified by the order in which they were added, so that the
+ * channel can process candidate receivers in the same order as when
+ * iterating over its whole PHY list.
+ *
+ * The grid is built lazily, because the mobility models are usually
+ * aggregated to the nodes after the PHYs have been attached to the channel.
+ * Positions are kept up to date through the CourseChange trace source of
+ * the mobility models: a PHY whose mobility model has a null velocity is
+ * stored in the grid cell of its position, while a moving PHY is kept in
+ * a separate list which is scanned at every query.  This assumes that a
+ * mobility model with a null velocity does not move until it next fires
+ * its CourseChange trace source, which holds for the ns-3 mobility models.
+ *
+ * The smallest reception threshold (RxSensitivity minus RxGain) of the
+ * indexed PHYs is computed when the grid is built, and must be updated
+ * through UpdateMinRxPowerThreshold when either attribute changes.
+ */
+class WifiPhySpatialIndex
+{
+public:
+  WifiPhySpatialIndex ();
+  ~WifiPhySpatialIndex ();
+
+  /**
+   * \param cellSize the length (in meters) of the side of a grid cell
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * Add a PHY to the index. The grid is rebuilt at the next query.
+   *
+   * \param phy the PHY to add
+   */
+  void Add (Ptr<WifiPhy> phy);
+  /**
+   * Move a PHY to the grid of its new channel number.
+   *
+   * \param index the index of the PHY, in the order in which it was added
+   * \param channelNumber the new channel number of the PHY
+   */
+  void SetChannelNumber (std::size_t index, uint8_t channelNumber);
+  /**
+   * Remove all the PHYs from the index and disconnect from their
+   * mobility models.
+   */
+  void Clear (void);
+  /**
+   * \return the smallest reception threshold (in dBm) of the indexed PHYs,
+   *         not accounting for their Rx gain
+   */
+  double GetMinRxPowerThreshold (void);
+  /**
+   * Recompute the smallest reception threshold of the indexed PHYs after
+   * the RxSensitivity or RxGain of one of them changed.
+   */
+  void UpdateMinRxPowerThreshold (void);
+  /**
+   * Get the PHYs operating on the given channel number whose horizontal
+   * distance from the given position may be lower than or equal to the
+   * given range. The returned indexes refer to the order in which the PHYs
+   * were added and are sorted in that order.
+   *
+   * \param channelNumber the channel number of the transmitter
+   * \param position the position of the transmitter
+   * \param range the range (in meters)
+   * \return the indexes of the candidate PHYs
+   */
+  const std::vector<std::size_t> & GetCandidates (uint8_t channelNumber, const Vector &position, double range);
+
+private:
+  /// cell coordinates
+  typedef std::pair<int64_t, int64_t> CellKey;
+  /// map of the non-empty cells to the indexes of the PHYs they contain
+  typedef std::map<CellKey, std::vector<std::size_t> > Cells;
+
+  /// The grid of the PHYs operating on a channel number
+  struct Grid
+  {
+    Cells cells;                     //!< non-empty grid cells
+    std::vector<std::size_t> moving; //!< indexes of the PHYs not stored in the grid cells
+  };
+
+  /// Information about an indexed PHY
+  struct Entry
+  {
+    Ptr<WifiPhy> phy;              //!< the PHY
+    Ptr<MobilityModel> mobility;   //!< the mobility model of the PHY
+    uint8_t channelNumber;         //!< the channel number of the PHY
+    bool static_;                  //!< whether the PHY is stored in a grid cell
+    Vector position;               //!< the position of the PHY when it was stored in a grid cell
+    CellKey cell;                  //!< the grid cell of the PHY
+  };
+
+  /**
+   * Build the grid from scratch
+   */
+  void Build (void);
+  /**
+   * Insert an entry in the grid cells or in the list of moving PHYs of
+   * its channel number
+   * \param index the index of the entry
+   */
+  void Insert (std::size_t index);
+  /**
+   * Remove an entry from the grid cells or from the list of moving PHYs of
+   * its channel number
+   * \param index the index of the entry
+   */
+  void Remove (std::size_t index);
+  /**
+   * Disconnect from the CourseChange trace sources of the mobility models
+   */
+  void Disconnect (void);
+  /**
+   * Callback for the CourseChange trace source of the mobility models
+   * \param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  /**
+   * \param coordinate a coordinate (in meters)
+   * \return the index of the cell containing the coordinate along one axis
+   */
+  int64_t GetCellIndex (double coordinate) const;
+
+  double m_cellSize;                     //!< length of the side of a cell (m)
+  bool m_built;                          //!< whether the grid is up to date with the PHY list
+  std::vector<Entry> m_entries;          //!< indexed PHYs, in insertion order
+  std::map<uint8_t, Grid> m_grids;       //!< grids indexed by channel number
+  double m_minRxPowerThresholdDbm;       //!< smallest reception threshold of the PHYs (dBm)
+  std::map<const MobilityModel *, std::vector<std::size_t> > m_mobilityEntries; //!< entries using each mobility model
+  std::vector<std::size_t> m_candidates; //!< result of the last query
+  std::vector<std::size_t> m_scan;       //!< scratch copy of the moving PHYs scanned by a query
+};
+
+} //namespace ns3
+
+#endif /* WIFI_PHY_SPATIAL_INDEX_H */
@@ -22,6 +22,8 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
 #include "ns3/mobility-model.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/error-model.h"
@@ -244,6 +246,34 @@ WifiPhy::GetTypeId (void)
                    DoubleValue (7),
                    MakeDoubleAccessor (&WifiPhy::SetRxNoiseFigure),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("InterferenceStorage",
+                   "The data structure used to store the changes of the noise and "
+                   "interference power. Both data structures yield the same results; "
+                   "the sorted vector avoids a memory allocation per change.",
+                   EnumValue (InterferenceHelper::NI_CHANGES_SORTED_VECTOR),
+                   MakeEnumAccessor (&WifiPhy::SetInterferenceStorage),
+                   MakeEnumChecker (InterferenceHelper::NI_CHANGES_SORTED_VECTOR, "SortedVector",
+                                    InterferenceHelper::NI_CHANGES_MULTIMAP, "Multimap"))
+    .AddAttribute ("TxDurationCacheSize",
+                   "The maximum number of TX durations of PSDUs that are not part of an A-MPDU "
+                   "being built which are cached by CalculateTxDuration. The cache is flushed "
+                   "when it is full. Zero disables the cache.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&WifiPhy::SetTxDurationCacheSize,
+                                         &WifiPhy::GetTxDurationCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("TxDurationCacheHits",
+                   "The number of TX durations found in the cache.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0), //this value is ignored because there is no setter
+                   MakeUintegerAccessor (&WifiPhy::GetTxDurationCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("TxDurationCacheMisses",
+                   "The number of TX durations computed because they were not in the cache.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0), //this value is ignored because there is no setter
+                   MakeUintegerAccessor (&WifiPhy::GetTxDurationCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
     .AddAttribute ("State",
                    "The state of the PHY layer.",
                    PointerValue (),
@@ -396,6 +426,9 @@ WifiPhy::WifiPhy ()
     m_initialChannelNumber (0),
     m_totalAmpduSize (0),
     m_totalAmpduNumSymbols (0),
+    m_txDurationCacheSize (4096),
+    m_txDurationCacheHits (0),
+    m_txDurationCacheMisses (0),
     m_currentEvent (0),
     m_wifiRadioEnergyModel (0),
     m_timeLastPreambleDetected (Seconds (0))
@@ -543,6 +576,39 @@ WifiPhy::SetRxNoiseFigure (double noiseFigureDb)
   m_interference.SetNumberOfReceiveAntennas (GetNumberOfAntennas ());
 }
 
+void
+WifiPhy::SetInterferenceStorage (InterferenceHelper::NiChangesStorage storage)
+{
+  NS_LOG_FUNCTION (this << storage);
+  m_interference.SetNiChangesStorage (storage);
+}
+
+void
+WifiPhy::SetTxDurationCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_txDurationCacheSize = size;
+  m_txDurationCache.clear ();
+}
+
+uint32_t
+WifiPhy::GetTxDurationCacheSize (void) const
+{
+  return m_txDurationCacheSize;
+}
+
+uint64_t
+WifiPhy::GetTxDurationCacheHits (void) const
+{
+  return m_txDurationCacheHits;
+}
+
+uint64_t
+WifiPhy::GetTxDurationCacheMisses (void) const
+{
+  return m_txDurationCacheMisses;
+}
+
 void
 WifiPhy::SetTxPowerStart (double start)
 {
@@ -2336,11 +2402,67 @@ Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency,
                               MpduType mpdutype, uint8_t incFlag)
 {
+  // the duration of the MPDUs of an A-MPDU being built depends on the previous MPDUs
+  bool cacheable = (m_txDurationCacheSize > 0 && (mpdutype == NORMAL_MPDU || mpdutype == SINGLE_MPDU));
+  TxDurationKey key;
+  if (cacheable)
+    {
+      key.size = size;
+      key.modeUid = txVector.GetMode ().GetUid ();
+      key.channelWidth = txVector.GetChannelWidth ();
+      key.guardInterval = txVector.GetGuardInterval ();
+      key.frequency = frequency;
+      key.nss = txVector.GetNss ();
+      key.ness = txVector.GetNess ();
+      key.preamble = static_cast<uint8_t> (txVector.GetPreambleType ());
+      key.mpduType = static_cast<uint8_t> (mpdutype);
+      key.stbc = txVector.IsStbc ();
+      auto it = m_txDurationCache.find (key);
+      if (it != m_txDurationCache.end ())
+        {
+          m_txDurationCacheHits++;
+          return it->second;
+        }
+      m_txDurationCacheMisses++;
+    }
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
     + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+  if (cacheable)
+    {
+      if (m_txDurationCache.size () >= m_txDurationCacheSize)
+        {
+          m_txDurationCache.clear ();
+        }
+      m_txDurationCache.insert (std::make_pair (key, duration));
+    }
   return duration;
 }
 
+bool
+WifiPhy::TxDurationKey::operator== (const TxDurationKey &other) const
+{
+  return size == other.size && modeUid == other.modeUid && channelWidth == other.channelWidth
+         && guardInterval == other.guardInterval && frequency == other.frequency && nss == other.nss
+         && ness == other.ness && preamble == other.preamble && mpduType == other.mpduType
+         && stbc == other.stbc;
+}
+
+std::size_t
+WifiPhy::TxDurationKeyHash::operator() (const TxDurationKey &key) const
+{
+  uint64_t hash = key.size;
+  hash = hash * 31 + key.modeUid;
+  hash = hash * 31 + key.channelWidth;
+  hash = hash * 31 + key.guardInterval;
+  hash = hash * 31 + key.frequency;
+  hash = hash * 31 + key.nss;
+  hash = hash * 31 + key.ness;
+  hash = hash * 31 + key.preamble;
+  hash = hash * 31 + key.mpduType;
+  hash = hash * 31 + key.stbc;
+  return static_cast<std::size_t> (hash);
+}
+
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency)
 {
@@ -2350,6 +2472,10 @@ WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t fre
 void
 WifiPhy::NotifyTxBegin (Ptr<const Packet> packet, double txPowerW)
 {
+  if (m_phyTxBeginTrace.IsEmpty ())
+    {
+      return;
+    }
   if (IsAmpdu (packet))
     {
       std::list<Ptr<const Packet>> mpdus = MpduAggregator::PeekMpdus (packet);
@@ -2367,6 +2493,10 @@ WifiPhy::NotifyTxBegin (Ptr<const Packet> packet, double txPowerW)
 void
 WifiPhy::NotifyTxEnd (Ptr<const Packet> packet)
 {
+  if (m_phyTxEndTrace.IsEmpty ())
+    {
+      return;
+    }
   if (IsAmpdu (packet))
     {
       std::list<Ptr<const Packet>> mpdus = MpduAggregator::PeekMpdus (packet);
@@ -2384,6 +2514,10 @@ WifiPhy::NotifyTxEnd (Ptr<const Packet> packet)
 void
 WifiPhy::NotifyTxDrop (Ptr<const Packet> packet)
 {
+  if (m_phyTxDropTrace.IsEmpty ())
+    {
+      return;
+    }
   if (IsAmpdu (packet))
     {
       std::list<Ptr<const Packet>> mpdus = MpduAggregator::PeekMpdus (packet);
@@ -2401,6 +2535,10 @@ WifiPhy::NotifyTxDrop (Ptr<const Packet> packet)
 void
 WifiPhy::NotifyRxBegin (Ptr<const Packet> packet)
 {
+  if (m_phyRxBeginTrace.IsEmpty ())
+    {
+      return;
+    }
   if (IsAmpdu (packet))
     {
       std::list<Ptr<const Packet>> mpdus = MpduAggregator::PeekMpdus (packet);
@@ -2418,6 +2556,10 @@ WifiPhy::NotifyRxBegin (Ptr<const Packet> packet)
 void
 WifiPhy::NotifyRxEnd (Ptr<const Packet> packet)
 {
+  if (m_phyRxEndTrace.IsEmpty ())
+    {
+      return;
+    }
   if (IsAmpdu (packet))
     {
       std::list<Ptr<const Packet>> mpdus = MpduAggregator::PeekMpdus (packet);
@@ -2435,6 +2577,10 @@ WifiPhy::NotifyRxEnd (Ptr<const Packet> packet)
 void
 WifiPhy::NotifyRxDrop (Ptr<const Packet> packet, WifiPhyRxfailureReason reason)
 {
+  if (m_phyRxDropTrace.IsEmpty ())
+    {
+      return;
+    }
   if (IsAmpdu (packet))
     {
       std::list<Ptr<const Packet>> mpdus = MpduAggregator::PeekMpdus (packet);
@@ -2454,13 +2600,25 @@ WifiPhy::NotifyMonitorSniffRx (Ptr<const Packet> packet, uint16_t channelFreqMhz
                                SignalNoiseDbm signalNoise, std::vector<bool> statusPerMpdu)
 {
   MpduInfo aMpdu;
+  std::list<Ptr<const Packet>> ampduSubframes;
   if (txVector.IsAggregation ())
     {
       //Expand A-MPDU
       aMpdu.mpduRefNumber = ++m_rxMpduReferenceNumber;
-      std::list<Ptr<const Packet>> ampduSubframes = MpduAggregator::PeekAmpduSubframes (packet);
+      ampduSubframes = MpduAggregator::PeekAmpduSubframes (packet);
+      NS_ABORT_MSG_IF (statusPerMpdu.size () != ampduSubframes.size (), "Should have one reception status per MPDU");
+    }
+  else
+    {
+      NS_ABORT_MSG_IF (statusPerMpdu.size () != 1, "Should have one reception status for normal MPDU");
+    }
+  if (m_phyMonitorSniffRxTrace.IsEmpty ())
+    {
+      return;
+    }
+  if (txVector.IsAggregation ())
+    {
       size_t numberOfMpdus = ampduSubframes.size ();
-      NS_ABORT_MSG_IF (statusPerMpdu.size () != numberOfMpdus, "Should have one reception status per MPDU");
       size_t i = 0;
       aMpdu.type = (numberOfMpdus == 1) ? SINGLE_MPDU: FIRST_MPDU_IN_AGGREGATE;
       for (const auto & subframe : ampduSubframes)
@@ -2476,7 +2634,6 @@ WifiPhy::NotifyMonitorSniffRx (Ptr<const Packet> packet, uint16_t channelFreqMhz
   else
     {
       aMpdu.type = NORMAL_MPDU;
-      NS_ABORT_MSG_IF (statusPerMpdu.size () != 1, "Should have one reception status for normal MPDU");
       m_phyMonitorSniffRxTrace (packet, channelFreqMhz, txVector, aMpdu, signalNoise);
     }
 }
@@ -2484,6 +2641,14 @@ WifiPhy::NotifyMonitorSniffRx (Ptr<const Packet> packet, uint16_t channelFreqMhz
 void
 WifiPhy::NotifyMonitorSniffTx (Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector)
 {
+  if (m_phyMonitorSniffTxTrace.IsEmpty ())
+    {
+      if (txVector.IsAggregation ())
+        {
+          ++m_txMpduReferenceNumber;
+        }
+      return;
+    }
   MpduInfo aMpdu;
   if (txVector.IsAggregation ())
     {
@@ -2742,9 +2907,11 @@ WifiPhy::ContinueReceiveHeader (Ptr<Event> event)
 }
 
 void
-WifiPhy::StartReceivePreamble (Ptr<Packet> packet, double rxPowerW, Time rxDuration)
+WifiPhy::StartReceivePreamble (Ptr<const Packet> ppdu, double rxPowerW, Time rxDuration)
 {
-  NS_LOG_FUNCTION (this << packet << rxPowerW << rxDuration);
+  NS_LOG_FUNCTION (this << ppdu << rxPowerW << rxDuration);
+  //the PPDU is shared by all the receivers, the PHY headers are removed from a private copy
+  Ptr<Packet> packet = ppdu->Copy ();
   WifiPhyTag tag;
   bool found = packet->RemovePacketTag (tag);
   if (!found)
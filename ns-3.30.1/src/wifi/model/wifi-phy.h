@@ -22,6 +22,7 @@
 #ifndef WIFI_PHY_H
 #define WIFI_PHY_H
 
+#include <unordered_map>
 #include "ns3/event-id.h"
 #include "ns3/deprecated.h"
 #include "ns3/error-model.h"
@@ -139,11 +140,12 @@ public:
   /**
    * Start receiving the PHY preamble of a packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param ppdu the arriving packet, including the PHY headers. It may be shared
+   *        with other receivers and is not modified.
    * \param rxPowerW the receive power in W
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePreamble (Ptr<Packet> packet, double rxPowerW, Time rxDuration);
+  void StartReceivePreamble (Ptr<const Packet> ppdu, double rxPowerW, Time rxDuration);
 
   /**
    * Start receiving the PHY header of a packet (i.e. after the end of receiving the preamble).
@@ -1271,7 +1273,7 @@ public:
    *
    * \param threshold the receive sensitivity threshold in dBm
    */
-  void SetRxSensitivity (double threshold);
+  virtual void SetRxSensitivity (double threshold);
   /**
    * Return the receive sensitivity threshold (dBm).
    *
@@ -1298,6 +1300,32 @@ public:
    * \param noiseFigureDb noise figure in dB
    */
   void SetRxNoiseFigure (double noiseFigureDb);
+  /**
+   * Sets the data structure used by the interference helper to store
+   * the changes of the noise and interference power.
+   *
+   * \param storage the data structure used to store the changes
+   */
+  void SetInterferenceStorage (InterferenceHelper::NiChangesStorage storage);
+  /**
+   * Sets the maximum number of TX durations stored in the cache used by
+   * CalculateTxDuration. The cache is flushed. A null size disables the cache.
+   *
+   * \param size the maximum number of cached TX durations
+   */
+  void SetTxDurationCacheSize (uint32_t size);
+  /**
+   * \return the maximum number of cached TX durations
+   */
+  uint32_t GetTxDurationCacheSize (void) const;
+  /**
+   * \return the number of TX durations found in the cache
+   */
+  uint64_t GetTxDurationCacheHits (void) const;
+  /**
+   * \return the number of TX durations computed because they were not in the cache
+   */
+  uint64_t GetTxDurationCacheMisses (void) const;
   /**
    * Sets the minimum available transmission power level (dBm).
    *
@@ -1353,7 +1381,7 @@ public:
    *
    * \param gain the reception gain in dB
    */
-  void SetRxGain (double gain);
+  virtual void SetRxGain (double gain);
   /**
    * Return the reception gain (dB).
    *
@@ -1913,6 +1941,41 @@ private:
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 
+  /// The parameters determining the TX duration of a PSDU that is not part of an A-MPDU being built
+  struct TxDurationKey
+  {
+    uint32_t size;          //!< size of the PSDU (bytes)
+    uint32_t modeUid;       //!< UID of the mode
+    uint16_t channelWidth;  //!< channel width (MHz)
+    uint16_t guardInterval; //!< guard interval (ns)
+    uint16_t frequency;     //!< channel center frequency (MHz)
+    uint8_t nss;            //!< number of spatial streams
+    uint8_t ness;           //!< number of extension spatial streams
+    uint8_t preamble;       //!< preamble type
+    uint8_t mpduType;       //!< MPDU type
+    bool stbc;              //!< whether STBC is used
+
+    /**
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator== (const TxDurationKey &other) const;
+  };
+  /// Hash of the TX duration cache keys
+  struct TxDurationKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator() (const TxDurationKey &key) const;
+  };
+
+  std::unordered_map<TxDurationKey, Time, TxDurationKeyHash> m_txDurationCache; //!< TX durations computed so far
+  uint32_t m_txDurationCacheSize;   //!< maximum number of entries of the TX duration cache
+  uint64_t m_txDurationCacheHits;   //!< number of TX durations found in the cache
+  uint64_t m_txDurationCacheMisses; //!< number of TX durations not found in the cache
+
   Ptr<NetDevice>     m_device;   //!< Pointer to the device
   Ptr<MobilityModel> m_mobility; //!< Pointer to the mobility model
 
@@ -1091,13 +1091,11 @@ WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  StationIndex::iterator it = const_cast<WifiRemoteStationManager *> (this)->m_stationIndex.find (address);
+  if (it != m_stationIndex.end ())
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return it->second.state;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1113,6 +1111,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_aggregation = false;
   state->m_qosSupported = false;
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->m_stationIndex[address].state = state;
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1136,22 +1135,30 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << +tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  StationIndex &index = const_cast<WifiRemoteStationManager *> (this)->m_stationIndex;
+  StationIndex::iterator it = index.find (address);
+  if (it == index.end ())
+    {
+      LookupState (address);
+      it = index.find (address);
+    }
+  // references to the elements of an unordered_map are not invalidated by insertions
+  StationIndexEntry &entry = it->second;
+  for (Stations::const_iterator i = entry.stations.begin (); i != entry.stations.end (); i++)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
+      if ((*i)->m_tid == tid)
         {
           return (*i);
         }
     }
-  WifiRemoteStationState *state = LookupState (address);
 
   WifiRemoteStation *station = DoCreateStation ();
-  station->m_state = state;
+  station->m_state = entry.state;
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  entry.stations.push_back (station);
   return station;
 }
 
@@ -1341,6 +1348,7 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicMcsSet.clear ();
 }
@@ -21,6 +21,7 @@
 #ifndef WIFI_REMOTE_STATION_MANAGER_H
 #define WIFI_REMOTE_STATION_MANAGER_H
 
+#include <unordered_map>
 #include "ns3/traced-callback.h"
 #include "ns3/object.h"
 #include "ns3/data-rate.h"
@@ -1317,6 +1318,16 @@ private:
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
 
+  /// The state and the per-TID stations of a known remote station
+  struct StationIndexEntry
+  {
+    WifiRemoteStationState *state; //!< the state of the station
+    Stations stations;             //!< the stations created for this address, one per TID
+  };
+  /// Known remote stations, indexed by their address
+  typedef std::unordered_map<Mac48Address, StationIndexEntry, Mac48AddressHash> StationIndex;
+  StationIndex m_stationIndex; //!< index of the known stations, to look them up in constant time
+
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
 
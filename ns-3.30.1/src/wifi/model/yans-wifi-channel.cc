@@ -18,17 +18,29 @@
  * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
+#include <cmath>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
+#include "ns3/mobility-position-store.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/remote-channel-lookahead.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
+#include "yans-wifi-remote-header.h"
+#include "wifi-phy-tag.h"
 #include "wifi-utils.h"
 
 namespace ns3 {
@@ -52,11 +64,53 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SpatialIndex",
+                   "If true, the receivers which cannot receive a transmission above their RxSensitivity, "
+                   "according to the range bound of the propagation loss model, are skipped "
+                   "without computing the propagation loss and delay towards them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_spatialIndexEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SpatialIndexCellSize",
+                   "The length (in meters) of the side of the cells of the spatial index.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&YansWifiChannel::SetSpatialIndexCellSize,
+                                       &YansWifiChannel::GetSpatialIndexCellSize),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("PropagationThreads",
+                   "The number of threads computing the propagation loss and delay towards the "
+                   "receivers of a transmission, if the propagation models are thread-safe. "
+                   "With a single thread, the propagation models are evaluated serially.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&YansWifiChannel::SetPropagationThreads,
+                                         &YansWifiChannel::GetPropagationThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RemoteLookahead",
+                   "The smallest propagation delay between the PHYs of two systems of a distributed "
+                   "simulation.  If zero, it is computed from the positions of the PHYs when the "
+                   "simulation starts, which only holds if the PHYs of different systems do not "
+                   "get closer to each other afterwards.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&YansWifiChannel::m_remoteLookahead),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("MinimumDelay",
+                   "The smallest propagation delay between two PHYs, which the multithreaded "
+                   "simulator uses as its lookahead to simulate the PHYs in several logical "
+                   "processes.  If zero, it is computed by the propagation delay model from the "
+                   "positions of the PHYs when the simulation starts, provided none of them moves.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&YansWifiChannel::SetMinimumDelay,
+                                     &YansWifiChannel::GetMinimumDelay),
+                   MakeTimeChecker (Seconds (0)))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_spatialIndexEnabled (false),
+    m_spatialIndexCellSize (100.0),
+    m_distributed (false),
+    m_systemId (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -67,6 +121,71 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_spatialIndex.Clear ();
+  for (std::map<Ptr<MobilityModel>, uint32_t>::const_iterator it = m_remoteMobilities.begin ();
+       it != m_remoteMobilities.end (); it++)
+    {
+      it->first->TraceDisconnectWithoutContext ("CourseChange",
+                                                MakeCallback (&YansWifiChannel::RemoteCourseChanged, this));
+    }
+  m_remoteMobilities.clear ();
+  m_movingMobilities.clear ();
+  Channel::DoDispose ();
+}
+
+void
+YansWifiChannel::SetSpatialIndexCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  m_spatialIndexCellSize = cellSize;
+  m_spatialIndex.SetCellSize (cellSize);
+}
+
+double
+YansWifiChannel::GetSpatialIndexCellSize (void) const
+{
+  return m_spatialIndexCellSize;
+}
+
+void
+YansWifiChannel::SetPropagationThreads (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+  m_evaluator.SetNThreads (nThreads);
+}
+
+uint32_t
+YansWifiChannel::GetPropagationThreads (void) const
+{
+  return m_evaluator.GetNThreads ();
+}
+
+void
+YansWifiChannel::SetMinimumDelay (Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  m_minimumDelay = delay;
+}
+
+Time
+YansWifiChannel::GetMinimumDelay (void) const
+{
+  if (m_minimumDelay.IsStrictlyPositive () || m_delay == 0)
+    {
+      return m_minimumDelay;
+    }
+  std::vector<Ptr<MobilityModel> > mobilities;
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      mobilities.push_back ((*i)->GetMobility ());
+    }
+  return m_delay->GetMinimumDelay (mobilities);
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
 {
@@ -85,44 +204,123 @@ void
 YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const
 {
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
+#ifdef NS3_MTP
+  // the logical processes of the multithreaded simulator share the channel
+  std::lock_guard<std::mutex> lock (m_sendMutex);
+#endif
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  //For now don't account for inter channel interference nor channel bonding
+  uint8_t channelNumber = sender->GetChannelNumber ();
+  if (m_distributed)
     {
-      if (sender != (*i))
+      if (GetSystemId (sender) != m_systemId)
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
+          NS_LOG_LOGIC ("transmission of a PHY of system " << GetSystemId (sender) << " ignored");
+          return;
+        }
+      UpdateSystemsInRange (MobilityPositionStore::Get ()->GetPosition (senderMobility->GetPositionIndex ()), txPowerDbm);
+    }
+  const std::vector<std::size_t> *receivers = 0;
+  if (m_spatialIndexEnabled)
+    {
+      double maxRange = m_loss->GetMaxRange (txPowerDbm, m_spatialIndex.GetMinRxPowerThreshold ());
+      if (!std::isinf (maxRange))
+        {
+          Vector senderPosition = MobilityPositionStore::Get ()->GetPosition (senderMobility->GetPositionIndex ());
+          receivers = &m_spatialIndex.GetCandidates (channelNumber, senderPosition, maxRange);
+          NS_LOG_DEBUG ("range=" << maxRange << "m, " << receivers->size () << " candidate receivers out of " << m_phyList.size ());
+        }
+    }
+  if (receivers == 0)
+    {
+      ChannelPhys::const_iterator it = m_channelPhys.find (channelNumber);
+      if (it == m_channelPhys.end ())
+        {
+          return;
+        }
+      receivers = &it->second;
+    }
+  SendToReceivers (sender, senderMobility, *receivers, packet, txPowerDbm, duration);
+}
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
-            }
+void
+YansWifiChannel::SendToReceivers (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                                  const std::vector<std::size_t> &receivers,
+                                  Ptr<const Packet> packet, double txPowerDbm, Time duration) const
+{
+  m_receiverIds.clear ();
+  m_receiverMobilities.clear ();
+  for (std::vector<std::size_t>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
+    {
+      if (m_phyList[*i] != sender
+          && (!m_distributed || m_systemsInRange[m_phySystemIds[*i]]))
+        {
+          NS_ASSERT (m_phyList[*i]->GetChannelNumber () == sender->GetChannelNumber ());
+          m_receiverIds.push_back (static_cast<uint32_t> (*i));
+          m_receiverMobilities.push_back (m_phyList[*i]->GetMobility ());
+        }
+    }
+  if (m_receiverIds.empty ())
+    {
+      return;
+    }
+  if (m_evaluator.CanEvaluate (m_loss, m_delay))
+    {
+      m_evaluator.Evaluate (m_loss, m_delay, txPowerDbm, senderMobility, m_receiverIds, m_receiverMobilities,
+                            m_rxPowersDbm, m_delays);
+    }
+  else
+    {
+      MobilityPositionStore *store = MobilityPositionStore::Get ();
+      m_receiverPositions.clear ();
+      for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_receiverMobilities.begin (); i != m_receiverMobilities.end (); i++)
+        {
+          m_receiverPositions.push_back (store->GetPosition ((*i)->GetPositionIndex ()));
+        }
+      m_delay->GetDelays (senderMobility, m_receiverMobilities, m_receiverPositions, m_delays);
+      m_loss->CalcRxPowers (txPowerDbm, senderMobility, m_receiverMobilities, m_receiverPositions, m_rxPowersDbm);
+    }
+  for (std::size_t j = 0; j < m_receiverIds.size (); j++)
+    {
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << m_rxPowersDbm[j] << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (m_receiverMobilities[j]) << "m, delay=" << m_delays[j]);
+      ScheduleReceive (m_phyList[m_receiverIds[j]], packet, m_rxPowersDbm[j], m_delays[j], duration);
+    }
+  m_receiverMobilities.clear ();
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration);
+void
+YansWifiChannel::ScheduleReceive (Ptr<YansWifiPhy> receiver, Ptr<const Packet> packet,
+                                  double rxPowerDbm, Time delay, Time duration) const
+{
+  if (m_distributed)
+    {
+      uint32_t systemId = GetSystemId (receiver);
+      if (systemId != m_systemId)
+        {
+          SendRemote (receiver, systemId, packet, rxPowerDbm, delay, duration);
+          return;
         }
     }
+  Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetNode ()->GetId ();
+    }
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive,
+                                  receiver, packet, rxPowerDbm, duration);
 }
 
 void
-YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration)
+YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<const Packet> packet, double rxPowerDbm, Time duration)
 {
   NS_LOG_FUNCTION (phy << packet << rxPowerDbm << duration.GetSeconds ());
   // Do no further processing if signal is too weak
@@ -135,6 +333,222 @@ YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPow
   phy->StartReceivePreamble (packet, DbmToW (rxPowerDbm + phy->GetRxGain ()), duration);
 }
 
+void
+YansWifiChannel::SendRemote (Ptr<YansWifiPhy> receiver, uint32_t systemId, Ptr<const Packet> packet,
+                             double rxPowerDbm, Time delay, Time duration) const
+{
+  // the signals too weak to process are dropped on arrival anyway
+  if ((rxPowerDbm + receiver->GetRxGain ()) < receiver->GetRxSensitivity ())
+    {
+      NS_LOG_LOGIC ("signal too weak to forward to system " << systemId << ": " << rxPowerDbm << " dBm");
+      return;
+    }
+  NS_ABORT_MSG_IF (delay < m_remoteDelays[systemId],
+                   "Propagation delay " << delay << " to system " << systemId <<
+                   " smaller than the lookahead " << m_remoteDelays[systemId] <<
+                   ", set the RemoteLookahead attribute");
+  Ptr<Packet> copy = packet->Copy ();
+  WifiPhyTag tag;
+  NS_ABORT_MSG_UNLESS (copy->PeekPacketTag (tag), "Sent Wi-Fi Signal with no WifiPhyTag");
+  copy->AddHeader (YansWifiRemoteHeader (rxPowerDbm, duration, tag));
+  Ptr<NetDevice> device = receiver->GetDevice ();
+  NS_LOG_DEBUG ("forwarding to node " << device->GetNode ()->GetId () << " of system " << systemId);
+  MpiInterface::SendPacket (copy, Simulator::Now () + delay, device->GetNode ()->GetId (), device->GetIfIndex ());
+}
+
+void
+YansWifiChannel::ReceiveRemote (Ptr<YansWifiPhy> phy, Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (phy << packet);
+  YansWifiRemoteHeader header;
+  packet->RemoveHeader (header);
+  packet->AddPacketTag (header.GetPhyTag ());
+  Receive (phy, packet, header.GetRxPowerDbm (), header.GetDuration ());
+}
+
+uint32_t
+YansWifiChannel::GetSystemId (Ptr<YansWifiPhy> phy)
+{
+  Ptr<NetDevice> device = phy->GetDevice ();
+  if (device == 0)
+    {
+      return 0;
+    }
+  return device->GetNode ()->GetSystemId ();
+}
+
+void
+YansWifiChannel::SetUpRemote (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_distributed)
+    {
+      return;
+    }
+  m_distributed = true;
+  m_systemId = MpiInterface::GetSystemId ();
+  uint32_t nSystems = MpiInterface::GetSize ();
+  m_remoteDelays.assign (nSystems, Seconds (-1));
+  m_movingMobilities.assign (nSystems, std::set<Ptr<MobilityModel> > ());
+  m_systemBounds.assign (nSystems, Box ());
+  m_systemBoundsDirty.assign (nSystems, true);
+  m_systemsInRange.assign (nSystems, true);
+  m_phySystemIds.clear ();
+  std::vector<std::size_t> localPhys;
+  for (std::size_t i = 0; i < m_phyList.size (); i++)
+    {
+      uint32_t systemId = GetSystemId (m_phyList[i]);
+      NS_ABORT_MSG_UNLESS (systemId < nSystems, "Node of system " << systemId << " out of " << nSystems << " systems");
+      m_phySystemIds.push_back (systemId);
+      if (systemId == m_systemId)
+        {
+          localPhys.push_back (i);
+          Ptr<NetDevice> device = m_phyList[i]->GetDevice ();
+          if (device != 0 && device->GetObject<MpiReceiver> () == 0)
+            {
+              Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+              receiver->SetReceiveCallback (MakeBoundCallback (&YansWifiChannel::ReceiveRemote, m_phyList[i]));
+              device->AggregateObject (receiver);
+            }
+          continue;
+        }
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ();
+      if (m_remoteMobilities.insert (std::make_pair (mobility, systemId)).second)
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&YansWifiChannel::RemoteCourseChanged, this));
+          Vector velocity = mobility->GetVelocity ();
+          if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+            {
+              m_movingMobilities[systemId].insert (mobility);
+            }
+        }
+      if (m_remoteLookahead.IsStrictlyPositive ())
+        {
+          m_remoteDelays[systemId] = m_remoteLookahead;
+        }
+    }
+  if (m_remoteLookahead.IsStrictlyPositive () || localPhys.empty ())
+    {
+      return;
+    }
+  for (std::size_t j = 0; j < m_phyList.size (); j++)
+    {
+      uint32_t systemId = m_phySystemIds[j];
+      if (systemId == m_systemId)
+        {
+          continue;
+        }
+      Ptr<MobilityModel> remoteMobility = m_phyList[j]->GetMobility ();
+      for (std::vector<std::size_t>::const_iterator i = localPhys.begin (); i != localPhys.end (); i++)
+        {
+          Time delay = m_delay->GetDelay (m_phyList[*i]->GetMobility (), remoteMobility);
+          if (m_remoteDelays[systemId].IsStrictlyNegative () || delay < m_remoteDelays[systemId])
+            {
+              m_remoteDelays[systemId] = delay;
+            }
+        }
+      NS_ABORT_MSG_IF (m_remoteDelays[systemId].IsZero (),
+                       "No propagation delay between the PHYs of systems " << m_systemId << " and " << systemId <<
+                       ", set the RemoteLookahead attribute");
+    }
+}
+
+Time
+YansWifiChannel::GetRemoteDelay (uint32_t systemId)
+{
+  NS_LOG_FUNCTION (this << systemId);
+  SetUpRemote ();
+  return m_remoteDelays[systemId];
+}
+
+void
+YansWifiChannel::UpdateSystemsInRange (const Vector &position, double txPowerDbm) const
+{
+  double maxRange = m_loss->GetMaxRange (txPowerDbm, m_spatialIndex.GetMinRxPowerThreshold ());
+  bool update = false;
+  for (uint32_t systemId = 0; systemId < m_systemsInRange.size (); systemId++)
+    {
+      // the positions of the moving PHYs are only valid at the current time
+      if (!m_movingMobilities[systemId].empty ())
+        {
+          m_systemBoundsDirty[systemId] = true;
+        }
+      update = update || (m_systemBoundsDirty[systemId] && systemId != m_systemId);
+    }
+  if (update && !std::isinf (maxRange))
+    {
+      // querying the position of a moving PHY may trigger a course change,
+      // which marks the bounding box of its system dirty again
+      std::vector<bool> dirty = m_systemBoundsDirty;
+      std::vector<bool> empty = m_systemBoundsDirty;
+      m_systemBoundsDirty.assign (m_systemBoundsDirty.size (), false);
+      for (std::size_t i = 0; i < m_phyList.size (); i++)
+        {
+          uint32_t systemId = m_phySystemIds[i];
+          if (systemId == m_systemId || !dirty[systemId])
+            {
+              continue;
+            }
+          Vector p = MobilityPositionStore::Get ()->GetPosition (m_phyList[i]->GetMobility ()->GetPositionIndex ());
+          Box &bounds = m_systemBounds[systemId];
+          if (empty[systemId])
+            {
+              bounds = Box (p.x, p.x, p.y, p.y, p.z, p.z);
+              empty[systemId] = false;
+              continue;
+            }
+          bounds.xMin = std::min (bounds.xMin, p.x);
+          bounds.xMax = std::max (bounds.xMax, p.x);
+          bounds.yMin = std::min (bounds.yMin, p.y);
+          bounds.yMax = std::max (bounds.yMax, p.y);
+          bounds.zMin = std::min (bounds.zMin, p.z);
+          bounds.zMax = std::max (bounds.zMax, p.z);
+        }
+    }
+  for (uint32_t systemId = 0; systemId < m_systemsInRange.size (); systemId++)
+    {
+      if (systemId == m_systemId || std::isinf (maxRange))
+        {
+          m_systemsInRange[systemId] = true;
+          continue;
+        }
+      if (m_remoteDelays[systemId].IsStrictlyNegative ())
+        {
+          // no PHY on that system
+          m_systemsInRange[systemId] = false;
+          continue;
+        }
+      const Box &bounds = m_systemBounds[systemId];
+      double dx = std::max (0.0, std::max (bounds.xMin - position.x, position.x - bounds.xMax));
+      double dy = std::max (0.0, std::max (bounds.yMin - position.y, position.y - bounds.yMax));
+      double dz = std::max (0.0, std::max (bounds.zMin - position.z, position.z - bounds.zMax));
+      m_systemsInRange[systemId] = std::sqrt (dx * dx + dy * dy + dz * dz) <= maxRange;
+      NS_LOG_LOGIC ("system " << systemId << (m_systemsInRange[systemId] ? " in range" : " out of range"));
+    }
+}
+
+void
+YansWifiChannel::RemoteCourseChanged (Ptr<const MobilityModel> mobility)
+{
+  Ptr<MobilityModel> model = ConstCast<MobilityModel> (mobility);
+  std::map<Ptr<MobilityModel>, uint32_t>::const_iterator it = m_remoteMobilities.find (model);
+  if (it == m_remoteMobilities.end ())
+    {
+      return;
+    }
+  Vector velocity = mobility->GetVelocity ();
+  if (velocity.x == 0 && velocity.y == 0 && velocity.z == 0)
+    {
+      m_movingMobilities[it->second].erase (model);
+    }
+  else
+    {
+      m_movingMobilities[it->second].insert (model);
+    }
+  m_systemBoundsDirty[it->second] = true;
+}
+
 std::size_t
 YansWifiChannel::GetNDevices (void) const
 {
@@ -151,7 +565,55 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
+  NS_ABORT_MSG_IF (m_distributed, "Cannot add a PHY once the distributed simulation started");
+  if (MpiInterface::IsEnabled () && GetObject<RemoteChannelLookahead> () == 0)
+    {
+      Ptr<RemoteChannelLookahead> lookahead = CreateObject<RemoteChannelLookahead> ();
+      lookahead->SetMinimumDelayCallback (MakeCallback (&YansWifiChannel::GetRemoteDelay, this));
+      AggregateObject (lookahead);
+    }
+  uint8_t channelNumber = phy->GetChannelNumber ();
+  m_channelPhys[channelNumber].push_back (m_phyList.size ());
+  m_phyChannelNumbers.push_back (channelNumber);
   m_phyList.push_back (phy);
+  m_spatialIndex.Add (phy);
+}
+
+void
+YansWifiChannel::NotifyChannelSwitch (Ptr<YansWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  PhyList::const_iterator it = std::find (m_phyList.begin (), m_phyList.end (), phy);
+  if (it == m_phyList.end ())
+    {
+      return;
+    }
+  std::size_t index = it - m_phyList.begin ();
+  uint8_t channelNumber = phy->GetChannelNumber ();
+  if (m_phyChannelNumbers[index] == channelNumber)
+    {
+      return;
+    }
+  NS_LOG_DEBUG ("moving PHY " << index << " from channel " << +m_phyChannelNumbers[index] << " to channel " << +channelNumber);
+  ChannelPhys::iterator oldPhys = m_channelPhys.find (m_phyChannelNumbers[index]);
+  NS_ASSERT (oldPhys != m_channelPhys.end ());
+  oldPhys->second.erase (std::find (oldPhys->second.begin (), oldPhys->second.end (), index));
+  if (oldPhys->second.empty ())
+    {
+      m_channelPhys.erase (oldPhys);
+    }
+  // keep the PHYs of every channel number in the order they were added
+  std::vector<std::size_t> &newPhys = m_channelPhys[channelNumber];
+  newPhys.insert (std::lower_bound (newPhys.begin (), newPhys.end (), index), index);
+  m_phyChannelNumbers[index] = channelNumber;
+  m_spatialIndex.SetChannelNumber (index, channelNumber);
+}
+
+void
+YansWifiChannel::NotifyRxThresholdChange (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_spatialIndex.UpdateMinRxPowerThreshold ();
 }
 
 int64_t
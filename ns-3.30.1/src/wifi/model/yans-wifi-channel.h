@@ -21,7 +21,16 @@
 #ifndef YANS_WIFI_CHANNEL_H
 #define YANS_WIFI_CHANNEL_H
 
+#include <map>
+#include <set>
+#ifdef NS3_MTP
+#include <mutex>
+#endif
 #include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "ns3/box.h"
+#include "ns3/parallel-propagation-evaluator.h"
+#include "wifi-phy-spatial-index.h"
 
 namespace ns3 {
 
@@ -29,6 +38,7 @@ class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
+class MobilityModel;
 class Packet;
 class Time;
 
@@ -40,6 +50,47 @@ class Time;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * If the SpatialIndex attribute is enabled, the channel keeps the attached
+ * PHYs in a grid of their positions (see ns3::WifiPhySpatialIndex) and, for
+ * every transmission, asks the propagation loss model for the range beyond
+ * which no attached PHY can receive the signal above its RxSensitivity.
+ * PHYs located beyond that range are not evaluated at all: no loss or delay
+ * is computed for them, no copy of the packet is made and no reception
+ * event is scheduled.  Since the signals below RxSensitivity are discarded
+ * on arrival, this does not change the outcome of the simulation, as long
+ * as the delay model does not draw random variables.
+ *
+ * If the PropagationThreads attribute is higher than one and the propagation
+ * models are thread-safe (see PropagationLossModel::IsThreadSafe), the
+ * propagation loss and delay towards the receivers of a transmission are
+ * computed by several threads (see ns3::ParallelPropagationEvaluator), and
+ * the receptions are then scheduled in the same order as in the serial case.
+ * The receivers are identified by their index in the PHY list, so that the
+ * random variables drawn for them do not depend on the number of threads.
+ *
+ * In a distributed simulation (see ns3::MpiInterface), every system
+ * creates all the nodes and the channel spans the systems: each system
+ * only transmits for its own nodes, and forwards the transmissions to the
+ * receivers of the other systems, with their rx power and propagation
+ * delay, through MpiInterface::SendPacket.  The receivers whose rx power is
+ * below their RxSensitivity are not forwarded the packet, and the systems
+ * whose nodes all lie, according to the bounding box of their positions,
+ * beyond the range bound of the propagation loss model are skipped without
+ * evaluating the propagation models.  The channel aggregates a
+ * ns3::RemoteChannelLookahead, through which the distributed simulators
+ * take their lookahead from the smallest propagation delay between the
+ * nodes of two systems when the simulation starts, unless the
+ * RemoteLookahead attribute sets it.  The propagation delay model must
+ * then be deterministic and symmetric, and the delay of a forwarded
+ * transmission cannot be smaller than the lookahead, which is checked.
+ * Since the packets are serialized, their tags, but the WifiPhyTag, are
+ * not forwarded.
+ *
+ * The multithreaded simulator (see ns3::MultithreadedSimulatorImpl) may
+ * simulate the PHYs of the channel in several logical processes, with the
+ * MinimumDelay attribute as its lookahead.  The transmissions are then
+ * serialized by a mutex, and the propagation models must be deterministic.
  */
 class YansWifiChannel : public Channel
 {
@@ -64,6 +115,28 @@ public:
    */
   void Add (Ptr<YansWifiPhy> phy);
 
+  /**
+   * Moves the given YansWifiPhy to the group of receivers of its current
+   * channel number.
+   *
+   * \param phy the YansWifiPhy whose channel number may have changed
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from YansWifiPhy::SetChannelNumber and
+   * YansWifiPhy::SetFrequency.
+   */
+  void NotifyChannelSwitch (Ptr<YansWifiPhy> phy);
+
+  /**
+   * Updates the range of the transmissions after the RxSensitivity or
+   * RxGain of an attached YansWifiPhy changed.
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from YansWifiPhy::SetRxSensitivity and
+   * YansWifiPhy::SetRxGain.
+   */
+  void NotifyRxThresholdChange (void);
+
   /**
    * \param loss the new propagation loss model.
    */
@@ -82,7 +155,7 @@ public:
    * This method should not be invoked by normal users. It is
    * currently invoked only from YansWifiPhy::StartTx.  The channel
    * attempts to deliver the packet to all other YansWifiPhy objects
-   * on the channel (except for the sender).
+   * operating on the same channel number as the sender.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
 
@@ -98,11 +171,20 @@ public:
   int64_t AssignStreams (int64_t stream);
 
 
+protected:
+  virtual void DoDispose (void);
+
+
 private:
   /**
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /**
+   * A map of channel numbers to the (sorted) indexes in the PHY list of
+   * the YansWifiPhys operating on each channel number.
+   */
+  typedef std::map<uint8_t, std::vector<std::size_t> > ChannelPhys;
 
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
@@ -110,15 +192,151 @@ private:
    * bit of the packet has arrived.
    *
    * \param receiver the device to which the packet is destined
+   * \param packet the packet being sent, shared by all the receivers
+   * \param txPowerDbm the tx power associated to the packet being sent (dBm)
+   * \param duration the transmission duration associated with the packet being sent
+   */
+  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<const Packet> packet, double txPowerDbm, Time duration);
+
+  /**
+   * Compute the propagation loss and delay from the sender to the given
+   * receivers and schedule the reception of the packet by each of them.
+   * The propagation models are evaluated with several threads when
+   * possible, or else through their batch methods in a single call.  The
+   * packet is not copied: the receivers only make a private copy if they
+   * synchronize on it.
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param receivers the indexes of the receiving phy objects in the PHY list
    * \param packet the packet being sent
    * \param txPowerDbm the tx power associated to the packet being sent (dBm)
    * \param duration the transmission duration associated with the packet being sent
    */
-  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration);
+  void SendToReceivers (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                        const std::vector<std::size_t> &receivers,
+                        Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
+  /**
+   * Forward the packet to the given receiver, simulated by another system.
+   *
+   * \param receiver the receiving phy object
+   * \param systemId the system simulating the receiver
+   * \param packet the packet being sent
+   * \param rxPowerDbm the rx power of the packet at the receiver (dBm)
+   * \param delay the propagation delay to the receiver
+   * \param duration the transmission duration associated with the packet being sent
+   */
+  void SendRemote (Ptr<YansWifiPhy> receiver, uint32_t systemId, Ptr<const Packet> packet,
+                   double rxPowerDbm, Time delay, Time duration) const;
+  /**
+   * This method is invoked by the ns3::MpiReceiver of the local devices
+   * for the packets forwarded by the other systems.
+   *
+   * \param phy the receiving phy object
+   * \param packet the packet, with its ns3::YansWifiRemoteHeader
+   */
+  static void ReceiveRemote (Ptr<YansWifiPhy> phy, Ptr<Packet> packet);
+  /**
+   * Set up the distributed simulation: record the system of every PHY,
+   * compute the smallest propagation delay to every system and hook up
+   * the local devices to their ns3::MpiReceiver.  This is done once, when
+   * the distributed simulator first asks for the lookahead.
+   */
+  void SetUpRemote (void);
+  /**
+   * \param systemId a remote system id
+   * \return the smallest propagation delay from a local PHY to a PHY of
+   *         the remote system, or a negative time if there is none
+   */
+  Time GetRemoteDelay (uint32_t systemId);
+  /**
+   * Find the remote systems some PHYs of which may receive a transmission
+   * above their RxSensitivity.
+   *
+   * \param position the position of the sender
+   * \param txPowerDbm the tx power associated to the packet being sent (dBm)
+   */
+  void UpdateSystemsInRange (const Vector &position, double txPowerDbm) const;
+  /**
+   * Callback for the CourseChange trace source of the mobility models of
+   * the remote PHYs.
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void RemoteCourseChanged (Ptr<const MobilityModel> mobility);
+  /**
+   * \param phy a phy object
+   * \return the system simulating the node of the phy object
+   */
+  static uint32_t GetSystemId (Ptr<YansWifiPhy> phy);
+  /**
+   * Schedule the reception of the packet by the given receiver.
+   *
+   * \param receiver the receiving phy object
+   * \param packet the packet being sent
+   * \param rxPowerDbm the rx power of the packet at the receiver (dBm)
+   * \param delay the propagation delay to the receiver
+   * \param duration the transmission duration associated with the packet being sent
+   */
+  void ScheduleReceive (Ptr<YansWifiPhy> receiver, Ptr<const Packet> packet,
+                        double rxPowerDbm, Time delay, Time duration) const;
+  /**
+   * \param delay the lower bound of the propagation delay between two PHYs
+   */
+  void SetMinimumDelay (Time delay);
+  /**
+   * \return the MinimumDelay attribute if positive, or else the lower bound
+   *         of the propagation delay between two PHYs computed by the
+   *         propagation delay model, which is zero if some PHYs move
+   */
+  Time GetMinimumDelay (void) const;
+  /**
+   * \param nThreads the number of threads computing the propagation loss and delay
+   */
+  void SetPropagationThreads (uint32_t nThreads);
+  /**
+   * \return the number of threads computing the propagation loss and delay
+   */
+  uint32_t GetPropagationThreads (void) const;
+  /**
+   * \param cellSize the length (in meters) of the side of the spatial index cells
+   */
+  void SetSpatialIndexCellSize (double cellSize);
+  /**
+   * \return the length (in meters) of the side of the spatial index cells
+   */
+  double GetSpatialIndexCellSize (void) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
+  std::vector<uint8_t> m_phyChannelNumbers; //!< Channel number of each YansWifiPhy in the PHY list
+  ChannelPhys m_channelPhys;           //!< YansWifiPhys grouped by channel number
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  bool m_spatialIndexEnabled;          //!< Whether receivers out of range are culled through the spatial index
+  double m_spatialIndexCellSize;       //!< Length of the side of the spatial index cells (m)
+  Time m_minimumDelay;                 //!< The MinimumDelay attribute
+  mutable WifiPhySpatialIndex m_spatialIndex; //!< Grid of the positions of the YansWifiPhys
+  mutable ParallelPropagationEvaluator m_evaluator; //!< Parallel evaluation of the propagation models
+  // scratch buffers of SendToReceivers
+  mutable std::vector<uint32_t> m_receiverIds;                   //!< Indexes of the receivers
+  mutable std::vector<Ptr<MobilityModel> > m_receiverMobilities; //!< Mobility models of the receivers
+  mutable std::vector<Vector> m_receiverPositions;               //!< Positions of the receivers
+  mutable std::vector<double> m_rxPowersDbm;                     //!< Rx powers at the receivers (dBm)
+  mutable std::vector<Time> m_delays;                            //!< Propagation delays to the receivers
+  // distributed simulation
+  bool m_distributed;                  //!< Whether the PHYs are simulated by several systems
+  uint32_t m_systemId;                 //!< The local system id
+  Time m_remoteLookahead;              //!< The RemoteLookahead attribute
+  std::vector<uint32_t> m_phySystemIds;  //!< System simulating each YansWifiPhy in the PHY list
+  std::vector<Time> m_remoteDelays;      //!< Smallest propagation delay to each system
+  std::map<Ptr<MobilityModel>, uint32_t> m_remoteMobilities;  //!< System of the mobility models of the remote PHYs
+  std::vector<std::set<Ptr<MobilityModel> > > m_movingMobilities; //!< Remote mobility models with a non null velocity, by system
+  mutable std::vector<Box> m_systemBounds;        //!< Bounding box of the PHYs of each system
+  mutable std::vector<bool> m_systemBoundsDirty;  //!< Whether the bounding box of each system must be updated
+  mutable std::vector<bool> m_systemsInRange;     //!< Whether each system is in range of the current transmission
+#ifdef NS3_MTP
+  mutable std::mutex m_sendMutex;      //!< Serializes the transmissions of the logical processes
+#endif
 };
 
 } //namespace ns3
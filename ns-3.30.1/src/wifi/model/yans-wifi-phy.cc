@@ -74,6 +74,50 @@ YansWifiPhy::SetChannel (const Ptr<YansWifiChannel> channel)
   m_channel->Add (this);
 }
 
+void
+YansWifiPhy::SetChannelNumber (uint8_t nch)
+{
+  NS_LOG_FUNCTION (this << +nch);
+  WifiPhy::SetChannelNumber (nch);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyChannelSwitch (this);
+    }
+}
+
+void
+YansWifiPhy::SetFrequency (uint16_t freq)
+{
+  NS_LOG_FUNCTION (this << freq);
+  WifiPhy::SetFrequency (freq);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyChannelSwitch (this);
+    }
+}
+
+void
+YansWifiPhy::SetRxSensitivity (double threshold)
+{
+  NS_LOG_FUNCTION (this << threshold);
+  WifiPhy::SetRxSensitivity (threshold);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyRxThresholdChange ();
+    }
+}
+
+void
+YansWifiPhy::SetRxGain (double gain)
+{
+  NS_LOG_FUNCTION (this << gain);
+  WifiPhy::SetRxGain (gain);
+  if (m_channel != 0)
+    {
+      m_channel->NotifyRxThresholdChange ();
+    }
+}
+
 void
 YansWifiPhy::StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDuration)
 {
@@ -74,6 +74,19 @@ public:
 
   virtual Ptr<Channel> GetChannel (void) const;
 
+  // The following two methods call to the base WifiPhy class method
+  // but also notify the YansWifiChannel of the new channel number
+
+  virtual void SetChannelNumber (uint8_t id);
+
+  virtual void SetFrequency (uint16_t freq);
+
+  // The following two methods call to the base WifiPhy class method
+  // but also notify the YansWifiChannel of the new reception threshold
+
+  virtual void SetRxSensitivity (double threshold);
+
+  virtual void SetRxGain (double gain);
 
 protected:
   // Inherited
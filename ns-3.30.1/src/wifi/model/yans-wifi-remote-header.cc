@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "yans-wifi-remote-header.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (YansWifiRemoteHeader);
+
+YansWifiRemoteHeader::YansWifiRemoteHeader ()
+  : m_rxPowerDbm (0),
+    m_preamble (WIFI_PREAMBLE_LONG),
+    m_modulation (WIFI_MOD_CLASS_UNKNOWN),
+    m_frameComplete (1)
+{
+}
+
+YansWifiRemoteHeader::YansWifiRemoteHeader (double rxPowerDbm, Time duration, const WifiPhyTag &tag)
+  : m_rxPowerDbm (rxPowerDbm),
+    m_duration (duration),
+    m_preamble (tag.GetPreambleType ()),
+    m_modulation (tag.GetModulation ()),
+    m_frameComplete (tag.GetFrameComplete ())
+{
+}
+
+YansWifiRemoteHeader::~YansWifiRemoteHeader ()
+{
+}
+
+TypeId
+YansWifiRemoteHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::YansWifiRemoteHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<YansWifiRemoteHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+YansWifiRemoteHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+YansWifiRemoteHeader::Print (std::ostream &os) const
+{
+  os << "rxPower=" << m_rxPowerDbm << "dBm"
+     << " duration=" << m_duration
+     << " preamble=" << m_preamble
+     << " modulation=" << m_modulation
+     << " frameComplete=" << +m_frameComplete;
+}
+
+uint32_t
+YansWifiRemoteHeader::GetSerializedSize (void) const
+{
+  return 8 + 8 + 3;
+}
+
+void
+YansWifiRemoteHeader::Serialize (Buffer::Iterator start) const
+{
+  uint64_t rxPower;
+  std::memcpy (&rxPower, &m_rxPowerDbm, sizeof (rxPower));
+  start.WriteHtonU64 (rxPower);
+  start.WriteHtonU64 (static_cast<uint64_t> (m_duration.GetTimeStep ()));
+  start.WriteU8 (static_cast<uint8_t> (m_preamble));
+  start.WriteU8 (static_cast<uint8_t> (m_modulation));
+  start.WriteU8 (m_frameComplete);
+}
+
+uint32_t
+YansWifiRemoteHeader::Deserialize (Buffer::Iterator start)
+{
+  uint64_t rxPower = start.ReadNtohU64 ();
+  std::memcpy (&m_rxPowerDbm, &rxPower, sizeof (rxPower));
+  m_duration = TimeStep (start.ReadNtohU64 ());
+  m_preamble = static_cast<WifiPreamble> (start.ReadU8 ());
+  m_modulation = static_cast<WifiModulationClass> (start.ReadU8 ());
+  m_frameComplete = start.ReadU8 ();
+  return GetSerializedSize ();
+}
+
+double
+YansWifiRemoteHeader::GetRxPowerDbm (void) const
+{
+  return m_rxPowerDbm;
+}
+
+Time
+YansWifiRemoteHeader::GetDuration (void) const
+{
+  return m_duration;
+}
+
+WifiPhyTag
+YansWifiRemoteHeader::GetPhyTag (void) const
+{
+  return WifiPhyTag (m_preamble, m_modulation, m_frameComplete);
+}
+
+} //namespace ns3
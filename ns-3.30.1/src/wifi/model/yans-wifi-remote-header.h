@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef YANS_WIFI_REMOTE_HEADER_H
+#define YANS_WIFI_REMOTE_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+#include "wifi-phy-tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * Header added by ns3::YansWifiChannel to the packets it forwards to the
+ * receivers simulated by another MPI system.  The packets are serialized
+ * without their tags, hence the header carries the content of the
+ * ns3::WifiPhyTag along with the rx power and the duration of the
+ * transmission.
+ */
+class YansWifiRemoteHeader : public Header
+{
+public:
+  YansWifiRemoteHeader ();
+  /**
+   * Constructor
+   *
+   * \param rxPowerDbm the rx power at the receiver, before the rx gain (dBm)
+   * \param duration the transmission duration
+   * \param tag the WifiPhyTag of the transmitted packet
+   */
+  YansWifiRemoteHeader (double rxPowerDbm, Time duration, const WifiPhyTag &tag);
+  virtual ~YansWifiRemoteHeader ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TypeId GetInstanceTypeId (void) const;
+  void Print (std::ostream &os) const;
+  uint32_t GetSerializedSize (void) const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \return the rx power at the receiver, before the rx gain (dBm)
+   */
+  double GetRxPowerDbm (void) const;
+  /**
+   * \return the transmission duration
+   */
+  Time GetDuration (void) const;
+  /**
+   * \return the WifiPhyTag of the transmitted packet
+   */
+  WifiPhyTag GetPhyTag (void) const;
+
+
+private:
+  double m_rxPowerDbm;              ///< rx power before the rx gain (dBm)
+  Time m_duration;                  ///< transmission duration
+  WifiPreamble m_preamble;          ///< preamble type
+  WifiModulationClass m_modulation; ///< modulation used for transmission
+  uint8_t m_frameComplete;          ///< whether the frame is complete
+};
+
+} //namespace ns3
+
+#endif /* YANS_WIFI_REMOTE_HEADER_H */
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -426,6 +427,105 @@ TxDurationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ax duration failed");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Tx Duration Cache Test
+ *
+ * Compare the TX durations returned by a PHY caching them with the ones
+ * returned by a PHY without cache, for single MPDUs and A-MPDUs.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+  virtual ~TxDurationCacheTest ();
+  virtual void DoRun (void);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Wifi TX duration cache")
+{
+}
+
+TxDurationCacheTest::~TxDurationCacheTest ()
+{
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> cached = CreateObject<YansWifiPhy> ();
+  // a small cache, to make sure that it gets flushed
+  cached->SetAttribute ("TxDurationCacheSize", UintegerValue (64));
+  Ptr<YansWifiPhy> uncached = CreateObject<YansWifiPhy> ();
+  uncached->SetAttribute ("TxDurationCacheSize", UintegerValue (0));
+
+  struct
+  {
+    WifiMode mode;
+    uint16_t channelWidth;
+    uint16_t guardInterval;
+    WifiPreamble preamble;
+  } configs[] = {{WifiPhy::GetDsssRate11Mbps (), 22, 800, WIFI_PREAMBLE_LONG},
+                 {WifiPhy::GetOfdmRate54Mbps (), 20, 800, WIFI_PREAMBLE_LONG},
+                 {WifiPhy::GetHtMcs7 (), 40, 400, WIFI_PREAMBLE_HT_MF},
+                 {WifiPhy::GetVhtMcs9 (), 80, 800, WIFI_PREAMBLE_VHT_SU},
+                 {WifiPhy::GetHeMcs11 (), 160, 3200, WIFI_PREAMBLE_HE_SU},
+                 {WifiPhy::GetHeMcs0 (), 20, 800, WIFI_PREAMBLE_HE_SU}};
+  uint16_t frequencies[] = {CHANNEL_1_MHZ, CHANNEL_36_MHZ};
+
+  uint64_t nCalls = 0;
+  for (const auto &config : configs)
+    {
+      WifiTxVector txVector (config.mode, 0, config.preamble, config.guardInterval, 1, 1, 0,
+                             config.channelWidth, false, false);
+      for (uint16_t frequency : frequencies)
+        {
+          for (uint32_t size = 14; size < 65535; size += 997)
+            {
+              for (MpduType mpduType : {NORMAL_MPDU, SINGLE_MPDU})
+                {
+                  Time expected = uncached->CalculateTxDuration (size, txVector, frequency, mpduType, 0);
+                  // the second call is served by the cache
+                  for (uint8_t i = 0; i < 2; i++)
+                    {
+                      NS_TEST_EXPECT_MSG_EQ (cached->CalculateTxDuration (size, txVector, frequency, mpduType, 0),
+                                             expected, "Wrong cached duration for " << config.mode << " and size " << size);
+                      nCalls++;
+                    }
+                }
+              if (config.mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS
+                  || config.mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS)
+                {
+                  continue;
+                }
+              // A-MPDU durations depend on the previous MPDUs and are not cached
+              for (MpduType mpduType : {FIRST_MPDU_IN_AGGREGATE, MIDDLE_MPDU_IN_AGGREGATE, LAST_MPDU_IN_AGGREGATE})
+                {
+                  NS_TEST_EXPECT_MSG_EQ (cached->CalculateTxDuration (size, txVector, frequency, mpduType, 1),
+                                         uncached->CalculateTxDuration (size, txVector, frequency, mpduType, 1),
+                                         "Wrong A-MPDU duration for " << config.mode << " and size " << size);
+                }
+            }
+        }
+    }
+
+  UintegerValue hits;
+  UintegerValue misses;
+  cached->GetAttribute ("TxDurationCacheHits", hits);
+  cached->GetAttribute ("TxDurationCacheMisses", misses);
+  NS_TEST_EXPECT_MSG_EQ (hits.Get () + misses.Get (), nCalls, "Wrong number of cache lookups");
+  NS_TEST_EXPECT_MSG_EQ (hits.Get (), nCalls / 2, "Wrong number of cache hits");
+  NS_TEST_EXPECT_MSG_GT (misses.Get (), 64, "The cache should have been flushed");
+  uncached->GetAttribute ("TxDurationCacheMisses", misses);
+  NS_TEST_EXPECT_MSG_EQ (misses.Get (), 0, "The cache should be disabled");
+
+  cached->Dispose ();
+  uncached->Dispose ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -442,6 +542,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite; ///< the test suite
@@ -22,7 +22,12 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/cached-error-rate-model.h"
+#include "ns3/wifi-phy.h"
 #include "ns3/wifi-tx-vector.h"
+#include "ns3/pointer.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -291,6 +296,102 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Cached
+ *
+ * Compare the chunk success rates interpolated by CachedErrorRateModel
+ * with the ones of the decorated NistErrorRateModel and YansErrorRateModel.
+ */
+class WifiErrorRateModelsTestCaseCached : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseCached ();
+  virtual ~WifiErrorRateModelsTestCaseCached ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseCached::WifiErrorRateModelsTestCaseCached ()
+  : TestCase ("WifiErrorRateModel test case cached")
+{
+}
+
+WifiErrorRateModelsTestCaseCached::~WifiErrorRateModelsTestCaseCached ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseCached::DoRun (void)
+{
+  double tolerance = 1e-3;
+  Ptr<ErrorRateModel> models[] = {CreateObject<NistErrorRateModel> (), CreateObject<YansErrorRateModel> ()};
+  WifiMode modes[] = {WifiPhy::GetDsssRate1Mbps (), WifiPhy::GetDsssRate11Mbps (),
+                      WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate24Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                      WifiPhy::GetHtMcs7 (), WifiPhy::GetVhtMcs8 (),
+                      WifiPhy::GetHeMcs0 (), WifiPhy::GetHeMcs9 (), WifiPhy::GetHeMcs11 ()};
+  uint64_t nbits[] = {1, 24, 8 * 1500, 8 * 65535};
+  for (uint8_t m = 0; m < 2; m++)
+    {
+      Ptr<CachedErrorRateModel> cached = CreateObject<CachedErrorRateModel> ();
+      cached->SetAttribute ("ErrorRateModel", PointerValue (models[m]));
+      cached->SetAttribute ("Tolerance", DoubleValue (tolerance));
+      for (const WifiMode &mode : modes)
+        {
+          if (m == 1 && (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS
+                         || mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS))
+            {
+              // not supported by YansErrorRateModel
+              continue;
+            }
+          uint16_t width = (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS
+                            || mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS) ? 22 : 20;
+          WifiTxVector txVector (mode, 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, width, false, false);
+          for (double snrDb = -15.0; snrDb < 65.0; snrDb += 0.137)
+            {
+              double snr = std::pow (10.0, snrDb / 10.0);
+              for (uint64_t n : nbits)
+                {
+                  double exact = models[m]->GetChunkSuccessRate (mode, txVector, snr, n);
+                  double interpolated = cached->GetChunkSuccessRate (mode, txVector, snr, n);
+                  NS_TEST_ASSERT_MSG_EQ_TOL (interpolated, exact, tolerance,
+                                             "Wrong chunk success rate for mode " << mode << " at " << snrDb << " dB with " << n << " bits");
+                }
+            }
+        }
+    }
+
+  // a tighter tolerance requires finer tables
+  Ptr<CachedErrorRateModel> loose = CreateObject<CachedErrorRateModel> ();
+  loose->SetAttribute ("ErrorRateModel", PointerValue (models[1]));
+  loose->SetAttribute ("Tolerance", DoubleValue (1e-2));
+  Ptr<CachedErrorRateModel> tight = CreateObject<CachedErrorRateModel> ();
+  tight->SetAttribute ("ErrorRateModel", PointerValue (models[1]));
+  tight->SetAttribute ("Tolerance", DoubleValue (1e-4));
+  WifiTxVector txVector (WifiPhy::GetHeMcs11 (), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 20, false, false);
+  NS_TEST_EXPECT_MSG_LT (loose->GetTableSize (WifiPhy::GetHeMcs11 (), txVector),
+                         tight->GetTableSize (WifiPhy::GetHeMcs11 (), txVector),
+                         "A tighter tolerance should lead to a finer table");
+
+  // changing the SNR range after the first lookups recomputes the tables
+  std::size_t fullSize = loose->GetTableSize (WifiPhy::GetHeMcs11 (), txVector);
+  loose->SetAttribute ("MinSnr", DoubleValue (20.0));
+  loose->SetAttribute ("MaxSnr", DoubleValue (40.0));
+  NS_TEST_EXPECT_MSG_LT (loose->GetTableSize (WifiPhy::GetHeMcs11 (), txVector), fullSize,
+                         "A narrower SNR range should lead to a smaller table");
+  for (double snrDb = 15.0; snrDb < 45.0; snrDb += 0.137)
+    {
+      double snr = std::pow (10.0, snrDb / 10.0);
+      double exact = models[1]->GetChunkSuccessRate (WifiPhy::GetHeMcs11 (), txVector, snr, 8 * 1500);
+      double interpolated = loose->GetChunkSuccessRate (WifiPhy::GetHeMcs11 (), txVector, snr, 8 * 1500);
+      NS_TEST_ASSERT_MSG_EQ_TOL (interpolated, exact, 1e-2,
+                                 "Wrong chunk success rate at " << snrDb << " dB after changing the SNR range");
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -308,6 +409,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseCached, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
@@ -46,6 +46,14 @@
 #include "ns3/mgt-headers.h"
 #include "ns3/ht-configuration.h"
 #include "ns3/wifi-phy-header.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-mac-queue.h"
 
 using namespace ns3;
 
@@ -241,6 +249,79 @@ public:
 };
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that a WifiMacHeader removed from a packet only carries the
+ * fields of the frame, whether or not the packet kept a copy of the header
+ */
+class WifiMacHeaderCopyTest : public TestCase
+{
+public:
+  WifiMacHeaderCopyTest () : TestCase ("WifiMacHeader fields after a packet round trip")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    Mac48Address address ("00:00:00:00:00:01");
+    WifiMacHeader cts;
+    cts.SetType (WIFI_MAC_CTL_CTS);
+    cts.SetAddr1 (address);
+    cts.SetAddr2 (address);
+    cts.SetSequenceNumber (7);
+    NS_TEST_EXPECT_MSG_EQ (cts.IsSelfContained (), false, "Control frames do not serialize all their fields");
+    Ptr<Packet> packet = Create<Packet> ();
+    packet->AddHeader (cts);
+    WifiMacHeader received;
+    packet->RemoveHeader (received);
+    NS_TEST_EXPECT_MSG_EQ (received.GetAddr1 (), address, "Wrong receiver address");
+    NS_TEST_EXPECT_MSG_EQ (received.GetAddr2 (), Mac48Address (), "The transmitter address of a CTS is not sent");
+
+    WifiMacHeader data;
+    data.SetType (WIFI_MAC_DATA);
+    data.SetAddr1 (address);
+    data.SetAddr4 (address);
+    NS_TEST_EXPECT_MSG_EQ (data.IsSelfContained (), false, "The fourth address is not sent");
+    data.SetDsFrom ();
+    data.SetDsTo ();
+    NS_TEST_EXPECT_MSG_EQ (data.IsSelfContained (), true, "A frame between two DSs sends all its fields");
+  }
+};
+
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiMode lookup by name Test
+ */
+class WifiModeSearchTest : public TestCase
+{
+public:
+  WifiModeSearchTest () : TestCase ("WifiMode lookup by name")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    WifiMode modes[] = {WifiPhy::GetDsssRate1Mbps (), WifiPhy::GetErpOfdmRate6Mbps (),
+                        WifiPhy::GetOfdmRate13_5MbpsBW5MHz (), WifiPhy::GetHtMcs31 (),
+                        WifiPhy::GetVhtMcs9 (), WifiPhy::GetHeMcs11 ()};
+    for (const WifiMode &mode : modes)
+      {
+        NS_TEST_EXPECT_MSG_EQ (WifiMode (mode.GetUniqueName ()), mode, "Wrong mode found for " << mode);
+        WifiModeValue value;
+        NS_TEST_EXPECT_MSG_EQ (value.DeserializeFromString (mode.GetUniqueName (), 0), true, "Cannot deserialize " << mode);
+        NS_TEST_EXPECT_MSG_EQ (value.Get (), mode, "Wrong mode deserialized for " << mode);
+      }
+    //creating a mode with an existing name returns the existing mode
+    NS_TEST_EXPECT_MSG_EQ (WifiModeFactory::CreateWifiMcs ("HeMcs7", 7, WIFI_MOD_CLASS_HE), WifiPhy::GetHeMcs7 (),
+                           "A mode with the same name was created");
+    NS_TEST_EXPECT_MSG_EQ (WifiMode ().GetUniqueName (), "Invalid-WifiMode", "Wrong name of the invalid mode");
+  }
+};
+
+
 /**
  * See \bugid{991}
  */
@@ -368,6 +449,318 @@ InterferenceHelperSequenceTest::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the data structures available to store the noise and
+ * interference changes of InterferenceHelper yield exactly the same results.
+ *
+ * The same sequence of overlapping signals is fed to two interference
+ * helpers, one for each data structure.  The first signal arriving while
+ * no signal is being received is received, and the SNR and PER computed
+ * by the two helpers at the end of each reception are compared.
+ */
+class InterferenceHelperStorageTest : public TestCase
+{
+public:
+  InterferenceHelperStorageTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Add a signal to both interference helpers
+   * \param duration the duration of the signal
+   * \param rxPowerW the receive power (W)
+   */
+  void AddSignal (Time duration, double rxPowerW);
+  /**
+   * End the reception of the signal being received
+   */
+  void EndReception (void);
+
+  InterferenceHelper m_interference[2]; ///< interference helpers using the multimap and the sorted vector
+  Ptr<Event> m_rxEvent[2]; ///< events being received by each interference helper
+  WifiTxVector m_txVector; ///< TXVECTOR of the signals
+  uint32_t m_nReceptions; ///< number of receptions
+};
+
+InterferenceHelperStorageTest::InterferenceHelperStorageTest ()
+  : TestCase ("Test the storage of the noise and interference changes of InterferenceHelper"),
+    m_txVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false, false),
+    m_nReceptions (0)
+{
+}
+
+void
+InterferenceHelperStorageTest::AddSignal (Time duration, double rxPowerW)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference[0].GetEnergyDuration (1e-9), m_interference[1].GetEnergyDuration (1e-9),
+                         "Energy durations differ");
+  Ptr<Event> event[2];
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      event[i] = m_interference[i].Add (Create<Packet> (1000), m_txVector, duration, rxPowerW);
+    }
+  if (m_rxEvent[0] == 0)
+    {
+      for (uint8_t i = 0; i < 2; i++)
+        {
+          m_rxEvent[i] = event[i];
+          m_interference[i].NotifyRxStart ();
+        }
+      Simulator::Schedule (duration, &InterferenceHelperStorageTest::EndReception, this);
+    }
+}
+
+void
+InterferenceHelperStorageTest::EndReception (void)
+{
+  InterferenceHelper::SnrPer header[2];
+  InterferenceHelper::SnrPer payload[2];
+  double snr[2];
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      header[i] = m_interference[i].CalculateLegacyPhyHeaderSnrPer (m_rxEvent[i]);
+      payload[i] = m_interference[i].CalculatePayloadSnrPer (m_rxEvent[i], std::make_pair (Seconds (0), m_rxEvent[i]->GetEndTime () - m_rxEvent[i]->GetStartTime ()));
+      snr[i] = m_interference[i].CalculateSnr (m_rxEvent[i]);
+      m_interference[i].NotifyRxEnd ();
+      m_rxEvent[i] = 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ (header[0].snr, header[1].snr, "Header SNRs differ");
+  NS_TEST_EXPECT_MSG_EQ (header[0].per, header[1].per, "Header PERs differ");
+  NS_TEST_EXPECT_MSG_EQ (payload[0].snr, payload[1].snr, "Payload SNRs differ");
+  NS_TEST_EXPECT_MSG_EQ (payload[0].per, payload[1].per, "Payload PERs differ");
+  NS_TEST_EXPECT_MSG_EQ (snr[0], snr[1], "SNRs differ");
+  m_nReceptions++;
+}
+
+void
+InterferenceHelperStorageTest::DoRun (void)
+{
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      m_interference[i].SetNoiseFigure (DbToRatio (7));
+      m_interference[i].SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+    }
+  m_interference[0].SetNiChangesStorage (InterferenceHelper::NI_CHANGES_MULTIMAP);
+  m_interference[1].SetNiChangesStorage (InterferenceHelper::NI_CHANGES_SORTED_VECTOR);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      // on average, about three signals overlap
+      Time start = MicroSeconds (random->GetInteger (0, 100000));
+      Time duration = MicroSeconds (random->GetInteger (100, 1000));
+      double rxPowerW = DbmToW (random->GetValue (-90, -50));
+      Simulator::Schedule (start, &InterferenceHelperStorageTest::AddSignal, this, duration, rxPowerW);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_nReceptions, 50, "Too few receptions to compare the data structures");
+
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the per-receiver and per-TID index of WifiMacQueue is
+ * consistent with the content of the queue.
+ *
+ * Random Data, QoS Data and management frames are inserted at random
+ * positions of the queue and removed in random ways, while some of them
+ * expire.  After each operation, the number of packets and the packets
+ * returned by the queue for every receiver and TID are compared with the
+ * ones found by scanning the whole queue.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Perform a random operation on the queue and check the index
+   */
+  void DoOperation (void);
+  /**
+   * Check that the index is consistent with the content of the queue
+   */
+  void CheckIndex (void);
+  /**
+   * \returns a random position in the queue, including its end
+   */
+  WifiMacQueue::ConstIterator GetRandomPosition (void);
+  /**
+   * Callback invoked when a packet expired
+   * \param item the expired item
+   */
+  void Expired (Ptr<const WifiMacQueueItem> item);
+
+  Ptr<WifiMacQueue> m_queue;                ///< the queue
+  Ptr<UniformRandomVariable> m_random;      ///< random variable
+  std::vector<Mac48Address> m_receivers;    ///< receivers of the frames
+  uint32_t m_nExpired;                      ///< number of expired packets
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Test the per-receiver and per-TID index of WifiMacQueue"),
+    m_nExpired (0)
+{
+}
+
+void
+WifiMacQueueIndexTest::Expired (Ptr<const WifiMacQueueItem> item)
+{
+  m_nExpired++;
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueueIndexTest::GetRandomPosition (void)
+{
+  uint32_t index = m_random->GetInteger (0, m_queue->QueueBase::GetNPackets ());
+  WifiMacQueue::ConstIterator it = m_queue->begin ();
+  std::advance (it, index);
+  return it;
+}
+
+void
+WifiMacQueueIndexTest::DoOperation (void)
+{
+  uint32_t operation = m_random->GetInteger (0, 9);
+  if (operation < 6)
+    {
+      WifiMacHeader hdr;
+      uint32_t type = m_random->GetInteger (0, 5);
+      hdr.SetType (type == 0 ? WIFI_MAC_MGT_ACTION : (type == 1 ? WIFI_MAC_DATA : WIFI_MAC_QOSDATA));
+      hdr.SetAddr1 (m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)]);
+      if (hdr.IsQosData ())
+        {
+          hdr.SetQosTid (m_random->GetInteger (0, 3));
+        }
+      Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (Create<Packet> (100), hdr);
+      if (operation < 3)
+        {
+          m_queue->Enqueue (item);
+        }
+      else if (operation == 3)
+        {
+          m_queue->PushFront (item);
+        }
+      else
+        {
+          m_queue->Insert (GetRandomPosition (), item);
+        }
+    }
+  else if (operation == 6)
+    {
+      m_queue->Dequeue ();
+    }
+  else if (operation == 7)
+    {
+      Mac48Address receiver = m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)];
+      m_queue->DequeueByTidAndAddress (m_random->GetInteger (0, 3), receiver);
+    }
+  else if (m_queue->QueueBase::GetNPackets () > 0)
+    {
+      WifiMacQueue::ConstIterator pos = GetRandomPosition ();
+      if (pos != m_queue->end ())
+        {
+          if (operation == 8)
+            {
+              m_queue->Dequeue (pos);
+            }
+          else
+            {
+              m_queue->Remove (pos, true);
+            }
+        }
+    }
+  CheckIndex ();
+}
+
+void
+WifiMacQueueIndexTest::CheckIndex (void)
+{
+  for (const Mac48Address &receiver : m_receivers)
+    {
+      for (uint8_t tid = 0; tid < 4; tid++)
+        {
+          // iterate over the non-expired packets of the receiver and TID
+          std::vector<Ptr<const WifiMacQueueItem> > peeked;
+          WifiMacQueue::ConstIterator it = m_queue->PeekByTidAndAddress (tid, receiver);
+          while (it != m_queue->end ())
+            {
+              peeked.push_back (*it);
+              it = m_queue->PeekByTidAndAddress (tid, receiver, ++it);
+            }
+          std::vector<Ptr<const WifiMacQueueItem> > expected;
+          for (it = m_queue->begin (); it != m_queue->end (); it++)
+            {
+              if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == receiver
+                  && (*it)->GetHeader ().GetQosTid () == tid
+                  && Simulator::Now () <= (*it)->GetTimeStamp () + m_queue->GetMaxDelay ())
+                {
+                  expected.push_back (*it);
+                }
+            }
+          NS_TEST_ASSERT_MSG_EQ ((peeked == expected), true, "Wrong packets returned for TID " << +tid << " and receiver " << receiver);
+          // expired packets are removed before counting
+          uint32_t nPackets = m_queue->GetNPacketsByTidAndAddress (tid, receiver);
+          NS_TEST_ASSERT_MSG_EQ (nPackets, expected.size (), "Wrong number of packets for TID " << +tid << " and receiver " << receiver);
+        }
+      uint32_t nPackets = 0;
+      for (WifiMacQueue::ConstIterator it = m_queue->begin (); it != m_queue->end (); it++)
+        {
+          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == receiver
+              && Simulator::Now () <= (*it)->GetTimeStamp () + m_queue->GetMaxDelay ())
+            {
+              nPackets++;
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (m_queue->GetNPacketsByAddress (receiver), nPackets, "Wrong number of packets for receiver " << receiver);
+    }
+  // the receivers without queued Data frames are not kept in the index
+  std::set<Mac48Address> receivers;
+  for (WifiMacQueue::ConstIterator it = m_queue->begin (); it != m_queue->end (); it++)
+    {
+      if ((*it)->GetHeader ().IsData ())
+        {
+          receivers.insert ((*it)->GetDestinationAddress ());
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_queue->GetNReceivers (), receivers.size (), "Wrong number of receivers in the index");
+  NS_TEST_ASSERT_MSG_EQ (m_queue->IsEmpty (), (m_queue->QueueBase::GetNPackets () == 0), "Wrong queue emptiness");
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxQueueSize (QueueSize ("100p"));
+  m_queue->SetMaxDelay (MilliSeconds (10));
+  m_queue->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiMacQueueIndexTest::Expired, this));
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  for (uint8_t i = 0; i < 3; i++)
+    {
+      m_receivers.push_back (Mac48Address::Allocate ());
+    }
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Simulator::Schedule (MicroSeconds (50 * i), &WifiMacQueueIndexTest::DoOperation, this);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_nExpired, 0, "No packet expired");
+
+  Simulator::Destroy ();
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that when multiple broadcast packets are queued on the same
@@ -1883,6 +2276,153 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the spatial index of YansWifiChannel only skips the
+ * receivers which cannot receive a transmission, and that it follows
+ * the course changes of the nodes.
+ *
+ * A sender broadcasts a packet while a receiver is 10 m away and another
+ * one is 5 km away, so that only the first receiver gets the packet.
+ * The second receiver is then moved 20 m away from the sender and must
+ * receive the next packet.
+ */
+class YansWifiChannelSpatialIndexTest : public TestCase
+{
+public:
+  YansWifiChannelSpatialIndexTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Create one function
+   * \param pos the position
+   * \param channel the wifi channel
+   * \returns the node
+   */
+  Ptr<Node> CreateOne (Vector pos, Ptr<YansWifiChannel> channel);
+  /**
+   * Send one packet function
+   * \param dev the device
+   */
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  /**
+   * Callback for the PhyRxBegin trace source
+   * \param index the index of the receiver
+   * \param p the packet
+   */
+  void RxBegin (std::size_t index, Ptr<const Packet> p);
+
+  uint32_t m_rxBegin[2]; ///< number of receptions started by each receiver
+};
+
+YansWifiChannelSpatialIndexTest::YansWifiChannelSpatialIndexTest ()
+  : TestCase ("Test the spatial index and the per-channel receiver groups of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelSpatialIndexTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelSpatialIndexTest::RxBegin (std::size_t index, Ptr<const Packet> p)
+{
+  m_rxBegin[index]++;
+}
+
+Ptr<Node>
+YansWifiChannelSpatialIndexTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->SetDevice (dev);
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return node;
+}
+
+void
+YansWifiChannelSpatialIndexTest::DoRun (void)
+{
+  // run the scenario without and with the spatial index
+  for (uint8_t spatialIndex = 0; spatialIndex < 2; spatialIndex++)
+    {
+      m_rxBegin[0] = 0;
+      m_rxBegin[1] = 0;
+
+      Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+      channel->SetAttribute ("SpatialIndex", BooleanValue (spatialIndex == 1));
+      channel->SetAttribute ("SpatialIndexCellSize", DoubleValue (50.0));
+      channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+      channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+      Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+      Ptr<Node> nearRx = CreateOne (Vector (10.0, 0.0, 0.0), channel);
+      Ptr<Node> farRx = CreateOne (Vector (5000.0, 0.0, 0.0), channel);
+      Ptr<WifiPhy> farPhy = DynamicCast<WifiNetDevice> (farRx->GetDevice (0))->GetPhy ();
+
+      DynamicCast<WifiNetDevice> (nearRx->GetDevice (0))->GetPhy ()->TraceConnectWithoutContext ("PhyRxBegin",
+        MakeCallback (&YansWifiChannelSpatialIndexTest::RxBegin, this).Bind (std::size_t (0)));
+      farPhy->TraceConnectWithoutContext ("PhyRxBegin",
+        MakeCallback (&YansWifiChannelSpatialIndexTest::RxBegin, this).Bind (std::size_t (1)));
+
+      Simulator::Schedule (Seconds (1.0), &YansWifiChannelSpatialIndexTest::SendOnePacket, this,
+                           DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+      Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition, farRx->GetObject<MobilityModel> (),
+                           Vector (0.0, 20.0, 0.0));
+      Simulator::Schedule (Seconds (3.0), &YansWifiChannelSpatialIndexTest::SendOnePacket, this,
+                           DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+      // the far receiver switches to another channel and then back
+      Simulator::Schedule (Seconds (4.0), &WifiPhy::SetChannelNumber, farPhy, 40);
+      Simulator::Schedule (Seconds (5.0), &YansWifiChannelSpatialIndexTest::SendOnePacket, this,
+                           DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+      Simulator::Schedule (Seconds (6.0), &WifiPhy::SetChannelNumber, farPhy, 36);
+      Simulator::Schedule (Seconds (7.0), &YansWifiChannelSpatialIndexTest::SendOnePacket, this,
+                           DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+
+      // the far receiver moves away, and raises its Rx gain to still receive
+      Simulator::Schedule (Seconds (8.0), &MobilityModel::SetPosition, farRx->GetObject<MobilityModel> (),
+                           Vector (5000.0, 0.0, 0.0));
+      Simulator::Schedule (Seconds (9.0), &YansWifiChannelSpatialIndexTest::SendOnePacket, this,
+                           DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+      Simulator::Schedule (Seconds (10.0), &WifiPhy::SetRxGain, farPhy, 100.0);
+      Simulator::Schedule (Seconds (11.0), &YansWifiChannelSpatialIndexTest::SendOnePacket, this,
+                           DynamicCast<WifiNetDevice> (sender->GetDevice (0)));
+
+      Simulator::Stop (Seconds (12.0));
+      Simulator::Run ();
+
+      NS_TEST_ASSERT_MSG_EQ (m_rxBegin[0], 6, "The near receiver should have received all the packets");
+      NS_TEST_ASSERT_MSG_EQ (m_rxBegin[1], 3, "The far receiver should have received only the packets sent when close enough on the same channel");
+
+      Simulator::Destroy ();
+    }
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that the ADDBA handshake process is protected.
@@ -2201,6 +2741,11 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
   AddTestCase (new Bug2470TestCase, TestCase::QUICK); //Bug 2470
+  AddTestCase (new YansWifiChannelSpatialIndexTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperStorageTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
+  AddTestCase (new WifiModeSearchTest, TestCase::QUICK);
+  AddTestCase (new WifiMacHeaderCopyTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
@@ -579,7 +579,7 @@ WimaxHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool exp
     }
 
   Ptr<WimaxPhy> phy = device->GetPhy ();
-  PcapHelper pcapHelper;
+  PcapHelper pcapHelper = GetPcapHelper ();
   std::string filename;
   if (explicitFilename)
     {
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the reads of the positions of
+// moving nodes, as done by the channels for every frame: at each step,
+// the position of every node is read twice, either from its
+// MobilityModel or from the MobilityPositionStore.
+// Sample usage:  ./waf --run 'bench-mobility --n=10000 --steps=100'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/mobility-position-store.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// The sum of the coordinates read, which keeps the reads from being optimized out
+static double g_sum = 0;
+
+/**
+ * Read the position of every node twice from its mobility model.
+ * \param models the mobility models of the nodes
+ */
+static void
+ReadModels (const std::vector<Ptr<MobilityModel> > *models)
+{
+  for (uint32_t read = 0; read < 2; read++)
+    {
+      for (std::size_t i = 0; i < models->size (); i++)
+        {
+          Vector p = (*models)[i]->GetPosition ();
+          g_sum += p.x + p.y;
+        }
+    }
+}
+
+/**
+ * Read the position of every node twice from the position store.
+ * \param indexes the indexes of the mobility models of the nodes
+ */
+static void
+ReadStore (const std::vector<uint32_t> *indexes)
+{
+  MobilityPositionStore *store = MobilityPositionStore::Get ();
+  for (uint32_t read = 0; read < 2; read++)
+    {
+      for (std::size_t i = 0; i < indexes->size (); i++)
+        {
+          Vector p = store->GetPosition ((*indexes)[i]);
+          g_sum += p.x + p.y;
+        }
+    }
+}
+
+/**
+ * Benchmark the reads of the positions.
+ * \param useStore whether the positions are read from the position store
+ * \param n the number of nodes
+ * \param steps the number of steps
+ */
+static void
+runBench (bool useStore, uint32_t n, uint32_t steps)
+{
+  std::vector<Ptr<MobilityModel> > models;
+  std::vector<uint32_t> indexes;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = CreateObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (i % 100, i / 100, 0.0));
+      model->SetVelocity (Vector (1.0 + (i % 7), 2.0 - (i % 5), 0.0));
+      models.push_back (model);
+      indexes.push_back (model->GetPositionIndex ());
+    }
+  for (uint32_t step = 0; step < steps; step++)
+    {
+      if (useStore)
+        {
+          Simulator::Schedule (MilliSeconds (step), &ReadStore, &indexes);
+        }
+      else
+        {
+          Simulator::Schedule (MilliSeconds (step), &ReadModels, &models);
+        }
+    }
+  uint64_t updates = MobilityPositionStore::Get ()->GetNUpdates ();
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t delay = time.End ();
+  Simulator::Destroy ();
+  updates = MobilityPositionStore::Get ()->GetNUpdates () - updates;
+
+  double reads = 2.0 * n * steps;
+  std::cout << (useStore ? "MobilityPositionStore: " : "MobilityModel:         ")
+            << reads * 1000 / (delay > 0 ? delay : 1) << " positions/s"
+            << " (" << delay << " ms elapsed, "
+            << updates << " model updates)"
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+  uint32_t steps = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the reads of the positions of moving nodes");
+  cmd.AddValue ("n", "number of moving nodes", n);
+  cmd.AddValue ("steps", "number of instants at which the positions are read", steps);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-mobility with n=" << n << " steps=" << steps << std::endl;
+  runBench (false, n, steps);
+  runBench (true, n, steps);
+  std::cout << "checksum " << g_sum << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the cost of the trace sources
+// fired for every frame, with zero, one and five sinks connected to each
+// source.  The sources mimic those of a Wi-Fi device: PhyTxBegin,
+// PhyRxBegin, MacTx, MonitorSnifferRx and TxopTrace.
+// Sample usage:  ./waf --run 'bench-traced-callback --n=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/traced-callback.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include <iostream>
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/// The trace sources fired for every frame
+struct FrameSources
+{
+  TracedCallback<Ptr<const Packet>, double> phyTxBegin;        //!< PhyTxBegin
+  TracedCallback<Ptr<const Packet> > phyRxBegin;               //!< PhyRxBegin
+  TracedCallback<Ptr<const Packet> > macTx;                    //!< MacTx
+  TracedCallback<Ptr<const Packet>, uint16_t, double> sniffRx; //!< MonitorSnifferRx
+  TracedCallback<Time, Time> txop;                             //!< TxopTrace
+};
+
+/// The number of times a sink was invoked
+static uint64_t g_invocations = 0;
+
+/**
+ * PhyTxBegin sink.
+ * \param packet the packet
+ * \param txPowerW the transmit power
+ */
+static void
+PhyTxBeginSink (Ptr<const Packet> packet, double txPowerW)
+{
+  g_invocations++;
+}
+
+/**
+ * Packet sink.
+ * \param packet the packet
+ */
+static void
+PacketSink (Ptr<const Packet> packet)
+{
+  g_invocations++;
+}
+
+/**
+ * MonitorSnifferRx sink.
+ * \param packet the packet
+ * \param channelFreqMhz the channel frequency
+ * \param signalDbm the signal power
+ */
+static void
+SniffRxSink (Ptr<const Packet> packet, uint16_t channelFreqMhz, double signalDbm)
+{
+  g_invocations++;
+}
+
+/**
+ * TxopTrace sink.
+ * \param start the start of the TXOP
+ * \param duration the duration of the TXOP
+ */
+static void
+TxopSink (Time start, Time duration)
+{
+  g_invocations++;
+}
+
+/**
+ * Fire the trace sources of n frames.
+ * \param sources the trace sources
+ * \param n the number of frames
+ */
+static void
+FireFrames (const FrameSources &sources, uint32_t n)
+{
+  Ptr<const Packet> packet = Create<Packet> (1500);
+  Time start = MicroSeconds (10);
+  Time duration = MicroSeconds (100);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sources.phyTxBegin (packet, 0.1);
+      sources.phyRxBegin (packet);
+      sources.macTx (packet);
+      sources.sniffRx (packet, 5180, -60.0);
+      sources.txop (start, duration);
+    }
+}
+
+/**
+ * Benchmark the trace sources with a given number of sinks.
+ * \param nSinks the number of sinks connected to each source
+ * \param n the number of frames
+ * \param minIterations the number of runs to take the fastest of
+ */
+static void
+runBench (uint32_t nSinks, uint32_t n, uint32_t minIterations)
+{
+  FrameSources sources;
+  for (uint32_t i = 0; i < nSinks; i++)
+    {
+      sources.phyTxBegin.ConnectWithoutContext (MakeCallback (&PhyTxBeginSink));
+      sources.phyRxBegin.ConnectWithoutContext (MakeCallback (&PacketSink));
+      sources.macTx.ConnectWithoutContext (MakeCallback (&PacketSink));
+      sources.sniffRx.ConnectWithoutContext (MakeCallback (&SniffRxSink));
+      sources.txop.ConnectWithoutContext (MakeCallback (&TxopSink));
+    }
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      SystemWallClockMs time;
+      time.Start ();
+      FireFrames (sources, n);
+      uint64_t delay = time.End ();
+      minDelay = std::min (minDelay, delay);
+    }
+  double nsPerFrame = minDelay * 1e6 / n;
+  std::cout << nSinks << " sink(s) per source: "
+            << nsPerFrame << " ns/frame"
+            << " (" << minDelay << " ms elapsed)"
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t minIterations = 3;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the trace sources fired for every frame");
+  cmd.AddValue ("n", "number of frames", n);
+  cmd.AddValue ("min-iterations", "number of runs to minimize the elapsed time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  // stop recording the Time objects, as a running simulation does
+  Simulator::Run ();
+
+  std::cout << "Running bench-traced-callback with n=" << n << std::endl;
+  runBench (0, n, minIterations);
+  runBench (1, n, minIterations);
+  runBench (5, n, minIterations);
+  std::cout << g_invocations << " sink invocations" << std::endl;
+
+  Simulator::Destroy ();
+
+  return 0;
+}
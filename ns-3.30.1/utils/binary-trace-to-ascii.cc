@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts a binary trace file, written through
+// AsciiTraceHelper::CreateBinaryFileStream, to the ascii trace it replaces.
+// It links all the enabled modules, so that the headers of the packets
+// stored in the file can be printed.
+// Sample usage:  ./waf --run 'binary-trace-to-ascii --input=trace.nstr --output=trace.tr'
+
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/binary-trace.h"
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file to an ascii trace file");
+  cmd.AddValue ("input", "the binary trace file", input);
+  cmd.AddValue ("output", "the ascii trace file, or the standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "Error-- an input file is required" << std::endl;
+      return -1;
+    }
+
+  BinaryTraceReader reader;
+  reader.Open (input);
+  if (reader.Fail ())
+    {
+      std::cerr << "Error-- unable to read " << input << std::endl;
+      return -1;
+    }
+
+  std::ofstream file;
+  std::ostream *os = &std::cout;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file.is_open ())
+        {
+          std::cerr << "Error-- unable to open " << output << std::endl;
+          return -1;
+        }
+      os = &file;
+    }
+
+  Packet::EnablePrinting ();
+  while (reader.Next ())
+    {
+      reader.PrintAscii (*os);
+    }
+  if (reader.Fail ())
+    {
+      std::cerr << "Error-- " << input << " holds invalid data" << std::endl;
+      return -1;
+    }
+  return 0;
+}